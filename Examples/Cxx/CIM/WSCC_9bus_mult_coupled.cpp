@@ -12,6 +12,7 @@
 
 #include <DPsim.h>
 #include <dpsim/ThreadLevelScheduler.h>
+#include <dpsim/WorkStealingScheduler.h>
 
 using namespace DPsim;
 using namespace CPS;
@@ -65,7 +66,7 @@ void multiply_connected(SystemTopology& sys, int copies,
 	}
 }
 
-void simulateCoupled(std::list<fs::path> filenames, CommandLineArgs& args, Int copies, Int threads, Int seq = 0) {
+void simulateCoupled(std::list<fs::path> filenames, CommandLineArgs& args, Int copies, Int threads, Int seq = 0, Bool workStealing = false) {
 	String simName = "WSCC_9bus_coupled_" + std::to_string(copies)
 		+ "_" + std::to_string(threads) + "_" + std::to_string(seq);
 	Logger::setLogDir("logs/"+simName);
@@ -78,8 +79,12 @@ void simulateCoupled(std::list<fs::path> filenames, CommandLineArgs& args, Int c
 
 	Simulation sim(simName, args);
 	sim.setSystem(sys);
-	if (threads > 0)
-		sim.setScheduler(std::make_shared<OpenMPLevelScheduler>(threads));
+	if (threads > 0) {
+		if (workStealing)
+			sim.setScheduler(std::make_shared<WorkStealingScheduler>(threads));
+		else
+			sim.setScheduler(std::make_shared<OpenMPLevelScheduler>(threads));
+	}
 
 	// Logging
 	//auto logger = DataLogger::make(simName);
@@ -123,6 +128,7 @@ int main(int argc, char *argv[]) {
 	Int numCopies = 0;
 	Int numThreads = 0;
 	Int numSeq = 0;
+	Bool workStealing = false;
 
 	if (args.options.find("copies") != args.options.end())
 		numCopies = args.getOptionInt("copies");
@@ -130,10 +136,12 @@ int main(int argc, char *argv[]) {
 		numThreads = args.getOptionInt("threads");
 	if (args.options.find("seq") != args.options.end())
 		numSeq = args.getOptionInt("seq");
+	if (args.options.find("workstealing") != args.options.end())
+		workStealing = args.getOptionBool("workstealing");
 
 	std::cout << "Simulate with " << numCopies << " copies, "
 		<< numThreads << " threads, sequence number "
 		<< numSeq << std::endl;
 	
-	simulateCoupled(filenames, args, numCopies,	numThreads, numSeq);
+	simulateCoupled(filenames, args, numCopies,	numThreads, numSeq, workStealing);
 }
@@ -12,6 +12,7 @@
 
 #include <DPsim.h>
 #include <dpsim/ThreadLevelScheduler.h>
+#include <dpsim/WorkStealingScheduler.h>
 
 using namespace DPsim;
 using namespace CPS;
@@ -46,7 +47,7 @@ void multiply_decoupled(SystemTopology& sys, int copies,
 	}
 }
 
-void simulateDecoupled(std::list<fs::path> filenames, Int copies, Int threads, Int seq = 0) {
+void simulateDecoupled(std::list<fs::path> filenames, Int copies, Int threads, Int seq = 0, Bool workStealing = false) {
 	String simName = "WSCC_9bus_decoupled_" + std::to_string(copies)
 		+ "_" + std::to_string(threads) + "_" + std::to_string(seq);
 	Logger::setLogDir("logs/"+simName);
@@ -62,8 +63,12 @@ void simulateDecoupled(std::list<fs::path> filenames, Int copies, Int threads, I
 	sim.setTimeStep(0.0001);
 	sim.setFinalTime(0.5);
 	sim.setDomain(Domain::DP);
-	if (threads > 0)
-		sim.setScheduler(std::make_shared<OpenMPLevelScheduler>(threads));
+	if (threads > 0) {
+		if (workStealing)
+			sim.setScheduler(std::make_shared<WorkStealingScheduler>(threads));
+		else
+			sim.setScheduler(std::make_shared<OpenMPLevelScheduler>(threads));
+	}
 
 	// Logging
 	//auto logger = DataLogger::make(simName);
@@ -107,6 +112,7 @@ int main(int argc, char *argv[]) {
 	Int numCopies = 0;
 	Int numThreads = 0;
 	Int numSeq = 0;
+	Bool workStealing = false;
 
 	if (args.options.find("copies") != args.options.end())
 		numCopies = args.getOptionInt("copies");
@@ -114,9 +120,11 @@ int main(int argc, char *argv[]) {
 		numThreads = args.getOptionInt("threads");
 	if (args.options.find("seq") != args.options.end())
 		numSeq = args.getOptionInt("seq");
+	if (args.options.find("workstealing") != args.options.end())
+		workStealing = args.getOptionBool("workstealing");
 
 	std::cout << "Simulate with " << numCopies << " copies, "
 		<< numThreads << " threads, sequence number "
 		<< numSeq << std::endl;
-	simulateDecoupled(filenames, numCopies,	numThreads, numSeq);
+	simulateDecoupled(filenames, numCopies,	numThreads, numSeq, workStealing);
 }
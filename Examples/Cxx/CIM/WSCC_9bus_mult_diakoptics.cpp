@@ -12,6 +12,7 @@
 
 #include <DPsim.h>
 #include <dpsim/ThreadLevelScheduler.h>
+#include <dpsim/WorkStealingScheduler.h>
 
 using namespace DPsim;
 using namespace CPS;
@@ -60,7 +61,7 @@ IdentifiedObject::List multiply_diakoptics(SystemTopology& sys, Int copies,
 }
 
 void simulateDiakoptics(std::list<fs::path> filenames,
-	Int copies, Int threads, UInt splits = 0, Int seq = 0) {
+	Int copies, Int threads, UInt splits = 0, Int seq = 0, Bool workStealing = false) {
 
 	String simName = "WSCC_9bus_diakoptics_" + std::to_string(copies)
 		+ "_" + std::to_string(threads) + "_" + std::to_string(splits)
@@ -78,8 +79,12 @@ void simulateDiakoptics(std::list<fs::path> filenames,
 	sim.setTimeStep(0.0001);
 	sim.setFinalTime(0.5);
 	sim.setDomain(Domain::DP);
-	if (threads > 0)
-		sim.setScheduler(std::make_shared<OpenMPLevelScheduler>(threads));
+	if (threads > 0) {
+		if (workStealing)
+			sim.setScheduler(std::make_shared<WorkStealingScheduler>(threads));
+		else
+			sim.setScheduler(std::make_shared<OpenMPLevelScheduler>(threads));
+	}
 	if (copies > 0)
 		sim.setTearingComponents(sys.mTearComponents);
 
@@ -124,6 +129,7 @@ int main(int argc, char *argv[]) {
 	Int numCopies = 0;
 	Int numThreads = 0;
 	Int numSeq = 0;
+	Bool workStealing = false;
 	Int numSplits = 0;
 
 	if (args.options.find("copies") != args.options.end())
@@ -132,6 +138,8 @@ int main(int argc, char *argv[]) {
 		numThreads = args.getOptionInt("threads");
 	if (args.options.find("seq") != args.options.end())
 		numSeq = args.getOptionInt("seq");
+	if (args.options.find("workstealing") != args.options.end())
+		workStealing = args.getOptionBool("workstealing");
 	if (args.options.find("splits") != args.options.end())
 		numSplits = args.getOptionInt("splits");
 
@@ -139,5 +147,5 @@ int main(int argc, char *argv[]) {
 		<< numThreads << " threads, "
 		<< numSplits << " splits, sequence number "
 		<< numSeq << std::endl;
-	simulateDiakoptics(filenames, numCopies, numThreads, numSplits, numSeq);
+	simulateDiakoptics(filenames, numCopies, numThreads, numSplits, numSeq, workStealing);
 }
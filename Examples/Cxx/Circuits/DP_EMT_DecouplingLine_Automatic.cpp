@@ -0,0 +1,100 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include "../PiLineGrid.h"
+
+using namespace DPsim;
+using namespace CPS;
+using namespace DPsim::Examples::PiLineGrid;
+
+// Compares the automatic decoupling of a PiLine with a manually configured decoupling
+// line at 50 Hz and 60 Hz. The DP results are also shifted to the time domain and
+// compared with the EMT decoupling line, which checks the phasor rotation of the
+// delayed waves at the system frequency. The delay of the line is a multiple of the
+// time step, so that the delayed values are not interpolated.
+
+Real timeStep = 0.00005;
+Real finalTime = 0.1;
+Real resistance = 5;
+Real inductance = 0.16;
+Real capacitance = 1.0e-6;
+
+enum class Line { Automatic, Manual, EMT };
+
+Matrix simulateLine(Line line, Real frequency) {
+	String simName = String(line == Line::EMT ? "EMT" : "DP") + "_DecouplingLine_"
+		+ (line == Line::Automatic ? "Automatic_" : "") + std::to_string(static_cast<Int>(frequency)) + "Hz";
+	Logger::setLogDir("logs/" + simName);
+
+	Simulation sim(simName, Logger::Level::off);
+	if (line == Line::EMT) {
+		auto n1 = EMT::SimNode::make("n1");
+		auto n2 = EMT::SimNode::make("n2");
+		auto vs = EMT::Ph1::VoltageSource::make("vs");
+		vs->setParameters(Complex(100000, 0), frequency);
+		vs->connect({ EMT::SimNode::GND, n1 });
+		auto dline = Signal::DecouplingLineEMT::make("line", Logger::Level::off);
+		dline->setParameters(n1, n2, resistance, inductance, capacitance);
+		auto load = EMT::Ph1::Resistor::make("load");
+		load->setParameters(10000);
+		load->connect({ n2, EMT::SimNode::GND });
+
+		auto sys = SystemTopology(frequency, SystemNodeList{ n1, n2 }, SystemComponentList{ vs, dline, load });
+		sys.addComponents(dline->getLineComponents());
+		sim.setDomain(Domain::EMT);
+		return simulate<Real>(sim, sys, timeStep, finalTime, simName);
+	}
+
+	auto n1 = DP::SimNode::make("n1");
+	auto n2 = DP::SimNode::make("n2");
+	auto vs = DP::Ph1::VoltageSource::make("vs");
+	vs->setParameters(Complex(100000, 0));
+	vs->connect({ DP::SimNode::GND, n1 });
+	auto load = DP::Ph1::Resistor::make("load");
+	load->setParameters(10000);
+	load->connect({ n2, DP::SimNode::GND });
+
+	auto sys = SystemTopology(frequency, SystemNodeList{ n1, n2 }, SystemComponentList{ vs, load });
+	if (line == Line::Automatic) {
+		// The parallel conductance is neglected by the decoupling line
+		auto piLine = DP::Ph1::PiLine::make("line");
+		piLine->setParameters(resistance, inductance, capacitance, 1e-6);
+		piLine->connect({ n1, n2 });
+		sys.addComponent(piLine);
+		sim.doAutomaticDecoupling();
+	} else {
+		auto dline = Signal::DecouplingLine::make("line", Logger::Level::off);
+		dline->setParameters(n1, n2, resistance, inductance, capacitance);
+		sys.addComponent(dline);
+		sys.addComponents(dline->getLineComponents());
+	}
+	return simulate<Complex>(sim, sys, timeStep, finalTime, simName);
+}
+
+// Instantaneous values of the node voltages, in the layout of the EMT results
+Matrix shiftToTimeDomain(const Matrix& phasors, Real frequency) {
+	Matrix values = Matrix::Zero(phasors.rows(), phasors.cols());
+	for (Int step = 0; step < phasors.cols(); step++) {
+		Complex shift = std::polar(1., 2. * PI * frequency * step * timeStep);
+		for (Int row = 0; row < phasors.rows(); row += 2)
+			values(row, step) = std::real(Complex(phasors(row, step), phasors(row + 1, step)) * shift);
+	}
+	return values;
+}
+
+int main(int argc, char* argv[]) {
+	Bool passed = true;
+	for (Real frequency : { 50., 60. }) {
+		String suffix = " " + std::to_string(static_cast<Int>(frequency)) + " Hz";
+		Matrix manual = simulateLine(Line::Manual, frequency);
+		passed &= compare(simulateLine(Line::Automatic, frequency), manual, "Automatic" + suffix, 1e-12);
+		passed &= compare(shiftToTimeDomain(manual, frequency), simulateLine(Line::EMT, frequency), "EMT" + suffix, 1e-9);
+	}
+	return passed ? 0 : 1;
+}
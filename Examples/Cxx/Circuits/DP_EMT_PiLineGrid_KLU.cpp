@@ -0,0 +1,75 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include "../PiLineGrid.h"
+
+using namespace DPsim;
+using namespace CPS;
+using namespace DPsim::Examples::PiLineGrid;
+
+// Compares the KLU implementation with EigenSparse on a square grid of PiLines
+// with a fault switch at the center node, and reports the step times of both.
+// The grid size can be set with "-o size=<n>" for benchmarking.
+
+Real timeStep = 0.0001;
+Real finalTime = 0.1;
+Real faultStart = 0.03;
+Real faultEnd = 0.06;
+
+template <typename SwitchType>
+Matrix simulateDP(Int size, MnaSolverFactory::MnaSolverImpl impl, Bool recomputation) {
+	String simName = String("DP_PiLineGrid_") + (impl == MnaSolverFactory::KLU ? "KLU" : "EigenSparse")
+		+ (recomputation ? "_Recomp" : "");
+	Logger::setLogDir("logs/" + simName);
+
+	auto sys = gridDP(size);
+	auto fault = addFault<SwitchType>(sys, size * size / 2, timeStep);
+
+	Simulation sim(simName, Logger::Level::off);
+	sim.setDomain(Domain::DP);
+	sim.setMnaSolverImplementation(impl);
+	sim.doSystemMatrixRecomputation(recomputation);
+	sim.addEvent(SwitchEvent::make(faultStart, fault, true));
+	sim.addEvent(SwitchEvent::make(faultEnd, fault, false));
+	return simulate<Complex>(sim, sys, timeStep, finalTime, simName);
+}
+
+Matrix simulateEMT(Int size, MnaSolverFactory::MnaSolverImpl impl) {
+	String simName = String("EMT_PiLineGrid_") + (impl == MnaSolverFactory::KLU ? "KLU" : "EigenSparse");
+	Logger::setLogDir("logs/" + simName);
+
+	auto sys = gridEMT(size);
+	auto fault = addFaultEMT(sys, size * size / 2);
+
+	Simulation sim(simName, Logger::Level::off);
+	sim.setDomain(Domain::EMT);
+	sim.setMnaSolverImplementation(impl);
+	sim.addEvent(SwitchEvent3Ph::make(faultStart, fault, true));
+	sim.addEvent(SwitchEvent3Ph::make(faultEnd, fault, false));
+	return simulate<Real>(sim, sys, timeStep, finalTime, simName);
+}
+
+int main(int argc, char* argv[]) {
+	CommandLineArgs args(argc, argv);
+	Int size = args.options.find("size") != args.options.end() ? args.getOptionInt("size") : 8;
+
+	Bool passed = true;
+
+	// Precomputed switch states
+	passed &= compare(simulateDP<DP::Ph1::Switch>(size, MnaSolverFactory::KLU, false),
+		simulateDP<DP::Ph1::Switch>(size, MnaSolverFactory::EigenSparse, false), "DP switched", 1e-9);
+	passed &= compare(simulateEMT(size, MnaSolverFactory::KLU),
+		simulateEMT(size, MnaSolverFactory::EigenSparse), "EMT switched", 1e-9);
+
+	// Refactorization of the variable system matrix
+	passed &= compare(simulateDP<DP::Ph1::varResSwitch>(size, MnaSolverFactory::KLU, true),
+		simulateDP<DP::Ph1::varResSwitch>(size, MnaSolverFactory::EigenSparse, true), "DP recomputation", 1e-9);
+
+	return passed ? 0 : 1;
+}
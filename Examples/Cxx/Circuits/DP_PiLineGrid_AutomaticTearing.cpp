@@ -0,0 +1,104 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <cmath>
+#include <numeric>
+
+#include <DPsim.h>
+#include <dpsim/NetworkPartitioner.h>
+#include "../PiLineGrid.h"
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+using namespace DPsim::Examples::PiLineGrid;
+
+// Compares the automatic tearing of a square grid of PiLines with the monolithic MNA
+// solver. The partitioner is also run on a copy of the grid to check the subnet sizes.
+// Each recursive bisection may miss its target by the relative imbalance or by the
+// heaviest node, which bounds the deviation of the subnet sizes from their mean.
+// Without the loads, only the source node and the last node are connected to ground,
+// so that the subnets without a grounded node are joined to a neighbouring subnet.
+
+Real timeStep = 0.0001;
+Real finalTime = 0.05;
+Int gridSize = 8;
+// Default imbalance of the partitioner used by the simulation
+Real imbalance = 0.05;
+
+SystemTopology grid(Bool loads) {
+	auto sys = gridDP(gridSize);
+	if (!loads) {
+		String lastLoad = "load_" + nodeName(gridSize * gridSize - 1);
+		auto& comps = sys.mComponents;
+		comps.erase(std::remove_if(comps.begin(), comps.end(), [&lastLoad](const CPS::IdentifiedObject::Ptr& comp) {
+			return comp->name().rfind("load_", 0) == 0 && comp->name() != lastLoad;
+		}), comps.end());
+	}
+	return sys;
+}
+
+Matrix simulateGrid(Bool loads, UInt subnets) {
+	String simName = String("DP_PiLineGrid_AutomaticTearing_") + (loads ? "" : "Unloaded_")
+		+ (subnets > 1 ? std::to_string(subnets) : "MNA");
+	Logger::setLogDir("logs/" + simName);
+
+	auto sys = grid(loads);
+	Simulation sim(simName, Logger::Level::off);
+	sim.setAutomaticTearing(subnets);
+	return simulate<Complex>(sim, sys, timeStep, finalTime, simName);
+}
+
+// Subnet sizes of the same partitioning as in the simulation
+Bool checkSubnets(Bool loads, UInt subnets) {
+	auto sys = grid(loads);
+	NetworkPartitioner partitioner(subnets, imbalance);
+	auto tearComponents = partitioner.selectTearComponents<Complex>(sys);
+	auto sizes = partitioner.subnetSizes();
+
+	Int total = std::accumulate(sizes.begin(), sizes.end(), 0);
+	Real mean = static_cast<Real>(total) / subnets;
+	// The source node is the heaviest one because of the virtual node of the source
+	Int maxNodeWeight = 1 + sys.component<VoltageSource>("vs")->virtualNodesNumber();
+	Int levels = static_cast<Int>(std::ceil(std::log2(subnets)));
+	Real growth = std::pow(1 + imbalance, levels);
+	Real bound = (growth - 1) * mean + levels * maxNodeWeight * growth;
+
+	std::cout << subnets << " subnets" << (loads ? "" : " without loads") << ": "
+		<< tearComponents.size() << " tear components, sizes";
+	for (Int size : sizes)
+		std::cout << " " << size;
+	std::cout << std::endl;
+
+	Bool passed = !tearComponents.empty();
+	if (loads) {
+		passed &= sizes.size() == subnets;
+		for (Int size : sizes)
+			passed &= std::abs(size - mean) <= bound;
+	} else {
+		// At most one subnet for each grounded node
+		passed &= sizes.size() <= 2;
+	}
+	if (!passed)
+		std::cerr << subnets << " subnets" << (loads ? "" : " without loads")
+			<< ": unexpected partitioning" << std::endl;
+	return passed;
+}
+
+int main(int argc, char* argv[]) {
+	Bool passed = true;
+	for (Bool loads : { true, false }) {
+		Matrix reference = simulateGrid(loads, 1);
+		for (UInt subnets : loads ? std::vector<UInt>{ 2, 3, 4 } : std::vector<UInt>{ 4 }) {
+			String name = std::to_string(subnets) + " subnets" + (loads ? "" : " without loads");
+			passed &= checkSubnets(loads, subnets);
+			passed &= compare(simulateGrid(loads, subnets), reference, name, 1e-8);
+		}
+	}
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include "../PiLineGrid.h"
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+using namespace DPsim::Examples::PiLineGrid;
+
+// Compares the flat and the nested diakoptics solver with the monolithic MNA solver
+// on a square grid of PiLines. The lines between blocks of blockSize x blockSize
+// nodes are torn, so that the nested solver builds a tear tree over all blocks.
+// With switching, fault switches in two blocks close and open at different times,
+// so that the switch states of the subnets change separately and return to cached ones.
+
+Real timeStep = 0.0001;
+Real finalTime = 0.1;
+std::vector<Real> faultStart = { 0.03, 0.04 };
+std::vector<Real> faultEnd = { 0.06, 0.07 };
+Int gridSize = 8;
+Int blockSize = 2;
+
+enum class Tearing { None, Flat, Nested };
+
+Matrix simulate(Tearing tearing, Bool switching) {
+	String simName = String("DP_PiLineGrid_Diakoptics_")
+		+ (tearing == Tearing::None ? "MNA" : tearing == Tearing::Flat ? "Flat" : "Nested")
+		+ (switching ? "_Switched" : "");
+	Logger::setLogDir("logs/" + simName);
+
+	// Lines to the next block are torn
+	auto sys = gridDP(gridSize, [tearing](Int row, Int col, Int nextRow, Int nextCol) {
+		return tearing != Tearing::None && (nextRow != row ? nextRow : nextCol) % blockSize == 0;
+	});
+	// Center node and last node, which are in different blocks
+	std::vector<std::shared_ptr<Switch>> faults;
+	for (Int node : { gridSize * gridSize / 2 + gridSize / 2, gridSize * gridSize - 1 })
+		faults.push_back(addFault<Switch>(sys, node, timeStep));
+
+	Simulation sim(simName, Logger::Level::off);
+	sim.setTearingComponents(sys.mTearComponents);
+	sim.doNestedDiakoptics(tearing == Tearing::Nested);
+	if (switching) {
+		for (UInt i = 0; i < faults.size(); i++) {
+			sim.addEvent(SwitchEvent::make(faultStart[i], faults[i], true));
+			sim.addEvent(SwitchEvent::make(faultEnd[i], faults[i], false));
+		}
+	}
+	return Examples::PiLineGrid::simulate<Complex>(sim, sys, timeStep, finalTime, simName);
+}
+
+int main(int argc, char* argv[]) {
+	Bool passed = true;
+	for (Bool switching : { false, true }) {
+		String suffix = switching ? " switched" : "";
+		Matrix reference = simulate(Tearing::None, switching);
+		passed &= compare(simulate(Tearing::Flat, switching), reference, "Flat" + suffix, 1e-8);
+		passed &= compare(simulate(Tearing::Nested, switching), reference, "Nested" + suffix, 1e-8);
+	}
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include "../PiLineGrid.h"
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+using namespace DPsim::Examples::PiLineGrid;
+
+// Compares low-rank updates of the variable system matrix with its refactorization.
+// Three variable resistance faults change their resistance over several steps, with
+// overlapping intervals. Each fault changes two rows and columns of the split system
+// matrix, so that a maximum rank of four forces refactorizations while all three
+// deviate from the factorized matrix. Faults that switch again reuse the cached
+// inverse columns of their nodes.
+
+Real timeStep = 0.0001;
+Real finalTime = 0.1;
+std::vector<Int> faultNodes = { 27, 36, 45 };
+std::vector<Real> faultStart = { 0.02, 0.03, 0.04 };
+std::vector<Real> faultEnd = { 0.05, 0.06, 0.07 };
+
+Matrix simulate(Bool lowRank, UInt maxRank) {
+	String simName = String("DP_PiLineGrid_LowRankUpdate_")
+		+ (lowRank ? "Rank" + std::to_string(maxRank) : "Refactorization");
+	Logger::setLogDir("logs/" + simName);
+
+	auto sys = gridDP(8);
+	Simulation sim(simName, Logger::Level::off);
+	sim.setMnaSolverImplementation(MnaSolverFactory::EigenSparse);
+	sim.doSystemMatrixRecomputation(true);
+	sim.doLowRankSystemMatrixUpdate(lowRank);
+	sim.setLowRankUpdateMaxRank(maxRank);
+	for (UInt i = 0; i < faultNodes.size(); i++) {
+		auto fault = addFault<varResSwitch>(sys, faultNodes[i], timeStep);
+		sim.addEvent(SwitchEvent::make(faultStart[i], fault, true));
+		sim.addEvent(SwitchEvent::make(faultEnd[i], fault, false));
+	}
+	return Examples::PiLineGrid::simulate<Complex>(sim, sys, timeStep, finalTime, simName);
+}
+
+int main(int argc, char* argv[]) {
+	Bool passed = true;
+
+	Matrix reference = simulate(false, 0);
+	passed &= compare(simulate(true, 16), reference, "Low-rank update", 1e-9);
+	passed &= compare(simulate(true, 4), reference, "Low-rank update with rank limit", 1e-9);
+
+	return passed ? 0 : 1;
+}
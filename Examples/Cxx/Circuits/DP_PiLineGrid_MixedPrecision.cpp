@@ -0,0 +1,152 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/ThreadLevelScheduler.h>
+#include "../PiLineGrid.h"
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+using namespace DPsim::Examples::PiLineGrid;
+
+// Compares mixed precision solves of the switch states with double precision solves.
+// Without refinement steps and with a zero residual tolerance, the refinement can not
+// converge, so that every switch state falls back to a double precision factorization.
+// The inverter grid is solved with frequency parallelization, where the solves of all
+// frequencies run concurrently on the threads of the scheduler.
+
+Real timeStep = 0.0001;
+Real finalTime = 0.1;
+Real faultStart = 0.03;
+Real faultEnd = 0.06;
+
+enum class Precision { Double, Mixed, Fallback };
+
+void setPrecision(Simulation& sim, Precision precision) {
+	sim.doMixedPrecisionSolve(precision != Precision::Double);
+	if (precision == Precision::Fallback)
+		sim.setMixedPrecisionRefinement(0, 0);
+}
+
+String precisionName(Precision precision) {
+	return precision == Precision::Double ? "Double" : precision == Precision::Mixed ? "Mixed" : "Fallback";
+}
+
+Matrix simulateGrid(Precision precision) {
+	String simName = "DP_PiLineGrid_MixedPrecision_" + precisionName(precision);
+	Logger::setLogDir("logs/" + simName);
+
+	auto sys = gridDP(8);
+	auto fault = addFault<Switch>(sys, 36, timeStep);
+
+	Simulation sim(simName, Logger::Level::off);
+	sim.setMnaSolverImplementation(MnaSolverFactory::EigenSparse);
+	setPrecision(sim, precision);
+	sim.addEvent(SwitchEvent::make(faultStart, fault, true));
+	sim.addEvent(SwitchEvent::make(faultEnd, fault, false));
+	return simulate<Complex>(sim, sys, timeStep, finalTime, simName);
+}
+
+Matrix simulateInverterGrid(Precision precision) {
+	String simName = "DP_Inverter_Grid_MixedPrecision_" + precisionName(precision);
+	Logger::setLogDir("logs/" + simName);
+	Real timeStep = 0.000001;
+	Real finalTime = 0.001;
+	Logger::Level level = Logger::Level::off;
+
+	Matrix frequencies(9,1);
+	frequencies << 50, 19850, 19950, 20050, 20150, 39750, 39950, 40050, 40250;
+	Int numFreqs = static_cast<Int>(frequencies.rows());
+
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+	auto n3 = SimNode::make("n3");
+	auto n4 = SimNode::make("n4");
+	auto n5 = SimNode::make("n5");
+
+	auto inv = Inverter::make("inv", level);
+	inv->setParameters(
+		std::vector<CPS::Int>{2,2,2,2,4,4,4,4},
+		std::vector<CPS::Int>{-3,-1,1,3,-5,-1,1,5},
+		360, 0.87, 0);
+	auto r1 = Resistor::make("r1", level);
+	r1->setParameters(0.1);
+	auto l1 = Inductor::make("l1", level);
+	l1->setParameters(600e-6);
+	auto r2 = Resistor::make("r2", level);
+	r2->setParameters(0.1+0.001);
+	auto l2 = Inductor::make("l2", level);
+	l2->setParameters(150e-6+0.001/(2.*PI*50.));
+	auto c1 = Capacitor::make("c1", level);
+	c1->setParameters(10e-6);
+	auto rc = Capacitor::make("rc", level);
+	rc->setParameters(1e-6);
+	auto grid = VoltageSource::make("grid", level);
+	grid->setParameters(Complex(0, -311.1270));
+
+	inv->connect({ n1 });
+	r1->connect({ n1, n2 });
+	l1->connect({ n2, n3 });
+	c1->connect({ SimNode::GND, n3 });
+	rc->connect({ SimNode::GND, n3 });
+	r2->connect({ n3, n4 });
+	l2->connect({ n4, n5 });
+	grid->connect({ SimNode::GND, n5 });
+
+	auto sys = SystemTopology(50, frequencies,
+		SystemNodeList{ n1, n2, n3, n4, n5 },
+		SystemComponentList{ inv, r1, l1, r2, l2, c1, rc, grid });
+
+	Simulation sim(simName, level);
+	sim.setSystem(sys);
+	sim.setTimeStep(timeStep);
+	sim.setFinalTime(finalTime);
+	sim.setMnaSolverImplementation(MnaSolverFactory::EigenSparse);
+	sim.doFrequencyParallelization(true);
+	sim.setScheduler(std::make_shared<ThreadLevelScheduler>(3));
+	setPrecision(sim, precision);
+
+	// The node voltages of the harmonics are only updated if they are used
+	auto logger = DataLogger::make(simName);
+	for (auto node : { n1, n2, n3, n4, n5 })
+		logger->logAttribute(node->name(), node->attribute("v"), 1, numFreqs);
+	sim.addLogger(logger);
+	sim.start();
+
+	// Voltages of all frequencies, split into real and imaginary part
+	Int steps = static_cast<Int>(std::round(finalTime / timeStep));
+	Int numNodes = static_cast<Int>(sys.mNodes.size());
+	Matrix voltages = Matrix::Zero(2 * numNodes * numFreqs, steps);
+	for (Int step = 0; step < steps && sim.time() < finalTime; step++) {
+		sim.next();
+		for (Int node = 0; node < numNodes; node++) {
+			MatrixComp v = std::dynamic_pointer_cast<SimNode>(sys.mNodes[node])->voltage();
+			for (Int freq = 0; freq < numFreqs; freq++) {
+				voltages(2 * (node * numFreqs + freq), step) = v(0, freq).real();
+				voltages(2 * (node * numFreqs + freq) + 1, step) = v(0, freq).imag();
+			}
+		}
+	}
+	sim.stop();
+	return voltages;
+}
+
+int main(int argc, char* argv[]) {
+	Bool passed = true;
+
+	Matrix reference = simulateGrid(Precision::Double);
+	passed &= compare(simulateGrid(Precision::Mixed), reference, "Mixed", 1e-8);
+	passed &= compare(simulateGrid(Precision::Fallback), reference, "Fallback", 1e-12);
+
+	Matrix inverterReference = simulateInverterGrid(Precision::Double);
+	passed &= compare(simulateInverterGrid(Precision::Mixed), inverterReference, "Inverter mixed", 1e-8);
+	passed &= compare(simulateInverterGrid(Precision::Fallback), inverterReference, "Inverter fallback", 1e-12);
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include "../PiLineGrid.h"
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+using namespace DPsim::Examples::PiLineGrid;
+
+// Compares scenarios solved together with one simulation with independent simulations
+// of each scenario. The scenarios differ in the source voltage and in the time at which
+// the fault switch closes, so that they are in different switch states for some steps.
+
+Real timeStep = 0.0001;
+Real finalTime = 0.1;
+Real faultEnd = 0.07;
+Int numScenarios = 4;
+
+SystemTopology scenario(Int idx, Simulation& sim) {
+	auto sys = gridDP(8);
+	sys.component<VoltageSource>("vs")->setParameters(Complex(100000 * (1 + 0.1 * idx), 0));
+
+	auto fault = addFault<Switch>(sys, 36, timeStep);
+	sim.addEvent(SwitchEvent::make(0.02 + 0.01 * idx, fault, true));
+	sim.addEvent(SwitchEvent::make(faultEnd, fault, false));
+	return sys;
+}
+
+int main(int argc, char* argv[]) {
+	String simName = "DP_PiLineGrid_Scenarios";
+	Logger::setLogDir("logs/" + simName);
+	Simulation sim(simName, Logger::Level::off);
+	sim.setMnaSolverImplementation(MnaSolverFactory::EigenSparse);
+	std::vector<SystemTopology> systems;
+	for (Int idx = 0; idx < numScenarios; idx++)
+		systems.push_back(scenario(idx, sim));
+	auto results = simulate<Complex>(sim, systems, timeStep, finalTime, simName);
+
+	Bool passed = true;
+	for (Int idx = 0; idx < numScenarios; idx++) {
+		String name = simName + "_" + std::to_string(idx);
+		Logger::setLogDir("logs/" + name);
+		Simulation single(name, Logger::Level::off);
+		single.setMnaSolverImplementation(MnaSolverFactory::EigenSparse);
+		auto reference = simulate<Complex>(single, scenario(idx, single), timeStep, finalTime, name);
+		passed &= compare(results[idx], reference, "Scenario " + std::to_string(idx), 1e-12);
+	}
+	return passed ? 0 : 1;
+}
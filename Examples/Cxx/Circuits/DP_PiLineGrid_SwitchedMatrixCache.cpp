@@ -0,0 +1,72 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include "../PiLineGrid.h"
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+using namespace DPsim::Examples::PiLineGrid;
+
+// Compares the switch state cache with the precomputed switch states. Three fault
+// switches step through a sequence of states that returns to earlier ones. With a
+// budget of a single byte, the cache evicts all states but the current one, so that
+// every state change refactorizes the system matrix. The evictions are also run with
+// complex system matrices and with mixed precision factorizations.
+
+Real timeStep = 0.0001;
+Real finalTime = 0.1;
+std::vector<Int> faultNodes = { 9, 36, 54 };
+std::vector<std::vector<Real>> faultTimes = {
+	{ 0.01, 0.03, 0.05, 0.07 },
+	{ 0.02, 0.06 },
+	{ 0.04, 0.08 }
+};
+
+struct CacheConfig {
+	String name;
+	Bool caching;
+	std::size_t budget;
+	Bool complex;
+	Bool mixedPrecision;
+};
+
+Matrix simulateGrid(const CacheConfig& config) {
+	String simName = "DP_PiLineGrid_SwitchedMatrixCache_" + config.name;
+	Logger::setLogDir("logs/" + simName);
+
+	auto sys = gridDP(8);
+	Simulation sim(simName, Logger::Level::off);
+	sim.setMnaSolverImplementation(MnaSolverFactory::EigenSparse);
+	sim.doSwitchedMatrixCaching(config.caching);
+	sim.setSwitchedMatrixCacheBudget(config.budget);
+	sim.doComplexSystemMatrix(config.complex);
+	sim.doMixedPrecisionSolve(config.mixedPrecision);
+	for (UInt i = 0; i < faultNodes.size(); i++) {
+		auto fault = addFault<Switch>(sys, faultNodes[i], timeStep);
+		for (UInt j = 0; j < faultTimes[i].size(); j++)
+			sim.addEvent(SwitchEvent::make(faultTimes[i][j], fault, j % 2 == 0));
+	}
+	return simulate<Complex>(sim, sys, timeStep, finalTime, simName);
+}
+
+int main(int argc, char* argv[]) {
+	Matrix reference = simulateGrid({ "Precomputed", false, 0, false, false });
+
+	std::vector<CacheConfig> configs = {
+		{ "Unlimited", true, 0, false, false },
+		{ "Evicting", true, 1, false, false },
+		{ "EvictingComplex", true, 1, true, false },
+		{ "EvictingMixedPrecision", true, 1, false, true }
+	};
+	Bool passed = true;
+	for (auto& config : configs)
+		passed &= compare(simulateGrid(config), reference, config.name, config.mixedPrecision ? 1e-8 : 1e-9);
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include "../PiLineGrid.h"
+
+using namespace DPsim;
+using namespace CPS;
+using namespace DPsim::Examples::PiLineGrid;
+
+// Compares the complex system matrix with the solve of the split real system matrix
+// in the DP and SP domain. The loads stamp their complex entries natively, the lines,
+// the voltage source and the fault switch are converted from their split stamps.
+// The switch states are either precomputed or cached on demand.
+
+Real timeStep = 0.0001;
+Real finalTime = 0.1;
+Real faultStart = 0.03;
+Real faultEnd = 0.06;
+
+template <typename SwitchType>
+Matrix simulateGrid(Domain domain, Bool complex, Bool caching) {
+	String simName = String(domain == Domain::DP ? "DP" : "SP") + "_PiLineGrid_"
+		+ (complex ? "Complex" : "Split") + (caching ? "_Cached" : "");
+	Logger::setLogDir("logs/" + simName);
+
+	auto sys = domain == Domain::DP ? gridDP(8) : gridSP(8);
+	auto fault = addFault<SwitchType>(sys, 36, timeStep);
+
+	Simulation sim(simName, Logger::Level::off);
+	sim.setDomain(domain);
+	sim.setMnaSolverImplementation(MnaSolverFactory::EigenSparse);
+	sim.doComplexSystemMatrix(complex);
+	sim.doSwitchedMatrixCaching(caching);
+	sim.addEvent(SwitchEvent::make(faultStart, fault, true));
+	sim.addEvent(SwitchEvent::make(faultEnd, fault, false));
+	return simulate<Complex>(sim, sys, timeStep, finalTime, simName);
+}
+
+int main(int argc, char* argv[]) {
+	Bool passed = true;
+	for (Bool caching : { false, true }) {
+		String suffix = caching ? " cached" : "";
+		passed &= compare(simulateGrid<DP::Ph1::Switch>(Domain::DP, true, caching),
+			simulateGrid<DP::Ph1::Switch>(Domain::DP, false, caching), "DP complex" + suffix, 1e-9);
+		passed &= compare(simulateGrid<SP::Ph1::Switch>(Domain::SP, true, caching),
+			simulateGrid<SP::Ph1::Switch>(Domain::SP, false, caching), "SP complex" + suffix, 1e-9);
+	}
+	return passed ? 0 : 1;
+}
@@ -8,12 +8,13 @@
 
 #include <DPsim.h>
 #include <dpsim/ThreadLevelScheduler.h>
+#include <dpsim/ThreadListScheduler.h>
 
 using namespace DPsim;
 using namespace CPS::DP;
 using namespace CPS::DP::Ph3;
 
-void doSim(int threads, int generators, int repNumber) {
+void doSim(int threads, int generators, int repNumber, String scheduler, String inMeasurementFile, String statistic) {
 	// Define simulation parameters
 	Real timeStep = 0.00005;
 	Real finalTime = 0.3;
@@ -113,8 +114,18 @@ void doSim(int threads, int generators, int repNumber) {
 	sim.setDomain(Domain::DP);
 	if (threads > 0) {
 		// Scheduler
-		auto sched = std::make_shared<ThreadLevelScheduler>(threads);
-		sim.setScheduler(sched);
+		if (scheduler == "list" || scheduler == "heft") {
+			auto sched = std::make_shared<ThreadListScheduler>(threads, "", inMeasurementFile);
+			ThreadListScheduler::CommunicationModel model;
+			model.enabled = scheduler == "heft";
+			sched->setCommunicationModel(model);
+			sched->setPlanningStatistic(TaskTimeStatistics::parseStatistic(statistic));
+			sim.setScheduler(sched);
+		} else {
+			auto sched = std::make_shared<ThreadLevelScheduler>(threads, "", inMeasurementFile);
+			sched->setPlanningStatistic(TaskTimeStatistics::parseStatistic(statistic));
+			sim.setScheduler(sched);
+		}
 	}
 
 	sim.run();
@@ -127,5 +138,18 @@ int main(int argc, char* argv[]) {
 	std::cout << "Simulate with " << args.getOptionInt("gen") << " generators, "
 		<< args.getOptionInt("threads") << " threads, sequence number "
 		<< args.getOptionInt("seq") << std::endl;
-	doSim(args.getOptionInt("threads"), args.getOptionInt("gen"), args.getOptionInt("seq"));
+	String scheduler = "level";
+	if (args.options.find("scheduler") != args.options.end())
+		scheduler = args.getOptionString("scheduler");
+	// Measured task times for the scheduling and the statistic that is planned for,
+	// e.g. "-o measurements=times.txt -o statistic=p99"
+	String inMeasurementFile;
+	if (args.options.find("measurements") != args.options.end())
+		inMeasurementFile = args.getOptionString("measurements");
+	String statistic = "mean";
+	if (args.options.find("statistic") != args.options.end())
+		statistic = args.getOptionString("statistic");
+
+	doSim(args.getOptionInt("threads"), args.getOptionInt("gen"), args.getOptionInt("seq"), scheduler,
+		inMeasurementFile, statistic);
 }
@@ -0,0 +1,210 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+#include <DPsim.h>
+
+// Square grid of PiLines with a resistive load at each node, fed by a voltage source
+// at node 0. Each node is connected to its right and its lower neighbour. Used by the
+// examples that compare solver implementations and options with each other.
+
+namespace DPsim {
+namespace Examples {
+namespace PiLineGrid {
+
+	/// Decides if the line from one node to its right or lower neighbour is torn,
+	/// i.e. added as tear component instead of a regular component
+	typedef std::function<Bool(Int row, Int col, Int nextRow, Int nextCol)> TearPredicate;
+
+	inline String nodeName(Int idx) {
+		return "n" + std::to_string(idx);
+	}
+
+	/// Single-phase grid built from the components of a domain
+	template <typename VoltageSource, typename Resistor, typename PiLine>
+	SystemTopology gridPh1(Int size, const TearPredicate& tear) {
+		using SimNode = CPS::SimNode<Complex>;
+
+		SystemTopology sys(50);
+		for (Int i = 0; i < size * size; i++)
+			sys.addNode(SimNode::make(nodeName(i)));
+
+		auto vs = VoltageSource::make("vs");
+		vs->setParameters(Complex(100000, 0));
+		vs->connect({ SimNode::GND, sys.node<SimNode>(nodeName(0)) });
+		sys.addComponent(vs);
+
+		for (Int row = 0; row < size; row++) {
+			for (Int col = 0; col < size; col++) {
+				auto node = sys.node<SimNode>(nodeName(row * size + col));
+				auto load = Resistor::make("load_" + node->name());
+				load->setParameters(5000);
+				load->connect({ node, SimNode::GND });
+				sys.addComponent(load);
+
+				for (Int dir = 0; dir < 2; dir++) {
+					Int nextRow = row + dir, nextCol = col + 1 - dir;
+					if (nextRow >= size || nextCol >= size)
+						continue;
+					Int next = nextRow * size + nextCol;
+					auto line = PiLine::make("line_" + node->name() + "_" + std::to_string(next));
+					line->setParameters(1, 0.01, 1e-6, 1e-6);
+					line->connect({ node, sys.node<SimNode>(nodeName(next)) });
+					if (tear && tear(row, col, nextRow, nextCol))
+						sys.addTearComponent(line);
+					else
+						sys.addComponent(line);
+				}
+			}
+		}
+		return sys;
+	}
+
+	inline SystemTopology gridDP(Int size, const TearPredicate& tear = nullptr) {
+		using namespace CPS::DP::Ph1;
+		return gridPh1<VoltageSource, Resistor, PiLine>(size, tear);
+	}
+
+	inline SystemTopology gridSP(Int size, const TearPredicate& tear = nullptr) {
+		using namespace CPS::SP::Ph1;
+		return gridPh1<VoltageSource, Resistor, PiLine>(size, tear);
+	}
+
+	inline SystemTopology gridEMT(Int size) {
+		using namespace CPS::EMT;
+		using CPS::Math;
+
+		SystemTopology sys(50);
+		for (Int i = 0; i < size * size; i++)
+			sys.addNode(SimNode::make(nodeName(i), PhaseType::ABC));
+
+		auto vs = Ph3::VoltageSource::make("vs");
+		vs->setParameters(Math::singlePhaseVariableToThreePhase(Complex(100000, 0)), 50);
+		vs->connect({ SimNode::GND, sys.node<SimNode>(nodeName(0)) });
+		sys.addComponent(vs);
+
+		for (Int row = 0; row < size; row++) {
+			for (Int col = 0; col < size; col++) {
+				auto node = sys.node<SimNode>(nodeName(row * size + col));
+				auto load = Ph3::Resistor::make("load_" + node->name());
+				load->setParameters(Math::singlePhaseParameterToThreePhase(5000));
+				load->connect({ node, SimNode::GND });
+				sys.addComponent(load);
+
+				for (Int dir = 0; dir < 2; dir++) {
+					Int nextRow = row + dir, nextCol = col + 1 - dir;
+					if (nextRow >= size || nextCol >= size)
+						continue;
+					Int next = nextRow * size + nextCol;
+					auto line = Ph3::PiLine::make("line_" + node->name() + "_" + std::to_string(next));
+					line->setParameters(Math::singlePhaseParameterToThreePhase(1),
+						Math::singlePhaseParameterToThreePhase(0.01),
+						Math::singlePhaseParameterToThreePhase(1e-6));
+					line->connect({ node, sys.node<SimNode>(nodeName(next)) });
+					sys.addComponent(line);
+				}
+			}
+		}
+		return sys;
+	}
+
+	/// Adds an open single-phase fault switch from a node to ground
+	template <typename SwitchType>
+	std::shared_ptr<SwitchType> addFault(SystemTopology& sys, Int node, Real timeStep) {
+		auto fault = SwitchType::make("fault_" + nodeName(node));
+		fault->setParameters(1e9, 1);
+		if constexpr (std::is_same<SwitchType, CPS::DP::Ph1::varResSwitch>::value)
+			fault->setInitParameters(timeStep);
+		fault->open();
+		fault->connect({ sys.node<CPS::SimNode<Complex>>(nodeName(node)), CPS::SimNode<Complex>::GND });
+		sys.addComponent(fault);
+		return fault;
+	}
+
+	/// Adds an open three-phase fault switch from a node to ground
+	inline std::shared_ptr<CPS::EMT::Ph3::Switch> addFaultEMT(SystemTopology& sys, Int node) {
+		auto fault = CPS::EMT::Ph3::Switch::make("fault_" + nodeName(node));
+		fault->setParameters(CPS::Math::singlePhaseParameterToThreePhase(1e9),
+			CPS::Math::singlePhaseParameterToThreePhase(1));
+		fault->openSwitch();
+		fault->connect({ sys.node<CPS::EMT::SimNode>(nodeName(node)), CPS::EMT::SimNode::GND });
+		sys.addComponent(fault);
+		return fault;
+	}
+
+	/// Node voltages of one step, split into real and imaginary part
+	template <typename VarType>
+	void recordVoltages(const SystemTopology& sys, Matrix& voltages, Int step) {
+		Int numNodes = static_cast<Int>(sys.mNodes.size());
+		for (Int node = 0; node < numNodes; node++) {
+			auto v = std::dynamic_pointer_cast<CPS::SimNode<VarType>>(sys.mNodes[node])->voltage();
+			Int numPhases = v.rows();
+			for (Int phase = 0; phase < numPhases; phase++) {
+				voltages(2 * (node * numPhases + phase), step) = std::real(v(phase, 0));
+				voltages(2 * (node * numPhases + phase) + 1, step) = std::imag(v(phase, 0));
+			}
+		}
+	}
+
+	/// Runs the configured simulation step by step with the first system and the others
+	/// as its scenarios, and returns the node voltages of all steps for each system.
+	/// Reports the step time.
+	template <typename VarType>
+	std::vector<Matrix> simulate(Simulation& sim, const std::vector<SystemTopology>& systems,
+		Real timeStep, Real finalTime, const String& name) {
+		sim.setSystem(systems[0]);
+		for (size_t i = 1; i < systems.size(); i++)
+			sim.addScenario(systems[i]);
+		sim.setTimeStep(timeStep);
+		sim.setFinalTime(finalTime);
+		sim.start();
+
+		Int steps = static_cast<Int>(std::round(finalTime / timeStep));
+		Int numPhases = std::dynamic_pointer_cast<CPS::SimNode<VarType>>(systems[0].mNodes[0])->voltage().rows();
+		std::vector<Matrix> voltages;
+		for (auto& sys : systems)
+			voltages.push_back(Matrix::Zero(2 * sys.mNodes.size() * numPhases, steps));
+
+		auto start = std::chrono::steady_clock::now();
+		for (Int step = 0; step < steps && sim.time() < finalTime; step++) {
+			sim.next();
+			for (size_t i = 0; i < systems.size(); i++)
+				recordVoltages<VarType>(systems[i], voltages[i], step);
+		}
+		auto end = std::chrono::steady_clock::now();
+		sim.stop();
+
+		std::cout << name << ": " << std::chrono::duration<Real, std::micro>(end - start).count() / steps
+			<< " us per step" << std::endl;
+		return voltages;
+	}
+
+	/// Runs the configured simulation step by step and returns the node voltages
+	/// of all steps, split into real and imaginary part. Reports the step time.
+	template <typename VarType>
+	Matrix simulate(Simulation& sim, const SystemTopology& sys, Real timeStep, Real finalTime, const String& name) {
+		return simulate<VarType>(sim, std::vector<SystemTopology>{ sys }, timeStep, finalTime, name)[0];
+	}
+
+	/// Relative deviation of two results, fails if it is above the tolerance
+	inline Bool compare(const Matrix& result, const Matrix& reference, const String& name, Real tolerance) {
+		Real deviation = (result - reference).lpNorm<Eigen::Infinity>() / reference.lpNorm<Eigen::Infinity>();
+		std::cout << name << ": relative deviation " << deviation << std::endl;
+		if (!(deviation <= tolerance)) {
+			std::cerr << name << ": result deviates from the reference" << std::endl;
+			return false;
+		}
+		return true;
+	}
+}
+}
+}
@@ -0,0 +1,114 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <random>
+#include <thread>
+
+#include <DPsim.h>
+
+// Random task graphs whose tasks check that they run exactly once per step, after
+// all of their predecessors. Used by the examples that test the schedulers.
+
+namespace DPsim {
+namespace Examples {
+namespace RandomTaskGraph {
+
+	class RandomTask : public CPS::Task {
+	public:
+		typedef std::shared_ptr<RandomTask> Ptr;
+
+		RandomTask(Int idx, UInt work, std::atomic<Bool>& failed) :
+			Task("task_" + std::to_string(idx)), mWork(work), mFailed(failed) {
+			// Keeps the task in the schedule, the dependencies are given as edges
+			mModifiedAttributes.push_back(Scheduler::external);
+		}
+
+		void execute(Real time, Int timeStepCount) {
+			if (mRuns.load(std::memory_order_acquire) != timeStepCount)
+				mFailed = true;
+			for (auto& pred : mPredecessors) {
+				if (pred->mRuns.load(std::memory_order_acquire) != timeStepCount + 1)
+					mFailed = true;
+			}
+
+			// Varying costs, so that the threads are loaded differently
+			volatile UInt sum = 0;
+			for (UInt i = 0; i < mWork; i++)
+				sum = sum + i;
+
+			if (timeStepCount == 0)
+				mFirstThread = std::this_thread::get_id();
+			mLastThread = std::this_thread::get_id();
+			mRuns.fetch_add(1, std::memory_order_release);
+		}
+
+		Int runs() const { return mRuns.load(); }
+		/// The task was executed by another thread in the last step than in the first
+		Bool moved() const { return mFirstThread != mLastThread; }
+
+		std::vector<Ptr> mPredecessors;
+
+	private:
+		UInt mWork;
+		std::atomic<Bool>& mFailed;
+		std::atomic<Int> mRuns { 0 };
+		std::thread::id mFirstThread;
+		std::thread::id mLastThread;
+	};
+
+	/// Tasks with edges from earlier to later tasks with the given probability
+	/// and the costs drawn by the work function
+	struct Graph {
+		std::vector<RandomTask::Ptr> randomTasks;
+		CPS::Task::List tasks;
+		Scheduler::Edges inEdges, outEdges;
+	};
+
+	inline Graph create(std::mt19937& rng, Int numTasks, Real edgeProbability,
+		const std::function<UInt(std::mt19937&)>& work, std::atomic<Bool>& failed) {
+		std::uniform_real_distribution<Real> edge(0, 1);
+
+		Graph graph;
+		for (Int i = 0; i < numTasks; i++) {
+			auto task = std::make_shared<RandomTask>(i, work(rng), failed);
+			for (Int j = 0; j < i; j++) {
+				if (edge(rng) < edgeProbability) {
+					task->mPredecessors.push_back(graph.randomTasks[j]);
+					graph.inEdges[task].push_back(graph.randomTasks[j]);
+					graph.outEdges[graph.randomTasks[j]].push_back(task);
+				}
+			}
+			graph.randomTasks.push_back(task);
+			graph.tasks.push_back(task);
+		}
+		// Insertion order is a topological order, shuffle it to test the sorting
+		std::shuffle(graph.tasks.begin(), graph.tasks.end(), rng);
+		return graph;
+	}
+
+	/// Runs the steps with the scheduler and checks the run counts of all tasks
+	inline void run(Scheduler& scheduler, Graph& graph, Int numSteps, std::atomic<Bool>& failed) {
+		scheduler.resolveDeps(graph.tasks, graph.inEdges, graph.outEdges);
+		scheduler.createSchedule(graph.tasks, graph.inEdges, graph.outEdges);
+		for (Int step = 0; step < numSteps; step++)
+			scheduler.step(step * 0.001, step);
+		scheduler.stop();
+
+		for (auto& task : graph.randomTasks) {
+			if (task->runs() != numSteps)
+				failed = true;
+		}
+	}
+}
+}
+}
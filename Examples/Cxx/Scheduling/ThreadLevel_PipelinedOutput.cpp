@@ -0,0 +1,91 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <fstream>
+
+#include <DPsim.h>
+#include <dpsim/ThreadLevelScheduler.h>
+#include "../PiLineGrid.h"
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+using namespace DPsim::Examples::PiLineGrid;
+
+// Compares the files written by pipelined and regular logging of the same attributes
+// with a multi-threaded scheduler. With pipelined output, the values of each step are
+// written in the next step and the values of the last step are only written when the
+// logger is closed. Besides the node voltages, the state of a fault switch is logged,
+// which is not a real attribute and therefore copied as string.
+
+Real timeStep = 0.0001;
+Real finalTime = 0.05;
+Int gridSize = 4;
+
+std::vector<String> simulateGrid(Bool pipelined, Int threads, UInt downsampling) {
+	String simName = String("ThreadLevel_PipelinedOutput_") + (pipelined ? "Pipelined_" : "")
+		+ std::to_string(threads) + "_" + std::to_string(downsampling);
+	Logger::setLogDir("logs/" + simName);
+
+	auto sys = gridDP(gridSize);
+	auto fault = addFault<Switch>(sys, gridSize * gridSize / 2, timeStep);
+
+	auto logger = DataLogger::make(simName, true, downsampling);
+	for (Int node = 0; node < gridSize * gridSize; node++)
+		logger->logAttribute(nodeName(node), sys.node<SimNode>(nodeName(node))->attribute("v"));
+	logger->logAttribute("i_vs", sys.component<VoltageSource>("vs")->attribute("i_intf"));
+	logger->logAttribute("fault", fault->attribute("is_closed"));
+
+	Simulation sim(simName, Logger::Level::off);
+	sim.setSystem(sys);
+	sim.setTimeStep(timeStep);
+	sim.setFinalTime(finalTime);
+	sim.setScheduler(std::make_shared<ThreadLevelScheduler>(threads));
+	sim.doPipelinedOutput(pipelined);
+	sim.addLogger(logger);
+	sim.addEvent(SwitchEvent::make(0.02, fault, true));
+	sim.addEvent(SwitchEvent::make(0.04, fault, false));
+	sim.run();
+
+	std::ifstream file("logs/" + simName + "/" + simName + ".csv");
+	std::vector<String> lines;
+	for (String line; std::getline(file, line);)
+		lines.push_back(line);
+	return lines;
+}
+
+Bool compareFiles(Int threads, UInt downsampling) {
+	auto reference = simulateGrid(false, threads, downsampling);
+	auto pipelined = simulateGrid(true, threads, downsampling);
+
+	// Header and one row for each logged step, including the last one
+	Int steps = static_cast<Int>(std::round(finalTime / timeStep));
+	size_t rows = 1 + (steps + downsampling - 1) / downsampling;
+
+	Bool passed = reference.size() == rows && pipelined == reference;
+	std::cout << threads << " threads, downsampling " << downsampling << ": " << pipelined.size()
+		<< " of " << rows << " lines" << (passed ? "" : ", FAILED") << std::endl;
+	if (!passed) {
+		for (size_t i = 0; i < std::min(reference.size(), pipelined.size()); i++) {
+			if (pipelined[i] != reference[i]) {
+				std::cerr << "First deviating line " << i << ":\n" << reference[i] << "\n" << pipelined[i] << std::endl;
+				break;
+			}
+		}
+	}
+	return passed;
+}
+
+int main(int argc, char* argv[]) {
+	Bool passed = true;
+	for (Int threads : { 2, 3 }) {
+		for (UInt downsampling : { 1, 3 })
+			passed &= compareFiles(threads, downsampling);
+	}
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/ThreadListScheduler.h>
+#include "../RandomTaskGraph.h"
+
+using namespace DPsim;
+using namespace CPS;
+using namespace DPsim::Examples::RandomTaskGraph;
+
+// Runs the list scheduler with adaptive scheduling on random task graphs and checks
+// that each task runs exactly once per step, after all of its predecessors, while the
+// schedule is rebuilt during the run. The schedule is created with constant costs,
+// but a few tasks are much more expensive than the others, so that the measured
+// costs move tasks to other threads. Without continuous checks, the costs are only
+// measured in the first interval and the threads stop synchronizing afterwards.
+
+Int numTasks = 100;
+Real edgeProbability = 0.05;
+Int numSteps = 300;
+
+Bool runGraph(UInt seed, Int threads, Bool continuous) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<Real> expensive(0, 1);
+
+	std::atomic<Bool> failed { false };
+	auto graph = create(rng, numTasks, edgeProbability,
+		[&expensive](std::mt19937& rng) -> UInt { return expensive(rng) < 0.1 ? 20000 : 100; }, failed);
+
+	ThreadListScheduler scheduler(threads);
+	ThreadScheduler::AdaptiveConfig adaptive;
+	adaptive.enabled = true;
+	adaptive.interval = 20;
+	adaptive.continuous = continuous;
+	adaptive.threshold = 0;
+	scheduler.setAdaptiveScheduling(adaptive);
+	run(scheduler, graph, numSteps, failed);
+
+	// Without a moved task, the schedule was never rebuilt
+	Int moved = std::count_if(graph.randomTasks.begin(), graph.randomTasks.end(),
+		[](const RandomTask::Ptr& task) { return task->moved(); });
+	if (moved == 0)
+		failed = true;
+	std::cout << "Seed " << seed << ", " << threads << " threads" << (continuous ? ", continuous: " : ": ") << moved
+		<< " tasks moved to another thread" << (failed ? ", FAILED" : "") << std::endl;
+	return !failed;
+}
+
+int main(int argc, char* argv[]) {
+	Bool passed = true;
+	for (UInt seed = 1; seed <= 2; seed++) {
+		for (Int threads = 2; threads <= 3; threads++) {
+			for (Bool continuous : { false, true })
+				passed &= runGraph(seed, threads, continuous);
+		}
+	}
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/WorkStealingScheduler.h>
+#include "../RandomTaskGraph.h"
+
+using namespace DPsim;
+using namespace CPS;
+using namespace DPsim::Examples::RandomTaskGraph;
+
+// Runs the work stealing scheduler on random task graphs and checks that
+// each task runs exactly once per step, after all of its predecessors.
+
+Int numTasks = 200;
+Real edgeProbability = 0.05;
+Int numSteps = 500;
+
+Bool runGraph(UInt seed, Int threads) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<UInt> work(0, 500);
+
+	std::atomic<Bool> failed { false };
+	// Varying costs, so that the threads steal from each other
+	auto graph = create(rng, numTasks, edgeProbability,
+		[&work](std::mt19937& rng) { return work(rng); }, failed);
+
+	WorkStealingScheduler scheduler(threads);
+	run(scheduler, graph, numSteps, failed);
+
+	std::cout << "Seed " << seed << ", " << threads << " threads: " << scheduler.numSteals()
+		<< " stolen tasks" << (failed ? ", FAILED" : "") << std::endl;
+	return !failed;
+}
+
+int main(int argc, char* argv[]) {
+	Bool passed = true;
+	for (UInt seed = 1; seed <= 5; seed++) {
+		for (Int threads = 1; threads <= 3; threads++)
+			passed &= runGraph(seed, threads);
+	}
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include <dpsim/Definitions.h>
+
+namespace DPsim {
+
+	/// Sparse LU factorization tuned for circuit matrices, following the approach of KLU:
+	/// the matrix is permuted to block triangular form, each diagonal block is ordered by AMD
+	/// and factorized by a left-looking Gilbert-Peierls LU with partial pivoting.
+	/// Refactorizations with the same sparsity pattern reuse pivots and the symbolic structure.
+	class BTFSparseLU {
+	protected:
+		/// Factors of a diagonal block with row indices in pivot order
+		struct Block {
+			/// First row and column of the block in the permuted matrix
+			Int start = 0;
+			/// Dimension of the block
+			Int size = 0;
+			/// Column pointers, row indices and values of the unit lower factor without diagonal
+			std::vector<Int> Lp, Li;
+			std::vector<Real> Lx;
+			/// Column pointers, row indices and values of the upper factor with the diagonal last
+			std::vector<Int> Up, Ui;
+			std::vector<Real> Ux;
+			/// Pivot position of each local row
+			std::vector<Int> pinv;
+		};
+
+		/// Dimension of the system
+		Int mSize = 0;
+		/// Row pointers and column indices of the analyzed input pattern
+		std::vector<Int> mInputOuter, mInputInner;
+		/// Original row of each row of the permuted matrix
+		std::vector<Int> mRowPerm;
+		/// Original column of each column of the permuted matrix
+		std::vector<Int> mColPerm;
+		/// Column pointers and row indices of the permuted matrix
+		std::vector<Int> mPermutedOuter, mPermutedInner;
+		/// Values of the permuted matrix
+		std::vector<Real> mPermutedValues;
+		/// Permuted column of each original column
+		std::vector<Int> mColumnPosition;
+		/// Position of each input value in the permuted matrix
+		std::vector<Int> mValueMap;
+		/// First entry of each permuted column that belongs to its diagonal block
+		std::vector<Int> mDiagonalBlockStart;
+		/// Diagonal blocks of the block triangular form
+		std::vector<Block> mBlocks;
+		/// Block index of each permuted column
+		std::vector<Int> mColumnBlock;
+		/// Threshold relative to the largest candidate above which the diagonal is preferred as pivot
+		Real mPivotTolerance = 0.1;
+		/// Pivots smaller than this fraction of their column trigger a factorization with new pivots
+		Real mRefactorizationTolerance = 1e-10;
+		///
+		Bool mAnalysisIsOk = false;
+		///
+		Bool mFactorizationIsOk = false;
+		/// Number of refactorizations that had to choose new pivots
+		UInt mNumPivotUpdates = 0;
+		/// Original columns with varying values, which are ordered last in their block
+		std::vector<Bool> mVaryingColumns;
+		/// Indicates that a refactorization found varying columns that were not ordered last
+		Bool mHasNewVaryingColumns = false;
+		/// Permuted columns whose values changed since the last factorization
+		std::vector<Bool> mChangedColumns;
+		/// Number of block columns computed by refactorizations
+		std::size_t mNumRefactorizedColumns = 0;
+		/// Workspaces for factorization and solve
+		mutable std::vector<Real> mBlockWork, mSolveWork;
+
+		/// Checks whether the input matrix has the analyzed sparsity pattern
+		Bool hasAnalyzedPattern(const SparseMatrix& mat) const;
+		/// Copies the values of the input matrix into the permuted matrix
+		void permuteValues(const SparseMatrix& mat);
+		/// Copies the values of the input matrix and marks the columns of changed diagonal block entries
+		void updateValues(const SparseMatrix& mat);
+		/// Factorizes a diagonal block and chooses pivots
+		void factorizeBlock(Block& block);
+		/// Factorizes a diagonal block with the pivots and structure of the last factorization.
+		/// Only columns that changed or depend on changed columns are recomputed.
+		Bool refactorizeBlock(Block& block);
+
+	public:
+		/// Computes the block triangular form and the fill-reducing orderings.
+		/// Varying columns are ordered last in their block so that refactorizations
+		/// only have to update the trailing Schur complement.
+		void analyzePattern(const SparseMatrix& mat, const std::vector<Int>& varyingColumns = {});
+		/// Computes the numeric factorization including the choice of pivots
+		void factorize(const SparseMatrix& mat);
+		/// Computes the numeric factorization reusing pivots and structure of the last factorization.
+		/// Only blocks and columns affected by changed values are recomputed.
+		/// Falls back to factorize() if the matrix pattern changed or a pivot became too small.
+		void refactorize(const SparseMatrix& mat);
+		/// Solves the factorized system for the given right side vector
+		Matrix solve(const Matrix& rhs) const;
+
+		///
+		Bool isFactorized() const { return mFactorizationIsOk; }
+		/// Number of diagonal blocks of the block triangular form
+		UInt numBlocks() const { return mBlocks.size(); }
+		/// Number of non-zeros of the lower factors
+		std::size_t nnzL() const;
+		/// Number of non-zeros of the upper factors
+		std::size_t nnzU() const;
+		/// Number of refactorizations that had to choose new pivots
+		UInt numPivotUpdates() const { return mNumPivotUpdates; }
+		/// Number of block columns computed by refactorizations
+		std::size_t numRefactorizedColumns() const { return mNumRefactorizedColumns; }
+		/// Whether refactorizations changed columns that are not ordered last
+		Bool hasNewVaryingColumns() const { return mHasNewVaryingColumns; }
+		/// Original columns with varying values known so far
+		std::vector<Int> varyingColumns() const;
+	};
+}
@@ -0,0 +1,43 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <dpsim/Scheduler.h>
+
+namespace DPsim {
+	/// Schedule created by a scheduler that is stored in a file, so that later starts
+	/// of the same simulation can skip the dependency analysis and scheduling.
+	/// Tasks are identified by their names.
+	class CompiledSchedule {
+	public:
+		/// Hash of the task graph and the scheduler configuration the schedule was created for
+		std::uint64_t hash = 0;
+		/// Names of the scheduled tasks. Fused tasks consist of more than one task.
+		std::vector<std::vector<String>> tasks;
+		/// Groups of task indices as created by the scheduler (e.g. threads or levels)
+		std::vector<std::vector<Int>> groups;
+		/// Dependencies between the scheduled tasks
+		std::vector<std::pair<Int, Int>> edges;
+
+		/// Hash of the task names and the dependencies between their attributes.
+		/// The key describes the scheduler and its configuration.
+		static std::uint64_t computeHash(const CPS::Task::List& tasks, const String& key);
+
+		/// Write the schedule to a file. Each line starts with the type of the entry
+		/// (hash, task, group or edge) followed by the task names or indices.
+		void write(const String& filename) const;
+		/// Read a schedule from a file. Returns false if the file does not exist and
+		/// throws a SchedulingException if it is malformed.
+		Bool read(const String& filename);
+	};
+}
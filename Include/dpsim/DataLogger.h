@@ -35,6 +35,25 @@ namespace DPsim {
 
 		std::map<String, CPS::AttributeBase::Ptr> mAttributes;
 
+		/// Attribute values copied in one step and written in the next one
+		struct Snapshot {
+			Real time = 0;
+			Bool valid = false;
+			std::vector<Real> values;
+			/// String representation of the attributes that are not real
+			std::vector<String> strings;
+		};
+		/// Double buffer for pipelined logging, indexed by the parity of the step
+		Snapshot mSnapshots[2];
+		/// Real attributes in column order, nullptr for other types
+		std::vector<CPS::Attribute<Real>*> mRealAttributes;
+		/// Modified by the snapshot task, the delayed write task depends on its previous value
+		CPS::Attribute<Int>::Ptr mSnapshotCount;
+
+		void writeHeader();
+		void snapshot(Real time, Int timeStepCount);
+		void writeSnapshot(Snapshot& snapshot);
+
 		void logDataLine(Real time, Real data);
 		void logDataLine(Real time, const Matrix& data);
 		void logDataLine(Real time, const MatrixComp& data);
@@ -66,6 +85,10 @@ namespace DPsim {
 		void log(Real time, Int timeStepCount);
 
 		CPS::Task::Ptr getTask();
+		/// Tasks of the logger. If pipelined, the attributes are copied into a buffer in each step
+		/// and written to the file in the next step, so that formatting and file I/O do not delay
+		/// the solvers. Pending values are written when the logger is closed.
+		CPS::Task::List getTasks(Bool pipelined);
 
 		class Step : public CPS::Task {
 		public:
@@ -82,6 +105,39 @@ namespace DPsim {
 		private:
 			DataLogger& mLogger;
 		};
+
+		/// Copies the logged attributes for pipelined logging
+		class SnapshotStep : public CPS::Task {
+		public:
+			SnapshotStep(DataLogger& logger) :
+				Task(logger.mName + ".Snapshot"), mLogger(logger) {
+				for (auto attr : logger.mAttributes) {
+					mAttributeDependencies.push_back(attr.second);
+				}
+				mModifiedAttributes.push_back(logger.mSnapshotCount);
+			}
+
+			void execute(Real time, Int timeStepCount);
+
+		private:
+			DataLogger& mLogger;
+		};
+
+		/// Writes the snapshot of the previous step. Only depends on the previous step,
+		/// so it can run in parallel to the solvers.
+		class DelayedStep : public CPS::Task {
+		public:
+			DelayedStep(DataLogger& logger) :
+				Task(logger.mName + ".Write"), mLogger(logger) {
+				mPrevStepDependencies.push_back(logger.mSnapshotCount);
+				mModifiedAttributes.push_back(Scheduler::external);
+			}
+
+			void execute(Real time, Int timeStepCount);
+
+		private:
+			DataLogger& mLogger;
+		};
 	};
 }
 
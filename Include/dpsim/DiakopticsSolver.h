@@ -10,16 +10,30 @@
 
 #include <cps/AttributeList.h>
 #include <cps/Solver/MNAInterface.h>
+#include <cps/Solver/MNASwitchInterface.h>
 #include <cps/SimSignalComp.h>
 #include <dpsim/DataLogger.h>
+#include <dpsim/MNASolver.h>
 #include <dpsim/Solver.h>
 
+#include <bitset>
+#include <list>
 #include <unordered_map>
 
 namespace DPsim {
 	template <typename VarType>
 	class DiakopticsSolver : public Solver, public CPS::AttributeList {
 	private:
+		/// Factorization of a subnet's block for one switch state
+		struct SwitchedFactorization {
+			std::shared_ptr<CPS::LUFactorizedSparse> lu;
+			/// Contribution C^T * Y^-1 * C of the subnet to the tear impedance,
+			/// restricted to the tear currents entering the subnet
+			Matrix tearImpedance;
+			/// Estimated size in bytes
+			std::size_t memory;
+		};
+
 		struct Subnet {
 			/// Nodes assigned to this subnetwork
 			typename CPS::SimNode<VarType>::List nodes;
@@ -35,12 +49,71 @@ namespace DPsim {
 			UInt mVirtualNodeNum;
 			/// Offset of block in system matrix
 			UInt sysOff;
-			/// Factorization of the subnet's block
-			CPS::LUFactorized luFactorization;
+			/// Switches of this subnetwork, stamped according to the switch state
+			CPS::MNASwitchInterface::List switches;
+			/// Current switch state
+			std::bitset<SWITCH_NUM> switchStatus;
+			/// Set by the subnet solve if the switch state changed in this step
+			Bool switched = false;
+			/// Factorization of the current switch state
+			std::shared_ptr<SwitchedFactorization> factorization;
+			/// Cached switch states ordered from most to least recently used
+			std::list<std::bitset<SWITCH_NUM>> cacheOrder;
+			/// Position in the usage order and factorization of each cached switch state
+			std::unordered_map< std::bitset<SWITCH_NUM>, std::pair<std::list<std::bitset<SWITCH_NUM>>::iterator,
+				std::shared_ptr<SwitchedFactorization>> > cacheEntries;
+			/// Estimated memory of all cached switch states in bytes
+			std::size_t cacheMemory = 0;
+			UInt cacheHits = 0;
+			UInt cacheMisses = 0;
+			UInt cacheEvictions = 0;
+			/// Tear current variables entering the subnet
+			std::vector<Int> tearColumns;
 			/// List of all right side vector contributions
 			std::vector<const Matrix*> rightVectorStamps;
 			/// Left-side vector of the subnet AFTER complete step
 			CPS::Attribute<Matrix>::Ptr leftVector;
+			/// Modified when the subnet's block of the original left-side vector is solved
+			CPS::Attribute<Int>::Ptr solved;
+			/// Rows of the tear topology that belong to the subnet (only for nested tearing)
+			CPS::SparseMatrix tearTopology;
+		};
+
+		/// Node of the nested dissection tree of the subnets. Each node holds the tear
+		/// currents between the subnets of its two subtrees. The tear current system is
+		/// solved by block elimination along the tree (multifrontal), so that the
+		/// nodes of different subtrees are reduced in parallel.
+		struct TearNode {
+			Int parent = -1;
+			std::vector<Int> children;
+			/// Subnet of a leaf
+			Int subnet = -1;
+			/// Tear components assigned to this node
+			std::vector<UInt> components;
+			/// Indices of the own tear current variables
+			std::vector<Int> vars;
+			/// Tear current variables of all ancestors, in the order of the parent's frontal matrix
+			std::vector<Int> ancestorVars;
+			/// Subnets connected by the own tear components
+			std::vector<UInt> subnets;
+			/// Columns of the tear topology of the own variables
+			CPS::SparseMatrix topology;
+			/// Factorization of the own block of the frontal matrix
+			CPS::LUFactorized pivot;
+			/// Coupling of the ancestors to the own variables
+			Matrix lower;
+			/// Own block inverse times coupling to the ancestors
+			Matrix upper;
+			/// Own variables after forward elimination
+			Matrix solution;
+			/// Contribution of this subtree to the ancestors' right side
+			Matrix update;
+			/// Schur complement of the own block, added to the parent's frontal matrix
+			Matrix schur;
+			/// Set by the forward elimination if a switch state in the subtree changed
+			Bool switched = false;
+			CPS::Attribute<Int>::Ptr forward;
+			CPS::Attribute<Int>::Ptr backward;
 		};
 
 		///
@@ -54,23 +127,28 @@ namespace DPsim {
 		std::shared_ptr<DataLogger> mRightVectorLog;
 
 		std::vector<Subnet> mSubnets;
+		/// Use the tear tree instead of a single tear current system
+		Bool mNestedTearing;
+		/// Nested dissection tree, parents are stored before their children
+		std::vector<TearNode> mTearTree;
+		/// Tree node of each subnet
+		std::vector<Int> mSubnetTearNode;
 		std::unordered_map<typename CPS::SimNode<VarType>::Ptr, Subnet*> mNodeSubnetMap;
 		typename CPS::SimPowerComp<VarType>::List mTearComponents;
 		CPS::SimSignalComp::List mSimSignalComps;
 
 		Matrix mRightSideVector;
 		Matrix mLeftSideVector;
-		/// Complete matrix in block form
-		Matrix mSystemMatrix;
-		/// Inverse of the complete system matrix (only used for initialization)
-		Matrix mSystemInverse;
-		/// Topology of the network removal
-		Matrix mTearTopology;
+		/// Topology of the network removal (incidence of the tear currents)
+		CPS::SparseMatrix mTearTopology;
 		/// Impedance of the removed network
 		Matrix mTearImpedance;
-		/// (Factorization of the) impedance matrix for the removed network, including
-		/// the influence of other subnets
+		/// Impedance matrix for the removed network, including the influence of other subnets
+		Matrix mTotalTearImpedanceMatrix;
+		/// Factorization of the total impedance matrix
 		CPS::LUFactorized mTotalTearImpedance;
+		/// Memory budget in bytes for the cached switch states of each subnet, zero means unbounded
+		std::size_t mSwitchedMatrixCacheBudget = 0;
 		/// Currents through the removed network
 		Matrix mTearCurrents;
 		/// Voltages across the removed network
@@ -91,7 +169,22 @@ namespace DPsim {
 		void initComponents();
 
 		void initMatrices();
-		void applyTearComponentStamp(UInt compIdx);
+		void applyTearComponentStamp(UInt compIdx, std::vector<Eigen::Triplet<Real>>& topology);
+		void addSubnetTearImpedance(const Subnet& net, const Matrix& impedance, Matrix& totalTearImpedance);
+		/// Assembles Z' from the removed impedance and the current factorizations of the subnets
+		void factorizeTotalTearImpedance();
+
+		/// Updates the switch state of a subnet and selects the matching factorization
+		void updateSwitchStatus(Subnet& net);
+		/// Marks the subnet's switch state as most recently used and factorizes it on a cache miss
+		std::shared_ptr<SwitchedFactorization> cachedSwitchedFactorization(Subnet& net);
+		std::shared_ptr<SwitchedFactorization> factorizeSubnet(const Subnet& net);
+
+		Int buildTearTree(const std::vector<UInt>& subnets, Int parent);
+		void initTearTree();
+		/// Assembles and factorizes the frontal matrix of a tree node
+		void factorizeTearNode(TearNode& node);
+		UInt tearVariablesPerComponent();
 
 		void log(Real time);
 
@@ -103,7 +196,19 @@ namespace DPsim {
 		/// Solutions of the split systems
 		const CPS::Attribute<Matrix>::Ptr mOrigLeftSideVector;
 
-		DiakopticsSolver(String name, CPS::SystemTopology system, CPS::IdentifiedObject::List tearComponents, Real timeStep, CPS::Logger::Level logLevel);
+		DiakopticsSolver(String name, CPS::SystemTopology system, CPS::IdentifiedObject::List tearComponents, Real timeStep, CPS::Logger::Level logLevel,
+			Bool nestedTearing = false);
+
+		virtual ~DiakopticsSolver() {
+			for (UInt net = 0; net < mSubnets.size(); ++net) {
+				if (mSubnets[net].cacheMisses > 1)
+					mSLog->info("Switch state cache of subnet {:d}: {:d} hits, {:d} misses, {:d} evictions", net,
+						mSubnets[net].cacheHits, mSubnets[net].cacheMisses, mSubnets[net].cacheEvictions);
+			}
+		}
+
+		/// Set the memory budget in bytes for the cached switch states of each subnet
+		void setSwitchedMatrixCacheBudget(std::size_t bytes) { mSwitchedMatrixCacheBudget = bytes; }
 
 		CPS::Task::List getTasks();
 
@@ -117,6 +222,7 @@ namespace DPsim {
 					}
 				}
 				mModifiedAttributes.push_back(solver.attribute("old_left_vector"));
+				mModifiedAttributes.push_back(mSubnet.solved);
 			}
 
 			void execute(Real time, Int timeStepCount);
@@ -145,7 +251,10 @@ namespace DPsim {
 		public:
 			SolveTask(DiakopticsSolver<VarType>& solver, UInt net) :
 				Task(solver.mName + ".Solve_" + std::to_string(net)), mSolver(solver), mSubnet(solver.mSubnets[net]) {
-				mAttributeDependencies.push_back(solver.attribute("mapped_tear_currents"));
+				if (solver.mNestedTearing)
+					mAttributeDependencies.push_back(solver.mTearTree[solver.mSubnetTearNode[net]].backward);
+				else
+					mAttributeDependencies.push_back(solver.attribute("mapped_tear_currents"));
 				mModifiedAttributes.push_back(mSubnet.leftVector);
 			}
 
@@ -156,6 +265,47 @@ namespace DPsim {
 			Subnet& mSubnet;
 		};
 
+		/// Eliminates the tear currents of a tree node from the frontal system
+		class ForwardTask : public CPS::Task {
+		public:
+			ForwardTask(DiakopticsSolver<VarType>& solver, UInt node) :
+				Task(solver.mName + ".TearForward_" + std::to_string(node)), mSolver(solver), mNode(solver.mTearTree[node]) {
+				if (mNode.subnet >= 0)
+					mAttributeDependencies.push_back(solver.mSubnets[mNode.subnet].solved);
+				for (auto net : mNode.subnets) {
+					mAttributeDependencies.push_back(solver.mSubnets[net].solved);
+				}
+				for (auto child : mNode.children) {
+					mAttributeDependencies.push_back(solver.mTearTree[child].forward);
+				}
+				mModifiedAttributes.push_back(mNode.forward);
+			}
+
+			void execute(Real time, Int timeStepCount);
+
+		private:
+			DiakopticsSolver<VarType>& mSolver;
+			TearNode& mNode;
+		};
+
+		/// Computes the tear currents of a tree node from the ones of its ancestors
+		class BackwardTask : public CPS::Task {
+		public:
+			BackwardTask(DiakopticsSolver<VarType>& solver, UInt node) :
+				Task(solver.mName + ".TearBackward_" + std::to_string(node)), mSolver(solver), mNode(solver.mTearTree[node]) {
+				mAttributeDependencies.push_back(mNode.forward);
+				if (mNode.parent >= 0)
+					mAttributeDependencies.push_back(solver.mTearTree[mNode.parent].backward);
+				mModifiedAttributes.push_back(mNode.backward);
+			}
+
+			void execute(Real time, Int timeStepCount);
+
+		private:
+			DiakopticsSolver<VarType>& mSolver;
+			TearNode& mNode;
+		};
+
 		class PostSolveTask : public CPS::Task {
 		public:
 			PostSolveTask(DiakopticsSolver<VarType>& solver) :
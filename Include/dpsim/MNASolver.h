@@ -80,6 +80,18 @@ namespace DPsim {
 		Matrix mRightSideVector;
 		/// List of all right side vector contributions
 		std::vector<const Matrix*> mRightVectorStamps;
+		/// Rows of the right side vector written by each stamp, empty if the full stamp has to be added
+		std::vector<std::vector<UInt>> mRightVectorStampIndices;
+		/// Add only the rows belonging to the nodes of each component
+		Bool mSparseRightVectorAssembly = true;
+		/// Components of the right side vector contributions, which are told about their rows
+		CPS::MNAInterface::List mRightVectorStampComponents;
+		/// Indicates that the stamp rows have been checked against the first assembled stamps
+		Bool mRightVectorStampIndicesChecked = false;
+		/// Switch status at the last assembly, the stamp rows are checked again when it changes
+		std::bitset<SWITCH_NUM> mRightVectorStampSwitchStatus;
+		/// Marks the rows of the stamp being checked, all false between the checks
+		std::vector<Bool> mRightVectorStampRowMask;
 
 		// #### MNA specific attributes related to harmonics / additional frequencies ####
 		/// Source vector of known quantities
@@ -87,13 +99,37 @@ namespace DPsim {
 
 		// #### MNA specific attributes related to system recomputation
 		/// Number of system matrix recomputations
-		Int mNumRecomputations;
+		Int mNumRecomputations = 0;
 		/// List of components that indicate the solver to recompute the system matrix
 		/// depending on their state
 		CPS::MNAVariableCompInterface::List mVariableComps;
 		/// List of variable components if they must be accessed as MNAInterface objects
 		CPS::MNAInterface::List mMNAIntfVariableComps;
 
+		// #### Attributes related to on-demand switch matrices ####
+		/// Stamp and factorize only the switch states that are reached during simulation
+		Bool mSwitchedMatrixCaching = false;
+		/// Memory budget for cached switch state factorizations in bytes, zero means unbounded
+		std::size_t mSwitchedMatrixCacheBudget = 0;
+
+		// #### Attributes related to low-rank system matrix updates ####
+		/// Correct the factorization by low-rank updates instead of refactorizing on variable component changes
+		Bool mLowRankUpdate = false;
+		/// Maximum number of changed rows or columns before the system matrix is refactorized
+		UInt mLowRankUpdateMaxRank = 16;
+
+		// #### Attributes related to mixed precision ####
+		/// Keep the switch state factorizations in single precision and refine the solution in double precision
+		Bool mMixedPrecision = false;
+		/// Maximum number of iterative refinement steps per solve
+		UInt mMixedPrecisionRefinementSteps = 2;
+		/// Residual relative to the right side vector above which the solve falls back to double precision
+		Real mMixedPrecisionTolerance = 1e-10;
+
+		// #### Attributes related to complex system matrices ####
+		/// Factorize DP and SP system matrices in complex arithmetic instead of the real and imaginary part blocks
+		Bool mComplexSystemMatrix = false;
+
 		// #### Attributes related to switching ####
 		/// Index of the next switching event
 		UInt mSwitchTimeIndex = 0;
@@ -149,6 +185,12 @@ namespace DPsim {
 		virtual void switchedMatrixStamp(std::size_t swIdx, Int freqIdx, CPS::MNAInterface::List& components, CPS::MNASwitchInterface::List& switches) { }
 		/// Checks whether the status of variable MNA elements have changed
 		Bool hasVariableComponentChanged();
+		/// Returns the rows of the right side vector the component can write to, empty if unknown
+		std::vector<UInt> rightVectorStampIndices(CPS::MNAInterface::Ptr comp);
+		/// Falls back to the full stamp for components that wrote outside of their rows
+		void checkRightVectorStampIndices();
+		/// Sums up the right side vector stamps of all components
+		void assembleRightSideVector();
 
 		// #### Methods to implement for system recomputation over time ####
 		/// Stamps components into the variable system matrix
@@ -175,6 +217,8 @@ namespace DPsim {
 		virtual void solveWithHarmonics(Real time, Int timeStepCount, Int freqIdx) = 0;
 		/// Logs left and right vector
 		virtual void log(Real time, Int timeStepCount) override;
+		/// Collects the tasks of components, switches and nodes without the solver tasks
+		CPS::Task::List getComponentTasks();
 
 	public:
 
@@ -202,6 +246,29 @@ namespace DPsim {
 		Matrix& rightSideVector() { return mRightSideVector; }
 		///
 		virtual CPS::Task::List getTasks() override;
+		/// Factorize switch states on demand and keep them in an LRU cache.
+		/// Only supported by the EigenSparse implementation.
+		void doSwitchedMatrixCaching(Bool value) { mSwitchedMatrixCaching = value; }
+		/// Set the memory budget in bytes for cached switch state factorizations
+		void setSwitchedMatrixCacheBudget(std::size_t bytes) { mSwitchedMatrixCacheBudget = bytes; }
+		/// Add only the rows belonging to the nodes of each component when summing up the right side vector
+		void doSparseRightVectorAssembly(Bool value) { mSparseRightVectorAssembly = value; }
+		/// Apply variable component changes as low-rank updates of the last factorization.
+		/// Only supported by the EigenSparse implementation with system matrix recomputation.
+		void doLowRankSystemMatrixUpdate(Bool value) { mLowRankUpdate = value; }
+		/// Set the rank above which the system matrix is refactorized instead
+		void setLowRankUpdateMaxRank(UInt rank) { mLowRankUpdateMaxRank = rank; }
+		/// Factorize switch state matrices in single precision and refine solutions in double precision.
+		/// Only supported by the EigenSparse implementation without system matrix recomputation.
+		void doMixedPrecisionSolve(Bool value) { mMixedPrecision = value; }
+		/// Set the maximum number of refinement steps and the residual tolerance of mixed precision solves
+		void setMixedPrecisionRefinement(UInt steps, Real tolerance) {
+			mMixedPrecisionRefinementSteps = steps;
+			mMixedPrecisionTolerance = tolerance;
+		}
+		/// Stamp and factorize DP and SP system matrices in complex arithmetic.
+		/// Only supported by the EigenSparse implementation with precomputed or cached switch states.
+		void doComplexSystemMatrix(Bool value) { mComplexSystemMatrix = value; }
 
 	};
 }
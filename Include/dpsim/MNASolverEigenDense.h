@@ -41,6 +41,7 @@ namespace DPsim {
 		using MnaSolver<VarType>::mLeftSideVector;
 		using MnaSolver<VarType>::mCurrentSwitchStatus;
 		using MnaSolver<VarType>::mRightVectorStamps;
+		using MnaSolver<VarType>::assembleRightSideVector;
 		using MnaSolver<VarType>::mNumNetNodes;
 		using MnaSolver<VarType>::mNodes;
 		using MnaSolver<VarType>::mIsInInitialization;
@@ -9,8 +9,10 @@
 #pragma once
 
 #include <iostream>
+#include <atomic>
 #include <vector>
 #include <list>
+#include <map>
 #include <unordered_map>
 #include <bitset>
 #include <memory>
@@ -28,6 +30,50 @@
 
 namespace DPsim {
 
+	// The symbolic analysis of Eigen's SparseLU is kept in protected members, which are
+	// only taken over for the Eigen versions known to have them. Other versions analyze
+	// every matrix on its own.
+#if EIGEN_VERSION_AT_LEAST(3,3,0) && !EIGEN_VERSION_AT_LEAST(3,4,90)
+#define DPSIM_SPARSELU_SHARED_ANALYSIS
+#endif
+
+	/// Sparse LU factorization that can take over the fill-reducing ordering and
+	/// elimination tree of another factorization with the same sparsity pattern
+	class LUFactorizedSparseShared : public CPS::LUFactorizedSparse {
+		friend class LUFactorizedSparseSingle;
+	public:
+		/// Copies the symbolic analysis so that only factorize() remains to be called,
+		/// or analyzes the matrix if the analysis cannot be copied
+		void adoptSymbolicAnalysis(const LUFactorizedSparseShared& analysis, const SparseMatrix& matrix) {
+#ifdef DPSIM_SPARSELU_SHARED_ANALYSIS
+			m_perm_c = analysis.m_perm_c;
+			m_etree = analysis.m_etree;
+			m_analysisIsOk = analysis.m_analysisIsOk;
+			m_factorizationIsOk = false;
+#else
+			analyzePattern(matrix);
+#endif
+		}
+	};
+
+	/// Single precision sparse LU factorization that can take over the symbolic analysis
+	/// of a double precision factorization
+	class LUFactorizedSparseSingle : public Eigen::SparseLU<Eigen::SparseMatrix<float>> {
+	public:
+		/// Copies the symbolic analysis so that only factorize() remains to be called,
+		/// or analyzes the matrix if the analysis cannot be copied
+		void adoptSymbolicAnalysis(const LUFactorizedSparseShared& analysis, const Eigen::SparseMatrix<float>& matrix) {
+#ifdef DPSIM_SPARSELU_SHARED_ANALYSIS
+			m_perm_c = analysis.m_perm_c;
+			m_etree = analysis.m_etree;
+			m_analysisIsOk = analysis.m_analysisIsOk;
+			m_factorizationIsOk = false;
+#else
+			analyzePattern(matrix);
+#endif
+		}
+	};
+
 	/// Solver class using Modified Nodal Analysis (MNA).
 	template <typename VarType>
 	class MnaSolverEigenSparse : public MnaSolver<VarType> {
@@ -36,7 +82,27 @@ namespace DPsim {
 		/// Map of system matrices where the key is the bitset describing the switch states
 		std::unordered_map< std::bitset<SWITCH_NUM>, std::vector<SparseMatrix> > mSwitchedMatrices;
 		/// Map of LU factorizations related to the system matrices
-		std::unordered_map< std::bitset<SWITCH_NUM>, std::vector< std::shared_ptr< CPS::LUFactorizedSparse> > > mLuFactorizations;
+		std::unordered_map< std::bitset<SWITCH_NUM>, std::vector< std::shared_ptr<LUFactorizedSparseShared> > > mLuFactorizations;
+		/// Union of the sparsity patterns of all switch states with zero values
+		SparseMatrix mUnionPattern;
+		/// Symbolic analysis of the union pattern shared by all switch state factorizations
+		LUFactorizedSparseShared mUnionPatternAnalysis;
+		/// Indicates that the union pattern has been analyzed
+		Bool mUnionPatternAnalyzed = false;
+		/// Single precision factorizations of the system matrices used for mixed precision solves,
+		/// switch states without one are solved in double precision
+		std::unordered_map< std::bitset<SWITCH_NUM>, std::vector< std::shared_ptr<LUFactorizedSparseSingle> > > mLuFactorizationsSingle;
+		/// Number of mixed precision solves that had to fall back to double precision,
+		/// counted from the concurrent solves of all frequencies
+		std::atomic<UInt> mNumMixedPrecisionFallbacks { 0 };
+		/// Complex system matrices with one row and column per matrix node index, where the key is the switch state
+		std::unordered_map< std::bitset<SWITCH_NUM>, SparseMatrixComp > mSwitchedMatricesComplex;
+		/// LU factorizations of the complex system matrices
+		std::unordered_map< std::bitset<SWITCH_NUM>, std::shared_ptr< Eigen::SparseLU<CPS::SparseMatrixComp> > > mLuFactorizationsComplex;
+		/// Solvers of further scenarios with the same system matrices that are solved together with this one
+		std::vector< std::shared_ptr<MnaSolverEigenSparse<VarType>> > mScenarios;
+		/// Factorize the precomputed switch state matrices, disabled for scenario solvers
+		Bool mSwitchedMatrixFactorization = true;
 
 		// #### Data structures for system recomputation over time ####
 		/// System matrix including all static elements
@@ -46,6 +112,38 @@ namespace DPsim {
 		/// LU factorization of variable system matrix
 		CPS::LUFactorizedSparse mLuFactorizationVariableSystemMatrix;
 
+		// #### Data structures for low-rank updates of the variable system matrix ####
+		/// System matrix from which the current factorization was computed
+		SparseMatrix mFactorizedSystemMatrix;
+		/// Columns of the inverse of the factorized matrix, computed on demand per row index
+		std::unordered_map<UInt, Matrix> mInverseColumns;
+		/// Column indices of the changed entries
+		std::vector<UInt> mLowRankCols;
+		/// Inverse columns belonging to the row indices of the changed entries
+		Matrix mLowRankInverseColumns;
+		/// Changed entries restricted to their rows and columns
+		Matrix mLowRankCorrection;
+		/// LU factorization of the capacitance matrix of the low-rank update
+		Eigen::PartialPivLU<Matrix> mLowRankCapacitance;
+		/// Indicates that the solution has to be corrected by the low-rank update
+		Bool mLowRankActive = false;
+		/// Number of variable component changes handled by low-rank updates
+		UInt mNumLowRankUpdates = 0;
+
+		// #### Data structures for on-demand switch matrices ####
+		/// Cached switch states ordered from most to least recently used
+		std::list<std::bitset<SWITCH_NUM>> mSwitchedCacheOrder;
+		/// Position in the usage order and estimated size in bytes of each cached switch state
+		std::unordered_map< std::bitset<SWITCH_NUM>, std::pair<std::list<std::bitset<SWITCH_NUM>>::iterator, std::size_t> > mSwitchedCacheEntries;
+		/// Estimated memory of all cached switch states in bytes
+		std::size_t mSwitchedCacheMemory = 0;
+		/// Number of solves that found their switch state in the cache
+		UInt mSwitchedCacheHits = 0;
+		/// Number of switch states that had to be stamped and factorized
+		UInt mSwitchedCacheMisses = 0;
+		/// Number of switch states dropped to stay within the memory budget
+		UInt mSwitchedCacheEvictions = 0;
+
 		using MnaSolver<VarType>::mSwitches;
 		using MnaSolver<VarType>::mMNAComponents;
 		using MnaSolver<VarType>::mVariableComps;
@@ -54,6 +152,7 @@ namespace DPsim {
 		using MnaSolver<VarType>::mLeftSideVector;
 		using MnaSolver<VarType>::mCurrentSwitchStatus;
 		using MnaSolver<VarType>::mRightVectorStamps;
+		using MnaSolver<VarType>::assembleRightSideVector;
 		using MnaSolver<VarType>::mNumNetNodes;
 		using MnaSolver<VarType>::mNodes;
 		using MnaSolver<VarType>::mIsInInitialization;
@@ -64,8 +163,20 @@ namespace DPsim {
 		using MnaSolver<VarType>::mSystemMatrixRecomputation;
 		using MnaSolver<VarType>::hasVariableComponentChanged;
 		using MnaSolver<VarType>::mNumRecomputations;
+		using MnaSolver<VarType>::mSwitchedMatrixCaching;
+		using MnaSolver<VarType>::mSwitchedMatrixCacheBudget;
+		using MnaSolver<VarType>::mLowRankUpdate;
+		using MnaSolver<VarType>::mLowRankUpdateMaxRank;
+		using MnaSolver<VarType>::mListVariableSystemMatrixEntries;
+		using MnaSolver<VarType>::mMixedPrecision;
+		using MnaSolver<VarType>::mMixedPrecisionRefinementSteps;
+		using MnaSolver<VarType>::mMixedPrecisionTolerance;
+		using MnaSolver<VarType>::mComplexSystemMatrix;
+		using MnaSolver<VarType>::mSystem;
 
 		// #### General
+		/// Initialization of system matrices and source vector
+		virtual void initializeSystem() override;
 		/// Create system matrix
 		virtual void createEmptySystemMatrix() override;
 
@@ -77,6 +188,43 @@ namespace DPsim {
 		/// Applies a component stamp to the matrix with the given switch index
 		virtual void switchedMatrixStamp(std::size_t index, std::vector<std::shared_ptr<CPS::MNAInterface>>& comp) override;
 
+		/// Applies a component and switch stamp to the matrix with the given switch index and frequency index
+		virtual void switchedMatrixStamp(std::size_t swIdx, Int freqIdx, CPS::MNAInterface::List& components, CPS::MNASwitchInterface::List& switches) override;
+		/// Stamps all components and both states of all switches to obtain the union pattern and analyzes it
+		void analyzeUnionPattern(Int size);
+		/// Computes the symbolic analysis of the union pattern used by factorizeSwitchedMatrix()
+		virtual void analyzeUnionPatternSymbolic();
+		/// Factorizes a switch state matrix reusing the union pattern analysis when possible
+		virtual void factorizeSwitchedMatrix(const std::bitset<SWITCH_NUM>& status, Int freqIdx);
+		/// Factorizes a switch state matrix in double precision
+		void factorizeSwitchedMatrixDouble(const std::bitset<SWITCH_NUM>& status, Int freqIdx);
+		/// Solves with the factorization of a switch state, using iterative refinement
+		/// if the factorization is kept in single precision
+		virtual Matrix solveSwitchedMatrix(const std::bitset<SWITCH_NUM>& status, Int freqIdx, const Matrix& rhs);
+		/// Drops the matrices and factorizations of all switch states
+		virtual void releaseSwitchedMatrices();
+		/// Solves this solver and all scenarios with one multi-column solve per switch state
+		void solveScenarios();
+
+		// #### Methods for complex system matrices ####
+		/// Whether the switch state matrices are stamped and factorized in complex arithmetic
+		Bool useComplexSystemMatrix();
+		/// Stamps and factorizes the complex system matrix of a switch state. Components without
+		/// a complex stamp are stamped into the real split matrix first, which is then folded.
+		/// Returns false if these stamps do not describe a complex linear system.
+		Bool complexSwitchedMatrixStamp(const std::bitset<SWITCH_NUM>& status, CPS::MNAInterface::List& components);
+		/// Adds a matrix with real and imaginary part blocks to a complex matrix,
+		/// returns false if the blocks do not represent complex entries
+		static Bool addComplexSplitMatrix(const SparseMatrix& split, SparseMatrixComp& mat);
+
+		// #### Methods for on-demand switch matrices ####
+		/// Marks the switch state as most recently used and factorizes it on a cache miss
+		void cachedSwitchedFactorization(const std::bitset<SWITCH_NUM>& status);
+		/// Estimates the memory held by the matrix and factorization of a switch state
+		std::size_t switchedMatrixMemory(const std::bitset<SWITCH_NUM>& status);
+		/// Drops all cached switch states
+		void clearSwitchedMatrixCache();
+
 		// #### Methods for system recomputation over time ####
 		/// Stamps components into the variable system matrix
 		void stampVariableSystemMatrix() override;
@@ -84,8 +232,15 @@ namespace DPsim {
 		void solveWithSystemMatrixRecomputation(Real time, Int timeStepCount) override;
 		/// Create a solve task for recomputation solver
 		virtual std::shared_ptr<CPS::Task> createSolveTaskRecomp() override;
+		/// Factorizes the variable system matrix, optionally without a new symbolic analysis
+		virtual void factorizeVariableSystemMatrix(Bool analyzePattern);
 		/// Recomputes systems matrix
 		virtual void recomputeSystemMatrix(Real time);
+		/// Expresses the change of the variable system matrix as low-rank update of the
+		/// current factorization, returns false if a refactorization is required instead
+		Bool updateLowRankCorrection();
+		/// Returns the column of the inverse factorized matrix for the given index
+		const Matrix& inverseColumn(UInt index);
 
 		// #### Scheduler Task Methods ####
 		/// Create a solve task for this solver implementation
@@ -108,8 +263,42 @@ namespace DPsim {
 			CPS::Domain domain = CPS::Domain::DP,
 			CPS::Logger::Level logLevel = CPS::Logger::Level::info);
 
+		/// Usage counters of the switch state cache
+		struct SwitchedMatrixCacheStats {
+			UInt hits;
+			UInt misses;
+			UInt evictions;
+			UInt entries;
+			std::size_t memory;
+		};
+
 		/// Destructor
-		virtual ~MnaSolverEigenSparse() { };
+		virtual ~MnaSolverEigenSparse() {
+			if (mNumMixedPrecisionFallbacks > 0)
+				mSLog->info("Number of mixed precision solves refactorized in double precision: {:d}",
+					mNumMixedPrecisionFallbacks.load());
+			if (mNumLowRankUpdates > 0)
+				mSLog->info("Number of low-rank system matrix updates: {:d}", mNumLowRankUpdates);
+			if (mSwitchedCacheMisses > 0)
+				mSLog->info("Switch state cache: {:d} hits, {:d} misses, {:d} evictions",
+					mSwitchedCacheHits, mSwitchedCacheMisses, mSwitchedCacheEvictions);
+		};
+
+		/// Adds the initialized solver of a scenario that differs from this solver's system only
+		/// in its right side vector. Both are then solved together with the factorizations of this solver.
+		void addScenario(std::shared_ptr<MnaSolverEigenSparse<VarType>> scenario);
+		/// Only stamp the precomputed switch state matrices without factorizing them. Used for
+		/// scenario solvers, which are solved with the factorizations of the solver they are added to.
+		/// Must be called before initialize().
+		void doSwitchedMatrixFactorization(Bool value) { mSwitchedMatrixFactorization = value; }
+		///
+		virtual CPS::Task::List getTasks() override;
+
+		/// Returns the usage counters of the switch state cache
+		SwitchedMatrixCacheStats switchedMatrixCacheStats() const {
+			return { mSwitchedCacheHits, mSwitchedCacheMisses, mSwitchedCacheEvictions,
+				static_cast<UInt>(mSwitchedCacheOrder.size()), mSwitchedCacheMemory };
+		}
 
 		// #### MNA Solver Tasks ####
 		///
@@ -118,14 +307,20 @@ namespace DPsim {
 			SolveTask(MnaSolverEigenSparse<VarType>& solver) :
 				Task(solver.mName + ".Solve"), mSolver(solver) {
 
-				for (auto it : solver.mMNAComponents) {
-					if (it->template attribute<Matrix>("right_vector")->get().size() != 0)
-						mAttributeDependencies.push_back(it->attribute("right_vector"));
-				}
-				for (auto node : solver.mNodes) {
-					mModifiedAttributes.push_back(node->attribute("v"));
+				std::vector<MnaSolverEigenSparse<VarType>*> solvers = { &solver };
+				for (auto scenario : solver.mScenarios)
+					solvers.push_back(scenario.get());
+
+				for (auto solver : solvers) {
+					for (auto it : solver->mMNAComponents) {
+						if (it->template attribute<Matrix>("right_vector")->get().size() != 0)
+							mAttributeDependencies.push_back(it->attribute("right_vector"));
+					}
+					for (auto node : solver->mNodes) {
+						mModifiedAttributes.push_back(node->attribute("v"));
+					}
+					mModifiedAttributes.push_back(solver->attribute("left_vector"));
 				}
-				mModifiedAttributes.push_back(solver.attribute("left_vector"));
 			}
 
 			void execute(Real time, Int timeStepCount) { mSolver.solve(time, timeStepCount); }
@@ -13,6 +13,7 @@
 #include <dpsim/MNASolverEigenDense.h>
 #ifdef WITH_SPARSE
 #include <dpsim/MNASolverEigenSparse.h>
+#include <dpsim/MNASolverKLU.h>
 #endif
 #ifdef WITH_CUDA
 	#include <dpsim/MNASolverGpuDense.h>
@@ -41,6 +42,7 @@ class MnaSolverFactory {
 		CUDASparse,
 		CUDAMagma,
 		Plugin,
+		KLU,
 	};
 
 	/// MNA implementations supported by this compilation
@@ -51,6 +53,7 @@ class MnaSolverFactory {
 #endif //WITH_MNASOLVERPLUGIN
 			EigenDense,
 #ifdef WITH_SPARSE
+			KLU,
 			EigenSparse,
 #endif //WITH_SPARSE
 #ifdef WITH_CUDA
@@ -89,6 +92,9 @@ class MnaSolverFactory {
 		case MnaSolverImpl::EigenSparse:
 			log->info("creating EigenSparse solver implementation");
 			return std::make_shared<MnaSolverEigenSparse<VarType>>(name, domain, logLevel);
+		case MnaSolverImpl::KLU:
+			log->info("creating KLU solver implementation");
+			return std::make_shared<MnaSolverKLU<VarType>>(name, domain, logLevel);
 #endif
 #ifdef WITH_CUDA
 		case MnaSolverImpl::CUDADense:
@@ -0,0 +1,81 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <dpsim/MNASolverEigenSparse.h>
+#include <dpsim/BTFSparseLU.h>
+
+namespace DPsim {
+
+	/// Solver class using Modified Nodal Analysis (MNA) with a KLU-style
+	/// circuit LU factorization based on the block triangular form.
+	template <typename VarType>
+	class MnaSolverKLU : public MnaSolverEigenSparse<VarType> {
+	protected:
+		/// Map of factorizations related to the system matrices
+		std::unordered_map< std::bitset<SWITCH_NUM>, std::vector<BTFSparseLU> > mKLUFactorizations;
+		/// Symbolic analysis of the union pattern that is copied to all switch states
+		BTFSparseLU mUnionPatternKLU;
+		/// Factorization of the variable system matrix
+		BTFSparseLU mKLUVariableSystemMatrix;
+
+		using MnaSolver<VarType>::mRightSideVector;
+		using MnaSolver<VarType>::mLeftSideVector;
+		using MnaSolver<VarType>::mNumNetNodes;
+		using MnaSolver<VarType>::mNodes;
+		using MnaSolver<VarType>::mSLog;
+		using MnaSolver<VarType>::mSystemMatrixRecomputation;
+		using MnaSolver<VarType>::hasVariableComponentChanged;
+		using MnaSolver<VarType>::assembleRightSideVector;
+		using MnaSolver<VarType>::mSwitchedMatrixCaching;
+		using MnaSolver<VarType>::mLowRankUpdate;
+		using MnaSolver<VarType>::mMixedPrecision;
+		using MnaSolver<VarType>::mComplexSystemMatrix;
+		using MnaSolver<VarType>::mListVariableSystemMatrixEntries;
+		using MnaSolverEigenSparse<VarType>::mSwitchedMatrices;
+		using MnaSolverEigenSparse<VarType>::mUnionPattern;
+		using MnaSolverEigenSparse<VarType>::mVariableSystemMatrix;
+		using MnaSolverEigenSparse<VarType>::recomputeSystemMatrix;
+
+		/// Computes the block triangular form and orderings of the union pattern
+		/// instead of the Eigen analysis, which is not used by this implementation
+		virtual void analyzeUnionPatternSymbolic() override;
+		/// Factorizes a switch state matrix reusing the union pattern analysis when possible
+		virtual void factorizeSwitchedMatrix(const std::bitset<SWITCH_NUM>& status, Int freqIdx) override;
+		/// Factorizes the variable system matrix, reusing pivots if no new analysis is requested
+		virtual void factorizeVariableSystemMatrix(Bool analyzePattern) override;
+		/// Columns of the system matrix with entries declared as varying by the components
+		std::vector<Int> declaredVaryingColumns();
+		/// Solves the system with variable system matrix
+		virtual void solveWithSystemMatrixRecomputation(Real time, Int timeStepCount) override;
+		/// Solves with the factorization of a switch state
+		virtual Matrix solveSwitchedMatrix(const std::bitset<SWITCH_NUM>& status, Int freqIdx, const Matrix& rhs) override;
+		/// Drops the matrices and factorizations of all switch states
+		virtual void releaseSwitchedMatrices() override;
+
+	public:
+		/// Constructor should not be called by users but by Simulation
+		MnaSolverKLU(String name,
+			CPS::Domain domain = CPS::Domain::DP,
+			CPS::Logger::Level logLevel = CPS::Logger::Level::info);
+
+		/// Destructor
+		virtual ~MnaSolverKLU() {
+			if (mSystemMatrixRecomputation) {
+				mSLog->info("Number of refactorizations with new pivots: {:d}",
+					mKLUVariableSystemMatrix.numPivotUpdates());
+				mSLog->info("Number of refactorized columns: {:d}",
+					mKLUVariableSystemMatrix.numRefactorizedColumns());
+			}
+		};
+
+		/// Calls subroutines to set up everything that is required before simulation
+		virtual void initialize() override;
+	};
+}
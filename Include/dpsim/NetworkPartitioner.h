@@ -0,0 +1,65 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <cps/SystemTopology.h>
+#include <dpsim/Definitions.h>
+
+namespace DPsim {
+	/// Selects tear components for the diakoptics solver. The network nodes are partitioned
+	/// by multilevel recursive bisection (heavy edge matching, graph growing and
+	/// Fiduccia-Mattheyses refinement), so that the number of torn components is small and
+	/// the subnets have similar matrix sizes. Only components implementing MNATearInterface
+	/// are torn, nodes connected by other components always stay in the same subnet.
+	class NetworkPartitioner {
+	public:
+		/// Undirected graph in compressed sparse row format with vertex and edge weights
+		struct Graph {
+			std::vector<Int> offsets = {0};
+			std::vector<Int> adjacency;
+			std::vector<Int> edgeWeights;
+			std::vector<Int> vertexWeights;
+
+			Int size() const { return static_cast<Int>(vertexWeights.size()); }
+			Int totalWeight() const;
+
+			/// Builds a graph from undirected edges (u, v, weight), parallel edges are merged
+			static Graph fromEdges(std::vector<Int> vertexWeights, const std::vector<std::array<Int, 3>>& edges);
+		};
+
+		/// Number of subnets and allowed relative deviation of the subnet sizes from the mean
+		NetworkPartitioner(UInt parts, Real imbalance = 0.05) :
+			mParts(parts), mImbalance(imbalance) { }
+
+		/// Selects the tear components without changing the system
+		template <typename VarType>
+		CPS::IdentifiedObject::List selectTearComponents(const CPS::SystemTopology& system);
+		/// Selects the tear components and moves them from the components of the system to its tear components
+		template <typename VarType>
+		CPS::IdentifiedObject::List tear(CPS::SystemTopology& system);
+
+		/// Partitions the vertices of a graph into the given number of parts with minimal edge cut
+		std::vector<Int> partition(const Graph& graph, Int parts) const;
+
+		/// Matrix size of the subnets of the last selection
+		const std::vector<Int>& subnetSizes() const { return mSubnetSizes; }
+
+	private:
+		UInt mParts;
+		Real mImbalance;
+		std::vector<Int> mSubnetSizes;
+
+		void partitionRecursive(const Graph& graph, const std::vector<Int>& vertices,
+			Int parts, Int firstPart, Int maxVertexWeight, std::vector<Int>& result) const;
+		std::vector<Int> bisect(const Graph& graph, Real fraction, Int maxVertexWeight) const;
+	};
+}
@@ -22,6 +22,12 @@ namespace DPsim {
 
 	protected:
 		Timer mTimer;
+		/// Lock all pages of the process into memory before starting
+		Bool mLockMemory = false;
+		/// CPU of the simulation thread, -1 leaves it unpinned
+		Int mCpu = -1;
+		/// SCHED_FIFO priority of the simulation thread, 0 keeps the default policy
+		Int mRealTimePriority = 0;
 
 	public:
 		/// Standard constructor
@@ -36,6 +42,16 @@ namespace DPsim {
 		void run(const Timer::StartClock::time_point &startAt);
 
 		void run(Int startIn) { run(std::chrono::seconds(startIn)); }
+
+		/// Locks current and future pages of the process into memory to avoid page faults during the simulation
+		void doLockMemory(Bool value = true) { mLockMemory = value; }
+		/// Pins the simulation thread to a CPU and sets its real-time priority before the simulation
+		/// is initialized, so that the solver data is allocated on the NUMA node of the CPU.
+		/// Worker threads of parallel schedulers are placed by the scheduler.
+		void setThreadPlacement(Int cpu, Int realTimePriority = 0) {
+			mCpu = cpu;
+			mRealTimePriority = realTimePriority;
+		}
 	};
 }
 
@@ -11,12 +11,14 @@
 #include <cps/Task.h>
 
 #include <dpsim/Definitions.h>
+#include <dpsim/TaskTimeStatistics.h>
 #include <cps/Logger.h>
 
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
@@ -51,11 +53,45 @@ namespace DPsim {
 		virtual void step(Real time, Int timeStepCount) = 0;
 		/// Called on simulation stop to reliably clean up e.g. running helper threads
 		virtual void stop() {}
+		/// Groups of tasks that describe the created schedule, e.g. the tasks of each thread
+		/// in execution order. Used to store compiled schedules, returns false if the
+		/// scheduler does not support them.
+		virtual Bool exportSchedule(std::vector<CPS::Task::List>& groups) const { return false; }
+		/// Restores a schedule from the groups returned by exportSchedule instead of
+		/// creating it. The edges only connect the scheduled tasks.
+		virtual void importSchedule(const std::vector<CPS::Task::List>& groups, const Edges& inEdges, const Edges& outEdges) {
+			throw SchedulingException();
+		}
+		/// Settings that change the created schedule. Part of the key of compiled
+		/// schedules, so that they are not reused with another configuration.
+		virtual String configKey() const;
+		/// Name and content of a measurement file for configKey()
+		static String measurementFileKey(const String& filename);
 
 		/// Helper function that resolves the task-attribute dependencies to task-task dependencies
 		/// and inserts a root task
 		void resolveDeps(CPS::Task::List& tasks, Edges& inEdges, Edges& outEdges);
 
+		/// Options for merging cheap tasks into fused tasks
+		struct CoarseningConfig {
+			///
+			Bool enabled = false;
+			/// Maximum number of tasks in a fused task
+			UInt maxTasks = 32;
+			/// Maximum summed execution time of a fused task in ns. Only used with measurements.
+			TaskTime::rep maxCost = 10000;
+			/// Tasks with more dependencies or dependents (e.g. solver tasks) are not fused
+			UInt maxDegree = 8;
+			/// Measurement file with the execution times of the tasks.
+			/// Without measurements, all tasks below the degree limit are considered cheap.
+			String inMeasurementFile;
+		};
+
+		/// Graph transformation to be applied after resolveDeps that replaces chains
+		/// and groups of independent tasks on the same level by fused tasks.
+		/// Reduces the synchronization overhead of graphs with many tiny tasks.
+		void coarsenTasks(CPS::Task::List& tasks, Edges& inEdges, Edges& outEdges, const CoarseningConfig& config);
+
 		// Special attribute that can be returned in the modified attributes of a task
 		// to mark that this task has external side-effects (like logging / interfacing)
 		// and thus has to be executed even though it doesn't modify any attribute.
@@ -65,6 +101,11 @@ namespace DPsim {
 		TaskTime getAveragedMeasurement(CPS::Task::Ptr task) {
 			return getAveragedMeasurement(task.get());
 		}
+		/// Execution time statistics of a task including percentiles
+		TaskTimeStatistics::Summary getMeasurementStatistics(CPS::Task::Ptr task);
+		/// Selects the statistic that is read from measurement files to plan schedules,
+		/// e.g. a high percentile to plan for the tail cost instead of the mean
+		void setPlanningStatistic(TaskTimeStatistics::Statistic statistic) { mPlanningStatistic = statistic; }
 
 		/// Root task that has a dependency on the external attribute
 		/// which means that it should not be removed from the task graph
@@ -79,6 +120,25 @@ namespace DPsim {
 			}
 		};
 
+		/// Task that executes a group of tasks in sequence, created by coarsenTasks()
+		class FusedTask : public CPS::Task {
+		public:
+			typedef std::shared_ptr<FusedTask> Ptr;
+
+			FusedTask(const CPS::Task::List& tasks);
+
+			void execute(Real time, Int timeStepCount) {
+				for (auto& task : mTasks)
+					task->execute(time, timeStepCount);
+			}
+
+			/// Fused tasks in execution order
+			const CPS::Task::List& tasks() const { return mTasks; }
+
+		private:
+			CPS::Task::List mTasks;
+		};
+
 	protected:
 		/// Simple topological sort, filtering out tasks that do not need to be executed.
 		void topologicalSort(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges, CPS::Task::List& sortedTasks);
@@ -90,9 +150,11 @@ namespace DPsim {
 		/// Not thread-safe for multiple calls with same task, but should only
 		/// be called once for each task in each step anyway
 		void updateMeasurement(CPS::Task* task, TaskTime time);
-		/// Write measurement data to file
+		/// Write measurement data to file. Each line contains the task name followed by
+		/// mean, count, min, max, p50, p99 and p99.9 of the execution time in ns.
 		void writeMeasurements(CPS::String filename);
-		/// Read measurement data from file to use it for the scheduling
+		/// Read measurement data from file to use it for the scheduling.
+		/// Files that only contain the mean are supported as well.
 		void readMeasurements(CPS::String filename, std::unordered_map<CPS::String, TaskTime::rep>& measurements);
 		///
 		TaskTime getAveragedMeasurement(CPS::Task* task);
@@ -103,11 +165,128 @@ namespace DPsim {
 		CPS::Logger::Level mLogLevel;
 		/// Logger
 		CPS::Logger::Log mSLog;
+		/// Statistic used from measurement files
+		TaskTimeStatistics::Statistic mPlanningStatistic = TaskTimeStatistics::Statistic::Mean;
 	private:
-		// TODO more sophisticated measurement method might be necessary for
-		// longer simulations (risk of high memory requirements and integer
-		// overflow)
-		std::unordered_map<CPS::Task*, std::vector<TaskTime>> mMeasurements;
+		/// Execution time statistics with fixed memory per task. The map is filled
+		/// by initMeasurements, so concurrent updates do not modify it.
+		std::unordered_map<CPS::Task*, std::unique_ptr<TaskTimeStatistics>> mMeasurements;
+	};
+
+	/// Configures how threads wait in Barrier and Counter
+	struct WaitConfig {
+		/// Number of spin iterations with a pause instruction before a waiting thread blocks.
+		/// Negative values spin without ever blocking, which gives the lowest latency.
+		Int spinIterations = -1;
+		/// Measure the time spent spinning and blocked
+		Bool collectStatistics = false;
+	};
+
+	/// Time spent by threads waiting in Barrier and Counter
+	struct WaitStatistics {
+		/// Number of waits that did not return immediately
+		UInt numWaits = 0;
+		/// Number of waits that had to block
+		UInt numBlocked = 0;
+		std::chrono::nanoseconds spinTime {0};
+		std::chrono::nanoseconds blockTime {0};
+
+		WaitStatistics& operator+=(const WaitStatistics& other) {
+			numWaits += other.numWaits;
+			numBlocked += other.numBlocked;
+			spinTime += other.spinTime;
+			blockTime += other.blockTime;
+			return *this;
+		}
+	};
+
+	/// Adaptive waiting on an atomic integer: the thread spins for a bounded number of
+	/// iterations and then blocks in the kernel (using a futex on Linux) until notified.
+	class AdaptiveWait {
+	public:
+		void setConfig(const WaitConfig& config) { mConfig = config; }
+		const WaitConfig& config() const { return mConfig; }
+
+		/// Waits until done(word) holds. The word must be changed before notify() is called.
+		template<typename Predicate>
+		void wait(std::atomic<Int>& word, Predicate done) {
+			if (done(word.load(std::memory_order_acquire)))
+				return;
+
+			std::chrono::steady_clock::time_point start;
+			if (mConfig.collectStatistics)
+				start = std::chrono::steady_clock::now();
+
+			for (Int i = 0; mConfig.spinIterations < 0 || i < mConfig.spinIterations; i++) {
+				cpuRelax();
+				if (done(word.load(std::memory_order_acquire))) {
+					if (mConfig.collectStatistics)
+						addStatistics(std::chrono::steady_clock::now() - start, std::chrono::nanoseconds(0), false);
+					return;
+				}
+			}
+
+			std::chrono::steady_clock::time_point blockStart;
+			if (mConfig.collectStatistics)
+				blockStart = std::chrono::steady_clock::now();
+
+			while (true) {
+				// Registering as sleeper and rechecking the word is ordered against
+				// changing the word and checking for sleepers in notify()
+				mSleepers.fetch_add(1, std::memory_order_seq_cst);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				Int value = word.load(std::memory_order_acquire);
+				if (done(value)) {
+					mSleepers.fetch_sub(1, std::memory_order_relaxed);
+					break;
+				}
+				block(word, value);
+				mSleepers.fetch_sub(1, std::memory_order_relaxed);
+				if (done(word.load(std::memory_order_acquire)))
+					break;
+			}
+
+			if (mConfig.collectStatistics) {
+				auto end = std::chrono::steady_clock::now();
+				addStatistics(blockStart - start, end - blockStart, true);
+			}
+		}
+
+		/// Wakes up all threads blocked on the word
+		void notify(std::atomic<Int>& word) {
+			if (mConfig.spinIterations < 0)
+				return;
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (mSleepers.load(std::memory_order_relaxed) > 0)
+				wake(word);
+		}
+
+		WaitStatistics statistics() const {
+			std::lock_guard<std::mutex> lk(mStatisticsMutex);
+			return mStatistics;
+		}
+
+		/// Hints the processor that the thread is busy waiting
+		static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#elif defined(__aarch64__)
+			asm volatile("yield");
+#endif
+		}
+
+	private:
+		/// Blocks while the word has the given value, may return spuriously
+		static void block(std::atomic<Int>& word, Int value);
+		static void wake(std::atomic<Int>& word);
+		void addStatistics(std::chrono::nanoseconds spin, std::chrono::nanoseconds blocked, Bool didBlock);
+
+		WaitConfig mConfig;
+		/// Number of threads that are blocked or about to block
+		std::atomic<Int> mSleepers {0};
+
+		mutable std::mutex mStatisticsMutex;
+		WaitStatistics mStatistics;
 	};
 
 	/// A barrier is used to synchronize threads. Threads running into the barrier
@@ -149,8 +328,9 @@ namespace DPsim {
 				if (mCount.fetch_add(1, std::memory_order_acq_rel) == mLimit-1) {
 					mCount.store(0, std::memory_order_relaxed);
 					mGeneration.fetch_add(1, std::memory_order_release);
+					mWait.notify(mGeneration);
 				} else {
-					while (mGeneration.load(std::memory_order_acquire) == gen);
+					mWait.wait(mGeneration, [gen](Int g) { return g != gen; });
 				}
 			}
 		}
@@ -174,10 +354,16 @@ namespace DPsim {
 				if (mCount.fetch_add(1, std::memory_order_acquire) == mLimit-1) {
 					mCount.store(0, std::memory_order_relaxed);
 					mGeneration.fetch_add(1, std::memory_order_release);
+					mWait.notify(mGeneration);
 				}
 			}
 		}
 
+		/// Sets the spin and block behaviour if no condition variable is used
+		void setWaitConfig(const WaitConfig& config) { mWait.setConfig(config); }
+		///
+		WaitStatistics waitStatistics() const { return mWait.statistics(); }
+
 	private:
 		/// Barrier limit which has to be reached before the barrier is released.
 		Int mLimit;
@@ -189,6 +375,7 @@ namespace DPsim {
 
 		std::mutex mMutex;
 		std::condition_variable mCondition;
+		AdaptiveWait mWait;
 	};
 
 	class BarrierTask : public CPS::Task {
@@ -207,13 +394,22 @@ namespace DPsim {
 
 		void inc() {
 			mValue.fetch_add(1, std::memory_order_release);
+			mWait.notify(mValue);
 		}
 
 		void wait(Int value) {
-			while (mValue.load(std::memory_order_acquire) != value);
+			mWait.wait(mValue, [value](Int v) { return v == value; });
 		}
 
+		/// Sets the value, must not be called while other threads use the counter
+		void reset(Int value) { mValue.store(value, std::memory_order_relaxed); }
+
+		void setWaitConfig(const WaitConfig& config) { mWait.setConfig(config); }
+		///
+		WaitStatistics waitStatistics() const { return mWait.statistics(); }
+
 	private:
 		std::atomic<Int> mValue;
+		AdaptiveWait mWait;
 	};
 }
@@ -26,6 +26,8 @@ namespace DPsim {
 		void createSchedule(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges);
 		void step(Real time, Int timeStepCount);
 		void stop();
+		Bool exportSchedule(std::vector<CPS::Task::List>& groups) const;
+		void importSchedule(const std::vector<CPS::Task::List>& groups, const Edges& inEdges, const Edges& outEdges);
 
 	private:
 		CPS::Task::List mSchedule;
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "dpsim/MNASolverFactory.h"
+#include <cstdint>
 #include <vector>
 
 #include <dpsim/Config.h>
@@ -99,10 +100,37 @@ namespace DPsim {
 		Bool mInitFromNodesAndTerminals = true;
 		/// Enable recomputation of system matrix during simulation
 		Bool mSystemMatrixRecomputation = false;
+		/// Factorize switch states on demand instead of all upfront
+		Bool mSwitchedMatrixCaching = false;
+		/// Memory budget in bytes for cached switch states, zero means unbounded
+		std::size_t mSwitchedMatrixCacheBudget = 0;
+		/// Add only the rows of each component's nodes to the right side vector
+		Bool mSparseRightVectorAssembly = true;
+		/// Apply variable component changes as low-rank updates instead of refactorizing
+		Bool mLowRankUpdate = false;
+		/// Maximum rank of low-rank updates before refactorizing
+		UInt mLowRankUpdateMaxRank = 16;
+		/// Factorize in single precision and refine solutions in double precision
+		Bool mMixedPrecision = false;
+		/// Maximum number of refinement steps of mixed precision solves
+		UInt mMixedPrecisionRefinementSteps = 2;
+		/// Relative residual tolerance of mixed precision solves
+		Real mMixedPrecisionTolerance = 1e-10;
+
+		/// Stamp and factorize DP and SP system matrices in complex arithmetic
+		Bool mComplexSystemMatrix = false;
+		/// Further scenarios of the system that are solved together with it
+		std::vector<CPS::SystemTopology> mScenarios;
 
 		/// If tearing components exist, the Diakoptics
 		/// solver is selected automatically.
 		CPS::IdentifiedObject::List mTearComponents = CPS::IdentifiedObject::List();
+		/// Number of subnets for the automatic selection of tear components
+		UInt mAutomaticTearingSubnets = 0;
+		/// Solve the tear currents of the diakoptics solver along a nested dissection tree
+		Bool mNestedDiakoptics = false;
+		/// Replace lines with a propagation delay of at least one time step by decoupling lines
+		Bool mAutomaticDecoupling = false;
 		/// Determines if the system matrix is split into
 		/// several smaller matrices, one for each frequency.
 		/// This can only be done if the network is composed
@@ -125,6 +153,12 @@ namespace DPsim {
 		CPS::Task::List mTasks;
 		/// Task dependencies as incoming / outgoing edges
 		Scheduler::Edges mTaskInEdges, mTaskOutEdges;
+		/// Fusion of cheap tasks after dependency resolution
+		Scheduler::CoarseningConfig mTaskCoarsening;
+		/// File with the compiled schedule that is loaded if it matches the task graph
+		String mScheduleFile;
+		/// Write the logged values of each step while the next step is computed
+		Bool mPipelinedOutput = false;
 
 		struct InterfaceMapping {
 			/// A pointer to the external interface
@@ -154,8 +188,14 @@ namespace DPsim {
 		/// Subroutine for MNA only because there are many MNA options
 		template <typename VarType>
 		void createMNASolver();
+		/// Collect the tasks of solvers, interfaces and loggers
+		void collectTasks();
 		/// Prepare schedule for simulation
 		void prepSchedule();
+		/// Restore the schedule from the compiled schedule file if it matches the hash
+		Bool loadSchedule(std::uint64_t hash);
+		/// Write the created schedule to the compiled schedule file
+		void saveSchedule(std::uint64_t hash);
 
 	public:
 		/// Simulation logger
@@ -173,6 +213,11 @@ namespace DPsim {
 		// #### Simulation Settings ####
 		///
 		void setSystem(const CPS::SystemTopology &system) { mSystem = system; }
+		/// Stamp and factorize DP and SP system matrices in complex arithmetic
+		void doComplexSystemMatrix(Bool value) { mComplexSystemMatrix = value; }
+		/// Add a scenario of the system with its own component instances. Scenarios may differ
+		/// from the system in sources and switch events, but must share its system matrices.
+		void addScenario(const CPS::SystemTopology &scenario) { mScenarios.push_back(scenario); }
 		///
 		void setTimeStep(Real timeStep) { **mTimeStep = timeStep; }
 		///
@@ -193,14 +238,50 @@ namespace DPsim {
 		void setTearingComponents(CPS::IdentifiedObject::List tearComponents = CPS::IdentifiedObject::List()) {
 			mTearComponents = tearComponents;
 		}
+		/// Select tear components automatically, so that the diakoptics solver splits the
+		/// network into the given number of subnets with similar sizes (e.g. the number of threads)
+		void setAutomaticTearing(UInt subnets) { mAutomaticTearingSubnets = subnets; }
+		/// Split the subnets of the diakoptics solver recursively and reduce the tear
+		/// current system level by level in parallel tasks instead of a single solve
+		void doNestedDiakoptics(Bool value = true) { mNestedDiakoptics = value; }
+		/// Replace lines that are long enough for the time step by decoupling lines, so that
+		/// the network splits into subnets that are solved by separate MNA solvers
+		void doAutomaticDecoupling(Bool value = true) { mAutomaticDecoupling = value; }
 		/// Set the scheduling method
 		void setScheduler(const std::shared_ptr<Scheduler> &scheduler) {
 			mScheduler = scheduler;
 		}
+		/// Fuse chains and same-level groups of cheap tasks before scheduling
+		void doTaskCoarsening(Bool value = true) { mTaskCoarsening.enabled = value; }
+		///
+		void setTaskCoarsening(const Scheduler::CoarseningConfig& config) { mTaskCoarsening = config; }
+		/// Store the schedule in a file and skip the scheduling on later starts
+		/// as long as the tasks, their dependencies and the scheduler configuration are unchanged
+		void setScheduleFile(String filename) { mScheduleFile = filename; }
+		/// Copy the logged values at the end of a step and write them to the files
+		/// in parallel to the next step. The values are unchanged but written one step later.
+		void doPipelinedOutput(Bool value = true) { mPipelinedOutput = value; }
 		/// Compute phasors of different frequencies in parallel
 		void doFrequencyParallelization(Bool value) { mFreqParallel = value; }
 		///
 		void doSystemMatrixRecomputation(Bool value) { mSystemMatrixRecomputation = value; }
+		/// Factorize switch states on demand and keep them in an LRU cache
+		void doSwitchedMatrixCaching(Bool value) { mSwitchedMatrixCaching = value; }
+		/// Set the memory budget in bytes for cached switch states (per subnet with diakoptics)
+		void setSwitchedMatrixCacheBudget(std::size_t bytes) { mSwitchedMatrixCacheBudget = bytes; }
+		/// Add only the rows of each component's nodes to the right side vector
+		void doSparseRightVectorAssembly(Bool value) { mSparseRightVectorAssembly = value; }
+		/// Apply variable component changes as low-rank updates of the system matrix factorization
+		void doLowRankSystemMatrixUpdate(Bool value) { mLowRankUpdate = value; }
+		/// Set the rank above which the system matrix is refactorized instead
+		void setLowRankUpdateMaxRank(UInt rank) { mLowRankUpdateMaxRank = rank; }
+		/// Factorize in single precision and refine solutions in double precision
+		void doMixedPrecisionSolve(Bool value) { mMixedPrecision = value; }
+		/// Set the maximum number of refinement steps and the residual tolerance of mixed precision solves
+		void setMixedPrecisionRefinement(UInt steps, Real tolerance) {
+			mMixedPrecisionRefinementSteps = steps;
+			mMixedPrecisionTolerance = tolerance;
+		}
 
 		// #### Initialization ####
 		/// activate steady state initialization
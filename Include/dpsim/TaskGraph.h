@@ -0,0 +1,70 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <dpsim/Scheduler.h>
+
+namespace DPsim {
+	/// Compact integer indexed task graph. Successors and predecessors of all tasks
+	/// are stored in two contiguous arrays (compressed sparse row format), so graph
+	/// algorithms run in linear time without hashing or copying the edge maps.
+	class TaskGraph {
+	public:
+		/// Contiguous range of task indices
+		class Range {
+		public:
+			Range(const Int* begin, const Int* end) : mBegin(begin), mEnd(end) {}
+			const Int* begin() const { return mBegin; }
+			const Int* end() const { return mEnd; }
+			size_t size() const { return mEnd - mBegin; }
+			Bool empty() const { return mBegin == mEnd; }
+		private:
+			const Int* mBegin;
+			const Int* mEnd;
+		};
+
+		TaskGraph() = default;
+		/// Builds the graph from the outgoing edges. Edges from or to tasks that are not
+		/// in the list are ignored. Duplicate edges are kept unless removeDuplicates is set.
+		TaskGraph(const CPS::Task::List& tasks, const Scheduler::Edges& outEdges, Bool removeDuplicates = false);
+
+		Int size() const { return static_cast<Int>(mTasks.size()); }
+		/// Index of a task or -1 if it is not in the graph
+		Int index(const CPS::Task* task) const {
+			auto it = mIndex.find(task);
+			return it == mIndex.end() ? -1 : it->second;
+		}
+		const CPS::Task::Ptr& task(Int idx) const { return mTasks[idx]; }
+		const CPS::Task::List& tasks() const { return mTasks; }
+
+		Range successors(Int idx) const {
+			return Range(mSuccessors.data() + mSuccessorOffsets[idx], mSuccessors.data() + mSuccessorOffsets[idx+1]);
+		}
+		Range predecessors(Int idx) const {
+			return Range(mPredecessors.data() + mPredecessorOffsets[idx], mPredecessors.data() + mPredecessorOffsets[idx+1]);
+		}
+		/// Number of edges
+		size_t numEdges() const { return mSuccessors.size(); }
+
+		/// Marks the tasks from which the given task can be reached, including itself
+		std::vector<Bool> ancestors(Int idx) const;
+		/// Topological order of all tasks (Kahn's algorithm with FIFO order).
+		/// Throws a SchedulingException if the graph contains a cycle.
+		std::vector<Int> topologicalOrder() const;
+
+	private:
+		CPS::Task::List mTasks;
+		std::unordered_map<const CPS::Task*, Int> mIndex;
+		std::vector<Int> mSuccessorOffsets, mSuccessors;
+		std::vector<Int> mPredecessorOffsets, mPredecessors;
+	};
+}
@@ -0,0 +1,75 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <dpsim/Definitions.h>
+
+namespace DPsim {
+	/// Online statistics of task execution times with fixed memory usage.
+	/// Besides count, mean, minimum and maximum, the times are recorded in a histogram
+	/// with logarithmic buckets that are linearly subdivided (as in HDR histograms),
+	/// which gives percentiles with a relative error below 1/(2 * SubBuckets).
+	/// Updates are lock-free and may be called concurrently from multiple threads.
+	class TaskTimeStatistics {
+	public:
+		typedef std::chrono::steady_clock::duration TaskTime;
+
+		/// Linear subdivisions of each power of two
+		static constexpr Int SubBucketBits = 4;
+		static constexpr Int SubBuckets = 1 << SubBucketBits;
+		/// Times up to 2^MaxExponent ns (about 68 s) are resolved, longer times are clamped
+		static constexpr Int MaxExponent = 36;
+		static constexpr Int NumBuckets = (MaxExponent - SubBucketBits + 1) * SubBuckets;
+
+		/// Statistics that can be used to plan schedules
+		enum class Statistic { Mean, Median, P99, P999, Max };
+
+		/// Copy of the statistics
+		struct Summary {
+			std::uint64_t count = 0;
+			TaskTime mean {0};
+			TaskTime min {0};
+			TaskTime max {0};
+			TaskTime p50 {0};
+			TaskTime p99 {0};
+			TaskTime p999 {0};
+
+			TaskTime get(Statistic statistic) const;
+		};
+
+		TaskTimeStatistics();
+
+		/// Records an execution time
+		void update(TaskTime time);
+		/// Computes the summary including the percentiles
+		Summary summary() const;
+		/// Percentile between 0 and 1 estimated from the histogram
+		TaskTime percentile(Real fraction) const;
+
+		/// Parses "mean", "median" (or "p50"), "p99", "p999" (or "p99.9") and "max",
+		/// e.g. to select the planning statistic of a scheduler from a command line option
+		static Statistic parseStatistic(const String& name);
+
+	private:
+		static Int bucketIndex(std::uint64_t ns);
+		/// Midpoint of the values recorded in a bucket
+		static std::uint64_t bucketValue(Int index);
+
+		std::atomic<std::uint64_t> mCount {0};
+		std::atomic<std::uint64_t> mSum {0};
+		std::atomic<std::uint64_t> mMin;
+		std::atomic<std::uint64_t> mMax {0};
+		std::array<std::atomic<std::uint32_t>, NumBuckets> mBuckets;
+	};
+}
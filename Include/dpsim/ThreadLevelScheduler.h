@@ -16,6 +16,10 @@ namespace DPsim {
 		ThreadLevelScheduler(Int threads = 1, String outMeasurementFile = String(), String inMeasurementFile = String(), Bool useConditionVariables = false, Bool sortTaskTypes = false);
 
 		void createSchedule(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges);
+		String configKey() const;
+
+	protected:
+		void assignTasks(const std::unordered_map<String, TaskTime::rep>& costs);
 
 	private:
 		void scheduleLevel(const CPS::Task::List& tasks, const std::unordered_map<String, TaskTime::rep>& measurements, const Edges& inEdges);
@@ -16,8 +16,36 @@ namespace DPsim {
 		ThreadListScheduler(Int threads = 1, String outMeasurementFile = String(), String inMeasurementFile = String(), Bool useConditionVariables = false);
 
 		void createSchedule(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges);
+		String configKey() const;
+
+		/// Cost model for placing each task on the thread where it finishes earliest (HEFT)
+		/// instead of the least loaded thread. All costs are in ns.
+		struct CommunicationModel {
+			///
+			Bool enabled = false;
+			/// Cost of a dependency between tasks on different threads
+			/// (cache line transfers of the shared attributes and waiting on the counter)
+			TaskTime::rep edgeCost = 300;
+			/// Cost of running a task on another thread than the previous task of the same
+			/// component, since the component state has to be moved to the other core
+			TaskTime::rep componentCost = 200;
+			/// Cost of each task if no measurement file is given
+			TaskTime::rep taskCost = 1000;
+		};
+		/// Must be called before the schedule is created
+		void setCommunicationModel(const CommunicationModel& model) { mCommunication = model; }
+
+	protected:
+		void assignTasks(const std::unordered_map<String, TaskTime::rep>& costs);
 
 	private:
+		/// Assigns the tasks by the HLFET heuristic with the given costs
+		void scheduleList(const CPS::Task::List& ordered, const Edges& outEdges, const std::unordered_map<String, TaskTime::rep>& costs);
+		/// Assigns the tasks in the order of their upward ranks to the thread with the
+		/// earliest finish time according to the communication model
+		void scheduleEarliestFinish(const CPS::Task::List& ordered, const Edges& outEdges, const std::unordered_map<String, TaskTime::rep>& costs);
+
 		String mInMeasurementFile;
+		CommunicationModel mCommunication;
 	};
 };
@@ -0,0 +1,65 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <thread>
+#include <vector>
+
+#include <dpsim/Definitions.h>
+
+namespace DPsim {
+	/// Placement of threads on CPUs
+	struct ThreadPlacementConfig {
+		/// CPU of each thread in order of the thread index. Threads are
+		/// distributed round-robin if there are fewer CPUs than threads.
+		/// An empty list leaves the threads unpinned.
+		std::vector<Int> cpus;
+		/// Only use cores isolated from the kernel scheduler (isolcpus).
+		/// If no CPUs are given, all isolated cores are used.
+		Bool isolatedCores = false;
+		/// SCHED_FIFO priority of the threads, 0 keeps the default scheduling policy
+		Int realTimePriority = 0;
+
+		Bool enabled() const { return !cpus.empty() || isolatedCores || realTimePriority > 0; }
+	};
+
+	namespace ThreadPlacement {
+		/// Affinity and scheduling policy of a thread before it was placed
+		struct State {
+			/// CPUs the thread may run on, empty if unknown
+			std::vector<Int> cpus;
+			Int policy = 0;
+			Int priority = 0;
+		};
+
+		/// Parses a CPU list like "0-3,8,10-11" as used by the kernel and taskset
+		std::vector<Int> parseCpuList(const String& list);
+		/// Cores isolated from the kernel scheduler
+		std::vector<Int> isolatedCpus();
+		/// NUMA node of a CPU or -1 if unknown
+		Int numaNode(Int cpu);
+		/// CPU of each of the threads for the given configuration, -1 for unpinned threads
+		std::vector<Int> assignCpus(const ThreadPlacementConfig& config, Int numThreads);
+		/// Pins the calling thread to a CPU and sets its scheduling policy. The change outlives
+		/// the simulation, so save the state before and restore it with restoreCurrentThread().
+		/// Memory is not bound to NUMA nodes explicitly, with the first-touch policy of Linux
+		/// the pages the thread touches first are allocated on the NUMA node of the CPU.
+		void applyToCurrentThread(Int cpu, Int realTimePriority);
+		/// Affinity and scheduling policy of the calling thread
+		State currentThreadState();
+		/// Restores the affinity and scheduling policy of the calling thread
+		void restoreCurrentThread(const State& state);
+		/// Pins another thread to a CPU and sets its scheduling policy
+		void applyToThread(std::thread& thread, Int cpu, Int realTimePriority);
+		/// Locks current and future pages of the process into memory
+		void lockMemory();
+		/// Describes the CPU and NUMA node of a thread for logging
+		String describe(Int thread, Int cpu);
+	}
+}
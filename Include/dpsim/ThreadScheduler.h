@@ -9,8 +9,10 @@
 #pragma once
 
 #include <dpsim/Scheduler.h>
+#include <dpsim/ThreadPlacement.h>
 
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace DPsim {
@@ -21,19 +23,75 @@ namespace DPsim {
 
 		void step(Real time, Int timeStepCount);
 		virtual void stop();
+		/// The groups are the tasks of each thread in execution order
+		Bool exportSchedule(std::vector<CPS::Task::List>& groups) const;
+		void importSchedule(const std::vector<CPS::Task::List>& groups, const Edges& inEdges, const Edges& outEdges);
+		String configKey() const;
+
+		/// Sets how threads wait for each other, must be called before the schedule is created
+		void setWaitConfig(const WaitConfig& config);
+		/// Pins the threads to CPUs, must be called before the schedule is created.
+		/// Thread 0 is the thread that calls step(), its previous placement is restored in stop().
+		void setThreadPlacement(const ThreadPlacementConfig& config) { mThreadPlacement = config; }
+		/// Accumulated waiting times of all threads
+		WaitStatistics waitStatistics() const;
+
+		/// Options for rebuilding the thread assignment from costs measured during the simulation
+		struct AdaptiveConfig {
+			///
+			Bool enabled = false;
+			/// Number of steps over which the task costs are averaged before the schedule is checked
+			UInt interval = 1000;
+			/// Check the schedule after every interval instead of only after the first one
+			Bool continuous = false;
+			/// Minimum relative reduction of the estimated makespan to replace the schedule
+			Real threshold = 0.1;
+		};
+		/// Rebuilds the schedule at step boundaries if the measured costs are imbalanced,
+		/// must be called before the schedule is created
+		void setAdaptiveScheduling(const AdaptiveConfig& config) { mAdaptive = config; }
 
 	protected:
 		void finishSchedule(const Edges& inEdges);
 		void scheduleTask(int thread, CPS::Task::Ptr task);
+		/// Keeps the scheduled tasks in topological order and their edges for adaptive scheduling
+		void setTaskGraph(const CPS::Task::List& ordered, const Edges& inEdges, const Edges& outEdges);
+		/// Distributes the tasks of the stored task graph with scheduleTask() based on the
+		/// given costs. Used to rebuild the schedule during the simulation.
+		virtual void assignTasks(const std::unordered_map<String, TaskTime::rep>& costs) {}
 
 		Int mNumThreads;
+		String mOutMeasurementFile;
+		/// Scheduled tasks in topological order, only stored for adaptive scheduling
+		CPS::Task::List mOrdered;
+		Edges mInEdges, mOutEdges;
 
 	private:
 		void doStep(Int scheduleIdx);
 		static void threadFunction(ThreadScheduler* sched, Int idx);
+		/// Creates the schedule entries of all threads with counters at the given value
+		void createEntries(const Edges& inEdges, Int counterValue);
+		/// Reassigns the tasks based on the costs of the last interval if this reduces the makespan
+		void rebalance();
+		/// Makespan of a thread assignment with the given costs, including the waiting for dependencies
+		TaskTime::rep estimateMakespan(const std::vector<CPS::Task::List>& schedules, const std::unordered_map<String, TaskTime::rep>& costs) const;
 
-		String mOutMeasurementFile;
 		Barrier mStartBarrier;
+		/// Signaled by the helper threads after their last task while costs are measured
+		/// for adaptive scheduling, so that the main thread can replace the schedule entries
+		Barrier mEndBarrier;
+		WaitConfig mWaitConfig;
+		ThreadPlacementConfig mThreadPlacement;
+		/// Placement of the thread that calls step() before it was pinned
+		ThreadPlacement::State mCallerPlacement;
+		Bool mCallerPlaced = false;
+		AdaptiveConfig mAdaptive;
+		/// Steps in the current measurement interval
+		UInt mIntervalSteps = 0;
+		/// Costs are measured for adaptive scheduling
+		Bool mMeasureInterval = false;
+		/// Wait statistics of replaced schedule entries
+		WaitStatistics mReplacedWaitStatistics;
 
 		std::vector<std::thread> mThreads;
 
@@ -42,6 +100,8 @@ namespace DPsim {
 			CPS::Task* task;
 			Counter endCounter;
 			std::vector<Counter*> reqCounters;
+			/// Summed execution time in the current measurement interval
+			TaskTime::rep intervalTime = 0;
 		};
 		std::vector<ScheduleEntry*> mSchedules;
 
@@ -0,0 +1,111 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <dpsim/Scheduler.h>
+#include <dpsim/ThreadPlacement.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace DPsim {
+	/// Executes the task graph dynamically: each thread runs ready tasks from its own deque
+	/// and steals from the other threads when it runs out of work. A task becomes ready
+	/// when the dependency counter, which is reset at the start of every step, reaches zero.
+	class WorkStealingScheduler : public Scheduler {
+	public:
+		WorkStealingScheduler(Int threads = 1, String outMeasurementFile = String(), Bool useConditionVariable = false);
+		virtual ~WorkStealingScheduler();
+
+		void createSchedule(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges);
+		void step(Real time, Int timeStepCount);
+		void stop();
+		Bool exportSchedule(std::vector<CPS::Task::List>& groups) const;
+		void importSchedule(const std::vector<CPS::Task::List>& groups, const Edges& inEdges, const Edges& outEdges);
+
+		/// Number of tasks that were stolen from other threads
+		UInt numSteals() const;
+		/// Sets how threads wait at the start and end of each step
+		void setWaitConfig(const WaitConfig& config);
+		/// Pins the threads to CPUs, must be called before the schedule is created.
+		/// Thread 0 is the thread that calls step(), its previous placement is restored in stop().
+		void setThreadPlacement(const ThreadPlacementConfig& config) { mThreadPlacement = config; }
+		/// Accumulated waiting times at the start and end of each step
+		WaitStatistics waitStatistics() const;
+
+	private:
+		/// Fixed-capacity work-stealing deque of task indices. The owner pushes and pops
+		/// at the bottom, other threads steal from the top. Each task is pushed at most
+		/// once per step, so the capacity never has to grow and the indices never wrap.
+		class TaskDeque {
+		public:
+			void resize(Int capacity);
+			/// Empties the deque, must only be called while no thread accesses it
+			void reset();
+			/// Called by the owner thread only
+			void push(Int task);
+			/// Called by the owner thread only, returns -1 if the deque is empty
+			Int pop();
+			/// Returns -1 if the deque is empty or another thread took the task
+			Int steal();
+
+		private:
+			std::atomic<Int> mTop;
+			std::atomic<Int> mBottom;
+			std::unique_ptr<std::atomic<Int>[]> mBuffer;
+		};
+
+		/// Per-thread state, aligned to avoid false sharing between the threads
+		struct alignas(64) Worker {
+			TaskDeque deque;
+			/// Ready tasks assigned to this thread at the start of each step
+			std::vector<Int> initialTasks;
+			/// Number of stolen tasks
+			std::atomic<UInt> numSteals;
+		};
+
+		/// Builds the task arrays from the tasks in topological order and starts the threads
+		void initSchedule(const CPS::Task::List& ordered, const Edges& outEdges);
+		void joinThreads();
+		void doStep(Int thread);
+		void execute(Int thread, Int task);
+		Int findTask(Int thread);
+		static void threadFunction(WorkStealingScheduler* sched, Int idx);
+
+		Int mNumThreads;
+		String mOutMeasurementFile;
+		Barrier mStartBarrier;
+		/// Signaled by the helper threads after their last task, waited for by the main thread
+		Barrier mEndBarrier;
+		WaitConfig mWaitConfig;
+		ThreadPlacementConfig mThreadPlacement;
+		/// Placement of the thread that calls step() before it was pinned
+		ThreadPlacement::State mCallerPlacement;
+		Bool mCallerPlaced = false;
+
+		std::vector<std::thread> mThreads;
+		std::unique_ptr<Worker[]> mWorkers;
+
+		/// Tasks in topological order
+		CPS::Task::List mTasks;
+		/// Number of predecessors of each task
+		std::vector<Int> mNumDependencies;
+		/// Successors of each task
+		std::vector<std::vector<Int>> mSuccessors;
+		/// Remaining unfinished predecessors of each task in the current step
+		std::unique_ptr<std::atomic<Int>[]> mPendingDependencies;
+		/// Remaining unfinished tasks in the current step
+		std::atomic<Int> mRemainingTasks;
+
+		Bool mJoining = false;
+		Real mTime = 0;
+		Int mTimeStepCount = 0;
+	};
+}
@@ -0,0 +1,522 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <Eigen/OrderingMethods>
+
+#include <dpsim/BTFSparseLU.h>
+
+using namespace DPsim;
+
+namespace {
+	/// Depth-first search in the graph of the lower factor starting at a row of the
+	/// current column. Appends the visited rows to reach[top..] in topological order.
+	Int reachFrom(const std::vector<Int>& Lp, const std::vector<Int>& Li, const std::vector<Int>& pinv,
+		Int start, Int top, std::vector<Int>& reach, std::vector<Int>& stack,
+		std::vector<Int>& stackPos, std::vector<Bool>& marked) {
+
+		Int head = 0;
+		stack[0] = start;
+		while (head >= 0) {
+			Int j = stack[head];
+			Int J = pinv[j];
+			if (!marked[j]) {
+				marked[j] = true;
+				stackPos[head] = J < 0 ? 0 : Lp[J];
+			}
+			Bool done = true;
+			Int end = J < 0 ? 0 : Lp[J + 1];
+			for (Int p = stackPos[head]; p < end; ++p) {
+				Int i = Li[p];
+				if (marked[i])
+					continue;
+				stackPos[head] = p + 1;
+				stack[++head] = i;
+				done = false;
+				break;
+			}
+			if (done) {
+				--head;
+				reach[--top] = j;
+			}
+		}
+		return top;
+	}
+}
+
+void BTFSparseLU::analyzePattern(const SparseMatrix& mat, const std::vector<Int>& varyingColumns) {
+	SparseMatrix rows = mat;
+	rows.makeCompressed();
+	CPS::SparseMatrix cols = rows;
+	cols.makeCompressed();
+	Int n = rows.rows();
+	mSize = n;
+
+	const Int* rowOuter = rows.outerIndexPtr();
+	const Int* rowInner = rows.innerIndexPtr();
+	const Int* colOuter = cols.outerIndexPtr();
+	const Int* colInner = cols.innerIndexPtr();
+	mInputOuter.assign(rowOuter, rowOuter + n + 1);
+	mInputInner.assign(rowInner, rowInner + rows.nonZeros());
+
+	mVaryingColumns.assign(n, false);
+	for (auto col : varyingColumns)
+		mVaryingColumns[col] = true;
+	mHasNewVaryingColumns = false;
+
+	// Maximum transversal: assign a row with a structural non-zero to every column
+	std::vector<Int> rowMatch(n, -1), colMatch(n, -1);
+	for (Int j = 0; j < n; ++j) {
+		for (Int p = colOuter[j]; p < colOuter[j + 1]; ++p) {
+			if (rowMatch[colInner[p]] < 0) {
+				rowMatch[colInner[p]] = j;
+				colMatch[j] = colInner[p];
+				break;
+			}
+		}
+	}
+	std::vector<Int> visited(n, -1), stackCol(n), stackRow(n), stackPos(n);
+	for (Int j0 = 0; j0 < n; ++j0) {
+		if (colMatch[j0] >= 0)
+			continue;
+		// Search an augmenting path starting at the unmatched column
+		Int head = 0;
+		stackCol[0] = j0;
+		stackPos[0] = colOuter[j0];
+		Bool found = false;
+		while (head >= 0 && !found) {
+			Int j = stackCol[head];
+			Bool pushed = false;
+			for (Int p = stackPos[head]; p < colOuter[j + 1]; ++p) {
+				Int i = colInner[p];
+				if (visited[i] == j0)
+					continue;
+				visited[i] = j0;
+				stackPos[head] = p + 1;
+				stackRow[head] = i;
+				if (rowMatch[i] < 0) {
+					found = true;
+				} else {
+					++head;
+					stackCol[head] = rowMatch[i];
+					stackPos[head] = colOuter[rowMatch[i]];
+					pushed = true;
+				}
+				break;
+			}
+			if (!found && !pushed)
+				--head;
+		}
+		if (!found)
+			throw CPS::SystemError("Structurally singular system matrix.");
+		for (Int h = head; h >= 0; --h) {
+			colMatch[stackCol[h]] = stackRow[h];
+			rowMatch[stackRow[h]] = stackCol[h];
+		}
+	}
+
+	// Strongly connected components of the graph in which the equation
+	// of each column refers to the other columns of its matched row (Tarjan)
+	std::vector<Int> index(n, -1), low(n, 0), edgePos(n, 0);
+	std::vector<Bool> onStack(n, false);
+	std::vector<Int> sccStack, callStack, components, componentStart;
+	Int counter = 0;
+	for (Int s = 0; s < n; ++s) {
+		if (index[s] >= 0)
+			continue;
+		index[s] = low[s] = counter++;
+		edgePos[s] = rowOuter[colMatch[s]];
+		sccStack.push_back(s);
+		onStack[s] = true;
+		callStack.push_back(s);
+		while (!callStack.empty()) {
+			Int v = callStack.back();
+			if (edgePos[v] < rowOuter[colMatch[v] + 1]) {
+				Int w = rowInner[edgePos[v]++];
+				if (index[w] < 0) {
+					index[w] = low[w] = counter++;
+					edgePos[w] = rowOuter[colMatch[w]];
+					sccStack.push_back(w);
+					onStack[w] = true;
+					callStack.push_back(w);
+				} else if (onStack[w]) {
+					low[v] = std::min(low[v], index[w]);
+				}
+			} else {
+				callStack.pop_back();
+				if (!callStack.empty())
+					low[callStack.back()] = std::min(low[callStack.back()], low[v]);
+				if (low[v] == index[v]) {
+					componentStart.push_back(components.size());
+					Int w;
+					do {
+						w = sccStack.back();
+						sccStack.pop_back();
+						onStack[w] = false;
+						components.push_back(w);
+					} while (w != v);
+				}
+			}
+		}
+	}
+	componentStart.push_back(components.size());
+
+	// Components are found in reverse topological order, which makes the
+	// last found component the first block of the upper block triangular form
+	mColPerm.clear();
+	mRowPerm.clear();
+	mBlocks.clear();
+	std::vector<Int> localIndex(n, -1);
+	for (Int c = componentStart.size() - 2; c >= 0; --c) {
+		Block block;
+		block.start = mColPerm.size();
+		block.size = componentStart[c + 1] - componentStart[c];
+		std::vector<Int> blockCols(components.begin() + componentStart[c], components.begin() + componentStart[c + 1]);
+
+		// Fill-reducing ordering of the block with matched rows on the diagonal
+		if (block.size > 2) {
+			for (Int l = 0; l < block.size; ++l)
+				localIndex[blockCols[l]] = l;
+			std::vector<Eigen::Triplet<Real>> entries;
+			for (Int l = 0; l < block.size; ++l) {
+				Int row = colMatch[blockCols[l]];
+				for (Int p = rowOuter[row]; p < rowOuter[row + 1]; ++p)
+					if (localIndex[rowInner[p]] >= 0)
+						entries.emplace_back(l, localIndex[rowInner[p]], 1);
+			}
+			for (Int l = 0; l < block.size; ++l)
+				localIndex[blockCols[l]] = -1;
+			CPS::SparseMatrix blockPattern(block.size, block.size);
+			blockPattern.setFromTriplets(entries.begin(), entries.end());
+
+			Eigen::AMDOrdering<Int> ordering;
+			Eigen::AMDOrdering<Int>::PermutationType perm;
+			ordering(blockPattern, perm);
+			std::vector<Int> ordered(block.size);
+			for (Int l = 0; l < block.size; ++l)
+				ordered[l] = blockCols[perm.indices()(l)];
+			blockCols = ordered;
+		}
+
+		// Varying columns last, so that their changes only affect the trailing part of the factors
+		std::stable_partition(blockCols.begin(), blockCols.end(),
+			[this](Int col) { return !mVaryingColumns[col]; });
+
+		for (auto col : blockCols) {
+			mColPerm.push_back(col);
+			mRowPerm.push_back(colMatch[col]);
+		}
+		mBlocks.push_back(block);
+	}
+
+	// Column-wise pattern of the permuted matrix and position of every input value in it
+	std::vector<Int> rowInv(n);
+	mColumnPosition.assign(n, 0);
+	for (Int i = 0; i < n; ++i) {
+		rowInv[mRowPerm[i]] = i;
+		mColumnPosition[mColPerm[i]] = i;
+	}
+	mColumnBlock.assign(n, 0);
+	for (UInt b = 0; b < mBlocks.size(); ++b)
+		for (Int k = 0; k < mBlocks[b].size; ++k)
+			mColumnBlock[mBlocks[b].start + k] = b;
+
+	std::vector<std::vector<std::pair<Int, Int>>> permutedCols(n);
+	for (Int r = 0; r < n; ++r)
+		for (Int p = rowOuter[r]; p < rowOuter[r + 1]; ++p)
+			permutedCols[mColumnPosition[rowInner[p]]].push_back({ rowInv[r], p });
+
+	mPermutedOuter.assign(1, 0);
+	mPermutedInner.clear();
+	mValueMap.assign(rows.nonZeros(), 0);
+	mDiagonalBlockStart.assign(n, 0);
+	for (Int j = 0; j < n; ++j) {
+		std::sort(permutedCols[j].begin(), permutedCols[j].end());
+		Int blockStart = mBlocks[mColumnBlock[j]].start;
+		mDiagonalBlockStart[j] = mPermutedOuter.back() + permutedCols[j].size();
+		for (auto entry : permutedCols[j]) {
+			if (entry.first >= blockStart)
+				mDiagonalBlockStart[j] = std::min<Int>(mDiagonalBlockStart[j], mPermutedInner.size());
+			mValueMap[entry.second] = mPermutedInner.size();
+			mPermutedInner.push_back(entry.first);
+		}
+		mPermutedOuter.push_back(mPermutedInner.size());
+	}
+	mPermutedValues.assign(mPermutedInner.size(), 0);
+
+	Int maxBlockSize = 0;
+	for (auto& block : mBlocks)
+		maxBlockSize = std::max(maxBlockSize, block.size);
+	mBlockWork.assign(maxBlockSize, 0);
+	mSolveWork.assign(n, 0);
+	mChangedColumns.assign(n, false);
+
+	mAnalysisIsOk = true;
+	mFactorizationIsOk = false;
+}
+
+Bool BTFSparseLU::hasAnalyzedPattern(const SparseMatrix& mat) const {
+	if (!mAnalysisIsOk || mat.rows() != mSize || !mat.isCompressed()
+		|| mat.nonZeros() != static_cast<Int>(mInputInner.size()))
+		return false;
+	return std::equal(mInputOuter.begin(), mInputOuter.end(), mat.outerIndexPtr())
+		&& std::equal(mInputInner.begin(), mInputInner.end(), mat.innerIndexPtr());
+}
+
+void BTFSparseLU::permuteValues(const SparseMatrix& mat) {
+	const Real* values = mat.valuePtr();
+	for (UInt p = 0; p < mValueMap.size(); ++p)
+		mPermutedValues[mValueMap[p]] = values[p];
+}
+
+void BTFSparseLU::factorizeBlock(Block& block) {
+	Int n = block.size;
+	block.Lp.assign(1, 0);
+	block.Li.clear();
+	block.Lx.clear();
+	block.Up.assign(1, 0);
+	block.Ui.clear();
+	block.Ux.clear();
+	block.pinv.assign(n, -1);
+
+	std::vector<Real>& x = mBlockWork;
+	std::vector<Int> reach(n), stack(n), stackPos(n);
+	std::vector<Bool> marked(n, false);
+
+	for (Int k = 0; k < n; ++k) {
+		Int col = block.start + k;
+
+		// Non-zero pattern of L \ A(:,k) in topological order
+		Int top = n;
+		for (Int p = mDiagonalBlockStart[col]; p < mPermutedOuter[col + 1]; ++p) {
+			Int i = mPermutedInner[p] - block.start;
+			if (!marked[i])
+				top = reachFrom(block.Lp, block.Li, block.pinv, i, top, reach, stack, stackPos, marked);
+		}
+		for (Int p = mDiagonalBlockStart[col]; p < mPermutedOuter[col + 1]; ++p)
+			x[mPermutedInner[p] - block.start] = mPermutedValues[p];
+
+		// Left-looking update with the columns of L computed so far
+		for (Int p = top; p < n; ++p) {
+			Int j = reach[p];
+			Int J = block.pinv[j];
+			if (J < 0)
+				continue;
+			Real ujk = x[j];
+			for (Int q = block.Lp[J]; q < block.Lp[J + 1]; ++q)
+				x[block.Li[q]] -= block.Lx[q] * ujk;
+		}
+
+		// Partial pivoting that prefers the diagonal entry to keep the ordering
+		Int pivotRow = -1;
+		Real maxAbs = 0;
+		for (Int p = top; p < n; ++p) {
+			Int i = reach[p];
+			if (block.pinv[i] < 0) {
+				if (std::abs(x[i]) > maxAbs) {
+					maxAbs = std::abs(x[i]);
+					pivotRow = i;
+				}
+			} else {
+				block.Ui.push_back(block.pinv[i]);
+				block.Ux.push_back(x[i]);
+			}
+		}
+		if (pivotRow < 0)
+			throw CPS::SystemError("Numerically singular system matrix.");
+		if (block.pinv[k] < 0 && std::abs(x[k]) >= mPivotTolerance * maxAbs)
+			pivotRow = k;
+
+		Real pivot = x[pivotRow];
+		block.Ui.push_back(k);
+		block.Ux.push_back(pivot);
+		block.Up.push_back(block.Ui.size());
+		block.pinv[pivotRow] = k;
+
+		for (Int p = top; p < n; ++p) {
+			Int i = reach[p];
+			if (block.pinv[i] < 0) {
+				block.Li.push_back(i);
+				block.Lx.push_back(x[i] / pivot);
+			}
+			x[i] = 0;
+			marked[i] = false;
+		}
+		block.Lp.push_back(block.Li.size());
+	}
+
+	// Store the rows of L in pivot order
+	for (auto& i : block.Li)
+		i = block.pinv[i];
+}
+
+void BTFSparseLU::updateValues(const SparseMatrix& mat) {
+	const Real* values = mat.valuePtr();
+	for (UInt p = 0; p < mValueMap.size(); ++p) {
+		Int pos = mValueMap[p];
+		if (mPermutedValues[pos] == values[p])
+			continue;
+		mPermutedValues[pos] = values[p];
+		// Entries left of the diagonal block are only needed for the solve
+		Int col = mColumnPosition[mInputInner[p]];
+		if (pos >= mDiagonalBlockStart[col])
+			mChangedColumns[col] = true;
+	}
+}
+
+Bool BTFSparseLU::refactorizeBlock(Block& block) {
+	std::vector<Real>& x = mBlockWork;
+
+	for (Int k = 0; k < block.size; ++k) {
+		Int col = block.start + k;
+		Int diag = block.Up[k + 1] - 1;
+
+		// Column k of the factors only changes with its own values or
+		// with the columns of L it is updated with
+		for (Int q = block.Up[k]; q < diag && !mChangedColumns[col]; ++q)
+			mChangedColumns[col] = mChangedColumns[block.start + block.Ui[q]];
+		if (!mChangedColumns[col])
+			continue;
+		++mNumRefactorizedColumns;
+
+		for (Int p = mDiagonalBlockStart[col]; p < mPermutedOuter[col + 1]; ++p)
+			x[block.pinv[mPermutedInner[p] - block.start]] = mPermutedValues[p];
+
+		// The entries of U are stored in topological order, diagonal last
+		for (Int q = block.Up[k]; q < diag; ++q) {
+			Int J = block.Ui[q];
+			Real ujk = x[J];
+			block.Ux[q] = ujk;
+			x[J] = 0;
+			for (Int r = block.Lp[J]; r < block.Lp[J + 1]; ++r)
+				x[block.Li[r]] -= block.Lx[r] * ujk;
+		}
+
+		Real pivot = x[k];
+		x[k] = 0;
+		Real maxAbs = std::abs(pivot);
+		for (Int r = block.Lp[k]; r < block.Lp[k + 1]; ++r)
+			maxAbs = std::max(maxAbs, std::abs(x[block.Li[r]]));
+
+		// Reject pivots that became too small compared to their column
+		Bool stable = std::abs(pivot) > mRefactorizationTolerance * maxAbs && pivot != 0;
+		for (Int r = block.Lp[k]; r < block.Lp[k + 1]; ++r) {
+			block.Lx[r] = x[block.Li[r]] / pivot;
+			x[block.Li[r]] = 0;
+		}
+		if (!stable)
+			return false;
+		block.Ux[diag] = pivot;
+	}
+	return true;
+}
+
+void BTFSparseLU::factorize(const SparseMatrix& mat) {
+	if (!mat.isCompressed()) {
+		SparseMatrix compressed = mat;
+		compressed.makeCompressed();
+		factorize(compressed);
+		return;
+	}
+	if (!hasAnalyzedPattern(mat))
+		analyzePattern(mat, mat.rows() == mSize ? varyingColumns() : std::vector<Int>());
+
+	permuteValues(mat);
+	for (auto& block : mBlocks)
+		factorizeBlock(block);
+	mFactorizationIsOk = true;
+}
+
+void BTFSparseLU::refactorize(const SparseMatrix& mat) {
+	if (!mFactorizationIsOk || !hasAnalyzedPattern(mat)) {
+		factorize(mat);
+		return;
+	}
+
+	updateValues(mat);
+	for (Int col = 0; col < mSize; ++col) {
+		if (mChangedColumns[col] && !mVaryingColumns[mColPerm[col]]) {
+			mVaryingColumns[mColPerm[col]] = true;
+			mHasNewVaryingColumns = true;
+		}
+	}
+
+	for (auto& block : mBlocks) {
+		if (!refactorizeBlock(block)) {
+			factorizeBlock(block);
+			++mNumPivotUpdates;
+		}
+	}
+	std::fill(mChangedColumns.begin(), mChangedColumns.end(), false);
+}
+
+Matrix BTFSparseLU::solve(const Matrix& rhs) const {
+	Matrix result(mSize, rhs.cols());
+	std::vector<Real>& y = mSolveWork;
+	std::vector<Real>& z = mBlockWork;
+
+	for (Int c = 0; c < rhs.cols(); ++c) {
+		for (Int i = 0; i < mSize; ++i)
+			y[i] = rhs(mRowPerm[i], c);
+
+		// Block back substitution, starting with the last block
+		for (Int b = mBlocks.size() - 1; b >= 0; --b) {
+			const Block& block = mBlocks[b];
+			for (Int l = 0; l < block.size; ++l)
+				z[block.pinv[l]] = y[block.start + l];
+
+			for (Int k = 0; k < block.size; ++k)
+				for (Int q = block.Lp[k]; q < block.Lp[k + 1]; ++q)
+					z[block.Li[q]] -= block.Lx[q] * z[k];
+
+			for (Int k = block.size - 1; k >= 0; --k) {
+				Int diag = block.Up[k + 1] - 1;
+				z[k] /= block.Ux[diag];
+				for (Int q = block.Up[k]; q < diag; ++q)
+					z[block.Ui[q]] -= block.Ux[q] * z[k];
+			}
+
+			// Move the known solution of this block to the right side of the previous blocks
+			for (Int l = 0; l < block.size; ++l) {
+				Int col = block.start + l;
+				y[col] = z[l];
+				z[l] = 0;
+				for (Int p = mPermutedOuter[col]; p < mDiagonalBlockStart[col]; ++p)
+					y[mPermutedInner[p]] -= mPermutedValues[p] * y[col];
+			}
+		}
+
+		for (Int i = 0; i < mSize; ++i)
+			result(mColPerm[i], c) = y[i];
+	}
+	return result;
+}
+
+std::size_t BTFSparseLU::nnzL() const {
+	std::size_t nnz = 0;
+	for (auto& block : mBlocks)
+		nnz += block.Li.size() + block.size;
+	return nnz;
+}
+
+std::size_t BTFSparseLU::nnzU() const {
+	std::size_t nnz = 0;
+	for (auto& block : mBlocks)
+		nnz += block.Ui.size();
+	for (Int j = 0; j < mSize; ++j)
+		nnz += mDiagonalBlockStart[j] - mPermutedOuter[j];
+	return nnz;
+}
+
+std::vector<Int> BTFSparseLU::varyingColumns() const {
+	std::vector<Int> columns;
+	for (UInt col = 0; col < mVaryingColumns.size(); ++col)
+		if (mVaryingColumns[col])
+			columns.push_back(col);
+	return columns;
+}
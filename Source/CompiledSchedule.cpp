@@ -0,0 +1,167 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <dpsim/CompiledSchedule.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+using namespace CPS;
+using namespace DPsim;
+
+// 64 bit FNV-1a
+static void hashBytes(std::uint64_t& hash, const void* data, size_t size) {
+	auto bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+}
+
+static void hashString(std::uint64_t& hash, const String& str) {
+	hashBytes(hash, str.data(), str.size());
+	// Separator so that consecutive strings cannot be shifted
+	hashBytes(hash, "", 1);
+}
+
+static void hashInt(std::uint64_t& hash, Int value) {
+	hashBytes(hash, &value, sizeof(value));
+}
+
+std::uint64_t CompiledSchedule::computeHash(const Task::List& tasks, const String& key) {
+	std::uint64_t hash = 0xcbf29ce484222325ULL;
+	hashString(hash, key);
+
+	// Attribute addresses change between runs, so the modified attributes are
+	// numbered in task order. Only these attributes can create dependencies.
+	std::unordered_map<AttributeBase*, Int> ids;
+	for (auto& task : tasks) {
+		for (auto& attr : task->getModifiedAttributes())
+			ids.emplace(attr.getPtr().get(), static_cast<Int>(ids.size()));
+	}
+	// Many tasks depend on the same attributes, so their dependencies are only resolved once
+	std::unordered_map<AttributeBase*, std::vector<Int>> resolved;
+	auto hashAttributes = [&hash, &ids, &resolved](const std::vector<AttributeBase::Ptr>& attrs, Bool resolve) {
+		hashInt(hash, static_cast<Int>(attrs.size()));
+		for (auto& attr : attrs) {
+			AttributeBase* ptr = attr.getPtr().get();
+			std::vector<Int> single;
+			const std::vector<Int>* deps = &single;
+			if (attr.getPtr() == Scheduler::external.getPtr()) {
+				single.push_back(-1);
+			} else if (resolve) {
+				auto cached = resolved.find(ptr);
+				if (cached == resolved.end()) {
+					std::vector<Int> depIds;
+					for (AttributeBase::Ptr dep : attr->getDependencies()) {
+						auto it = ids.find(dep.getPtr().get());
+						if (it != ids.end())
+							depIds.push_back(it->second);
+					}
+					std::sort(depIds.begin(), depIds.end());
+					cached = resolved.emplace(ptr, std::move(depIds)).first;
+				}
+				deps = &cached->second;
+			} else {
+				auto it = ids.find(ptr);
+				single.push_back(it != ids.end() ? it->second : -2);
+			}
+			hashInt(hash, static_cast<Int>(deps->size()));
+			for (Int dep : *deps)
+				hashInt(hash, dep);
+		}
+	};
+
+	hashInt(hash, static_cast<Int>(tasks.size()));
+	for (auto& task : tasks) {
+		hashString(hash, task->toString());
+		hashAttributes(task->getAttributeDependencies(), true);
+		hashAttributes(task->getModifiedAttributes(), false);
+		hashAttributes(task->getPrevStepDependencies(), false);
+	}
+	return hash;
+}
+
+void CompiledSchedule::write(const String& filename) const {
+	std::ofstream os(filename);
+	os << "hash," << std::hex << hash << std::dec << std::endl;
+	for (auto& names : tasks) {
+		os << "task";
+		for (auto& name : names)
+			os << "," << name;
+		os << std::endl;
+	}
+	for (auto& group : groups) {
+		os << "group";
+		for (Int idx : group)
+			os << "," << idx;
+		os << std::endl;
+	}
+	for (auto& edge : edges)
+		os << "edge," << edge.first << "," << edge.second << std::endl;
+	os.close();
+}
+
+Bool CompiledSchedule::read(const String& filename) {
+	std::ifstream fs(filename);
+	if (!fs.good())
+		return false;
+
+	hash = 0;
+	tasks.clear();
+	groups.clear();
+	edges.clear();
+	Bool hasHash = false;
+	while (fs.good()) {
+		String line;
+		std::getline(fs, line);
+		if (line.empty())
+			continue;
+
+		std::vector<String> fields;
+		std::stringstream ss(line);
+		for (String field; std::getline(ss, field, ',');)
+			fields.push_back(field);
+
+		try {
+			if (fields[0] == "hash" && fields.size() == 2) {
+				hash = std::stoull(fields[1], nullptr, 16);
+				hasHash = true;
+			} else if (fields[0] == "task" && fields.size() >= 2) {
+				tasks.emplace_back(fields.begin() + 1, fields.end());
+			} else if (fields[0] == "group") {
+				groups.emplace_back();
+				for (size_t i = 1; i < fields.size(); i++)
+					groups.back().push_back(std::stoi(fields[i]));
+			} else if (fields[0] == "edge" && fields.size() == 3) {
+				edges.emplace_back(std::stoi(fields[1]), std::stoi(fields[2]));
+			} else {
+				throw SchedulingException();
+			}
+		} catch (std::logic_error&) {
+			throw SchedulingException();
+		}
+	}
+
+	// Check that all indices refer to tasks
+	Int numTasks = static_cast<Int>(tasks.size());
+	auto valid = [numTasks](Int idx) { return idx >= 0 && idx < numTasks; };
+	for (auto& group : groups) {
+		if (!std::all_of(group.begin(), group.end(), valid))
+			throw SchedulingException();
+	}
+	for (auto& edge : edges) {
+		if (!valid(edge.first) || !valid(edge.second))
+			throw SchedulingException();
+	}
+	if (!hasHash)
+		throw SchedulingException();
+	return true;
+}
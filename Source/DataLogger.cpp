@@ -16,14 +16,16 @@ using namespace DPsim;
 DataLogger::DataLogger(Bool enabled) :
 	mLogFile(),
 	mEnabled(enabled),
-	mDownsampling(1) {
+	mDownsampling(1),
+	mSnapshotCount(CPS::AttributeStatic<Int>::make(0)) {
 	mLogFile.setstate(std::ios_base::badbit);
 }
 
 DataLogger::DataLogger(String name, Bool enabled, UInt downsampling) :
 	mName(name),
 	mEnabled(enabled),
-	mDownsampling(downsampling) {
+	mDownsampling(downsampling),
+	mSnapshotCount(CPS::AttributeStatic<Int>::make(0)) {
 	if (!mEnabled)
 		return;
 
@@ -45,6 +47,12 @@ void DataLogger::open() {
 }
 
 void DataLogger::close() {
+	// Pending snapshots of pipelined logging in the order of their time
+	Int first = mSnapshots[1].valid && (!mSnapshots[0].valid || mSnapshots[1].time < mSnapshots[0].time) ? 1 : 0;
+	for (Int i = first; i < first + 2; i++) {
+		if (mSnapshots[i % 2].valid)
+			writeSnapshot(mSnapshots[i % 2]);
+	}
 	mLogFile.close();
 }
 
@@ -131,27 +139,86 @@ void DataLogger::log(Real time, Int timeStepCount) {
 	if (!mEnabled || !(timeStepCount % mDownsampling == 0))
 		return;
 
+	writeHeader();
+
+	mLogFile << std::scientific << std::right << std::setw(14) << time;
+	for (auto it : mAttributes)
+		mLogFile << ", " << std::right << std::setw(13) << it.second->toString();
+	mLogFile << '\n';
+}
+
+void DataLogger::writeHeader() {
 	if (mLogFile.tellp() == std::ofstream::pos_type(0)) {
 		mLogFile << std::right << std::setw(14) << "time";
 		for (auto it : mAttributes)
 			mLogFile << ", " << std::right << std::setw(13) << it.first;
 		mLogFile << '\n';
 	}
+}
 
-	mLogFile << std::scientific << std::right << std::setw(14) << time;
-	for (auto it : mAttributes)
-		mLogFile << ", " << std::right << std::setw(13) << it.second->toString();
+void DataLogger::snapshot(Real time, Int timeStepCount) {
+	auto& snapshot = mSnapshots[timeStepCount % 2];
+	snapshot.valid = mEnabled && timeStepCount % mDownsampling == 0;
+	if (!snapshot.valid)
+		return;
+
+	if (mRealAttributes.size() != mAttributes.size()) {
+		mRealAttributes.clear();
+		for (auto it : mAttributes)
+			mRealAttributes.push_back(dynamic_cast<CPS::Attribute<Real>*>(it.second.getPtr().get()));
+	}
+
+	// Only real values are copied, which covers the attributes derived by logAttribute
+	snapshot.time = time;
+	snapshot.values.resize(mAttributes.size());
+	snapshot.strings.resize(mAttributes.size());
+	size_t i = 0;
+	for (auto it : mAttributes) {
+		if (mRealAttributes[i])
+			snapshot.values[i] = mRealAttributes[i]->get();
+		else
+			snapshot.strings[i] = it.second->toString();
+		i++;
+	}
+}
+
+void DataLogger::writeSnapshot(Snapshot& snapshot) {
+	writeHeader();
+
+	mLogFile << std::scientific << std::right << std::setw(14) << snapshot.time;
+	for (size_t i = 0; i < snapshot.values.size(); i++) {
+		mLogFile << ", " << std::right << std::setw(13)
+			<< (mRealAttributes[i] ? std::to_string(snapshot.values[i]) : snapshot.strings[i]);
+	}
 	mLogFile << '\n';
+	snapshot.valid = false;
 }
 
 void DataLogger::Step::execute(Real time, Int timeStepCount) {
 	mLogger.log(time, timeStepCount);
 }
 
+void DataLogger::SnapshotStep::execute(Real time, Int timeStepCount) {
+	mLogger.snapshot(time, timeStepCount);
+}
+
+void DataLogger::DelayedStep::execute(Real time, Int timeStepCount) {
+	// The snapshot task of this step writes the other buffer
+	auto& snapshot = mLogger.mSnapshots[(timeStepCount + 1) % 2];
+	if (snapshot.valid)
+		mLogger.writeSnapshot(snapshot);
+}
+
 CPS::Task::Ptr DataLogger::getTask() {
 	return std::make_shared<DataLogger::Step>(*this);
 }
 
+CPS::Task::List DataLogger::getTasks(Bool pipelined) {
+	if (!pipelined)
+		return { getTask() };
+	return { std::make_shared<DataLogger::SnapshotStep>(*this), std::make_shared<DataLogger::DelayedStep>(*this) };
+}
+
 void DataLogger::logAttribute(const std::vector<String> &name, CPS::AttributeBase::Ptr attr) {
 	if (auto attrMatrix = std::dynamic_pointer_cast<CPS::Attribute<Matrix>>(attr.getPtr())) {
 		if ((**attrMatrix).rows() == 1 && (**attrMatrix).cols() == 1) {
@@ -9,10 +9,12 @@
 #include <dpsim/DiakopticsSolver.h>
 
 #include <iomanip>
+#include <numeric>
 
 #include <cps/MathUtils.h>
 #include <cps/Solver/MNATearInterface.h>
 #include <dpsim/Definitions.h>
+#include <dpsim/NetworkPartitioner.h>
 
 using namespace CPS;
 using namespace DPsim;
@@ -22,8 +24,9 @@ namespace DPsim {
 template <typename VarType>
 DiakopticsSolver<VarType>::DiakopticsSolver(String name,
 	SystemTopology system, IdentifiedObject::List tearComponents,
-	Real timeStep, Logger::Level logLevel) :
+	Real timeStep, Logger::Level logLevel, Bool nestedTearing) :
 	Solver(name, logLevel),
+	mNestedTearing(nestedTearing),
 	mMappedTearCurrents(Attribute<Matrix>::create("mapped_tear_currents", mAttributes)),
 	mOrigLeftSideVector(Attribute<Matrix>::create("old_left_vector", mAttributes)) {
 	mTimeStep = timeStep;
@@ -67,15 +70,22 @@ void DiakopticsSolver<VarType>::initSubnets(const std::vector<SystemTopology>& s
 		}
 
 		for (auto comp : subnets[i].mComponents) {
-			// TODO switches
 			auto mnaComp = std::dynamic_pointer_cast<CPS::MNAInterface>(comp);
 			if (mnaComp)
 				mSubnets[i].components.push_back(mnaComp);
 
+			// Switches stay in the component list for their tasks, but are
+			// stamped separately according to the subnet's switch state
+			auto swComp = std::dynamic_pointer_cast<CPS::MNASwitchInterface>(comp);
+			if (swComp)
+				mSubnets[i].switches.push_back(swComp);
+
 			auto sigComp = std::dynamic_pointer_cast<CPS::SimSignalComp>(comp);
 			if (sigComp)
 				mSimSignalComps.push_back(sigComp);
 		}
+		if (mSubnets[i].switches.size() > SWITCH_NUM)
+			throw SystemError("Too many Switches in subnet " + std::to_string(i));
 	}
 
 	// Create map that relates nodes to subnetworks
@@ -207,8 +217,6 @@ void DiakopticsSolver<Complex>::setLogColumns() {
 template <typename VarType>
 void DiakopticsSolver<VarType>::createMatrices() {
 	UInt totalSize = mSubnets.back().sysOff + mSubnets.back().sysSize;
-	mSystemMatrix = Matrix::Zero(totalSize, totalSize);
-	mSystemInverse = Matrix::Zero(totalSize, totalSize);
 
 	mRightSideVector = Matrix::Zero(totalSize, 1);
 	mLeftSideVector = Matrix::Zero(totalSize, 1);
@@ -221,6 +229,7 @@ void DiakopticsSolver<VarType>::createMatrices() {
 		// copy the solution there
 		net.leftVector = AttributeStatic<Matrix>::make();
 		net.leftVector->set(Matrix::Zero(net.sysSize, 1));
+		net.solved = AttributeStatic<Int>::make(0);
 	}
 
 	createTearMatrices(totalSize);
@@ -228,7 +237,7 @@ void DiakopticsSolver<VarType>::createMatrices() {
 
 template <>
 void DiakopticsSolver<Real>::createTearMatrices(UInt totalSize) {
-	mTearTopology = Matrix::Zero(totalSize, mTearComponents.size());
+	mTearTopology = CPS::SparseMatrix(totalSize, mTearComponents.size());
 	mTearImpedance = Matrix::Zero(mTearComponents.size(), mTearComponents.size());
 	mTearCurrents = Matrix::Zero(mTearComponents.size(), 1);
 	mTearVoltages = Matrix::Zero(mTearComponents.size(), 1);
@@ -236,7 +245,7 @@ void DiakopticsSolver<Real>::createTearMatrices(UInt totalSize) {
 
 template <>
 void DiakopticsSolver<Complex>::createTearMatrices(UInt totalSize) {
-	mTearTopology = Matrix::Zero(totalSize, 2*mTearComponents.size());
+	mTearTopology = CPS::SparseMatrix(totalSize, 2*mTearComponents.size());
 	mTearImpedance = Matrix::Zero(2*mTearComponents.size(), 2*mTearComponents.size());
 	mTearCurrents = Matrix::Zero(2*mTearComponents.size(), 1);
 	mTearVoltages = Matrix::Zero(2*mTearComponents.size(), 1);
@@ -267,35 +276,41 @@ void DiakopticsSolver<VarType>::initComponents() {
 
 template <typename VarType>
 void DiakopticsSolver<VarType>::initMatrices() {
-	for (auto& net : mSubnets) {
-		// We can't directly pass the block reference to mnaApplySystemMatrixStamp,
-		// because it expects a concrete Matrix. It can't be changed to accept some common
-		// base class like DenseBase because that would make it a template function (as
-		// Eigen uses CRTP for polymorphism), which is impossible for virtual functions.
-		Matrix partSys = Matrix::Zero(net.sysSize, net.sysSize);
-		for (auto comp : net.components) {
-			comp->mnaApplySystemMatrixStamp(partSys);
-		}
-		auto block = mSystemMatrix.block(net.sysOff, net.sysOff, net.sysSize, net.sysSize);
-		block = partSys;
-		mSLog->info("Block: \n{}", block);
-		net.luFactorization = Eigen::PartialPivLU<Matrix>(partSys);
-		mSLog->info("Factorization: \n{}", net.luFactorization.matrixLU());
-	}
-	mSLog->info("Complete system matrix: \n{}", mSystemMatrix);
-
 	// initialize tear topology matrix and impedance matrix of removed network
+	std::vector<Eigen::Triplet<Real>> topology;
 	for (UInt compIdx = 0; compIdx < mTearComponents.size(); ++compIdx) {
-		applyTearComponentStamp(compIdx);
+		applyTearComponentStamp(compIdx, topology);
 	}
-	mSLog->info("Topology matrix: \n{}", mTearTopology);
+	mTearTopology.setFromTriplets(topology.begin(), topology.end());
+	mSLog->info("Topology matrix has {} non-zeros", mTearTopology.nonZeros());
 	mSLog->info("Removed impedance matrix: \n{}", mTearImpedance);
-	// TODO this can be sped up as well by using the block diagonal form of Yinv
-	for (auto& net : mSubnets) {
-		mSystemInverse.block(net.sysOff, net.sysOff, net.sysSize, net.sysSize) = net.luFactorization.inverse();
+
+	for (UInt i = 0; i < mSubnets.size(); ++i) {
+		auto& net = mSubnets[i];
+		// Only the tear currents entering this subnet contribute to the tear impedance
+		CPS::SparseMatrix netTopology = mTearTopology.middleRows(net.sysOff, net.sysSize);
+		for (Int col = 0; col < netTopology.outerSize(); ++col) {
+			if (netTopology.col(col).nonZeros() > 0)
+				net.tearColumns.push_back(col);
+		}
+		if (mNestedTearing)
+			net.tearTopology = netTopology;
+
+		// The blocks are never assembled into a complete system matrix,
+		// each subnet keeps its own sparse factorization per switch state.
+		for (UInt sw = 0; sw < net.switches.size(); ++sw)
+			net.switchStatus.set(sw, net.switches[sw]->mnaIsClosed());
+		net.factorization = cachedSwitchedFactorization(net);
+		mSLog->info("Subnet {} has {} switches and {} tear currents", i, net.switches.size(), net.tearColumns.size());
+	}
+
+	// Z' = Z + C^T * Y^-1 * C, where Y is block diagonal
+	if (mNestedTearing) {
+		initTearTree();
+	} else {
+		factorizeTotalTearImpedance();
+		mSLog->info("Total removed impedance matrix LU decomposition: \n{}", mTotalTearImpedance.matrixLU());
 	}
-	mTotalTearImpedance = Eigen::PartialPivLU<Matrix>(mTearImpedance + mTearTopology.transpose() * mSystemInverse * mTearTopology);
-	mSLog->info("Total removed impedance matrix LU decomposition: \n{}", mTotalTearImpedance.matrixLU());
 
 	// Compute subnet right side (source) vectors for debugging
 	for (auto& net : mSubnets) {
@@ -308,27 +323,288 @@ void DiakopticsSolver<VarType>::initMatrices() {
 	}
 }
 
+template <typename VarType>
+void DiakopticsSolver<VarType>::factorizeTotalTearImpedance() {
+	// Rebuilt instead of updated in place, so that no rounding errors accumulate over switch events
+	mTotalTearImpedanceMatrix = mTearImpedance;
+	for (auto& net : mSubnets)
+		addSubnetTearImpedance(net, net.factorization->tearImpedance, mTotalTearImpedanceMatrix);
+	mTotalTearImpedance.compute(mTotalTearImpedanceMatrix);
+}
+
+template <typename VarType>
+void DiakopticsSolver<VarType>::addSubnetTearImpedance(const Subnet& net, const Matrix& impedance, Matrix& totalTearImpedance) {
+	const auto& columns = net.tearColumns;
+	for (UInt i = 0; i < columns.size(); ++i) {
+		for (UInt j = 0; j < columns.size(); ++j)
+			totalTearImpedance(columns[i], columns[j]) += impedance(i, j);
+	}
+}
+
+template <typename VarType>
+void DiakopticsSolver<VarType>::updateSwitchStatus(Subnet& net) {
+	auto status = net.switchStatus;
+	for (UInt sw = 0; sw < net.switches.size(); ++sw)
+		status.set(sw, net.switches[sw]->mnaIsClosed());
+
+	net.switched = status != net.switchStatus;
+	if (net.switched) {
+		net.switchStatus = status;
+		net.factorization = cachedSwitchedFactorization(net);
+	}
+}
+
+template <typename VarType>
+std::shared_ptr<typename DiakopticsSolver<VarType>::SwitchedFactorization>
+DiakopticsSolver<VarType>::cachedSwitchedFactorization(Subnet& net) {
+	auto entry = net.cacheEntries.find(net.switchStatus);
+	if (entry != net.cacheEntries.end()) {
+		++net.cacheHits;
+		net.cacheOrder.splice(net.cacheOrder.begin(), net.cacheOrder, entry->second.first);
+		return entry->second.second;
+	}
+
+	++net.cacheMisses;
+	auto factorization = factorizeSubnet(net);
+	net.cacheOrder.push_front(net.switchStatus);
+	net.cacheEntries[net.switchStatus] = { net.cacheOrder.begin(), factorization };
+	net.cacheMemory += factorization->memory;
+
+	// Evict least recently used states, but always keep the one just created
+	while (mSwitchedMatrixCacheBudget > 0 && net.cacheMemory > mSwitchedMatrixCacheBudget
+		&& net.cacheOrder.size() > 1) {
+		auto victim = net.cacheOrder.back();
+		net.cacheOrder.pop_back();
+		net.cacheMemory -= net.cacheEntries[victim].second->memory;
+		net.cacheEntries.erase(victim);
+		++net.cacheEvictions;
+	}
+	return factorization;
+}
+
+template <typename VarType>
+std::shared_ptr<typename DiakopticsSolver<VarType>::SwitchedFactorization>
+DiakopticsSolver<VarType>::factorizeSubnet(const Subnet& net) {
+	UInt idx = static_cast<UInt>(&net - mSubnets.data());
+	SparseMatrixRow sparsePartSys(net.sysSize, net.sysSize);
+	for (auto comp : net.components) {
+		if (!std::dynamic_pointer_cast<MNASwitchInterface>(comp))
+			comp->mnaApplySystemMatrixStamp(sparsePartSys);
+	}
+	for (UInt sw = 0; sw < net.switches.size(); ++sw)
+		net.switches[sw]->mnaApplySwitchSystemMatrixStamp(net.switchStatus[sw], sparsePartSys, 0);
+	CPS::SparseMatrix partSys = sparsePartSys;
+	partSys.makeCompressed();
+	mSLog->info("Block {} has {} non-zeros for switch state {}", idx, partSys.nonZeros(),
+		net.switchStatus.to_string().substr(SWITCH_NUM - net.switches.size()));
+
+	auto factorization = std::make_shared<SwitchedFactorization>();
+	factorization->lu = std::make_shared<LUFactorizedSparse>();
+	factorization->lu->analyzePattern(partSys);
+	factorization->lu->factorize(partSys);
+	if (factorization->lu->info() != Eigen::Success)
+		throw SystemError("Factorization of subnet " + std::to_string(idx) + " failed");
+
+	// The subnet is solved for its columns of C instead of inverting its block
+	const auto& columns = net.tearColumns;
+	Matrix tearColumns = Matrix::Zero(net.sysSize, columns.size());
+	for (UInt i = 0; i < columns.size(); ++i) {
+		for (CPS::SparseMatrix::InnerIterator it(mTearTopology, columns[i]); it; ++it) {
+			if (it.row() >= net.sysOff && it.row() < net.sysOff + net.sysSize)
+				tearColumns(it.row() - net.sysOff, i) = it.value();
+		}
+	}
+	factorization->tearImpedance = tearColumns.transpose() * factorization->lu->solve(tearColumns);
+
+	const std::size_t entrySize = sizeof(Real) + sizeof(CPS::SparseMatrix::StorageIndex);
+	factorization->memory = (factorization->lu->nnzL() + factorization->lu->nnzU()) * entrySize
+		+ 2 * net.sysSize * sizeof(CPS::SparseMatrix::StorageIndex)
+		+ factorization->tearImpedance.size() * sizeof(Real);
+	return factorization;
+}
+
 template <>
-void DiakopticsSolver<Real>::applyTearComponentStamp(UInt compIdx) {
+UInt DiakopticsSolver<Real>::tearVariablesPerComponent() {
+	return 1;
+}
+
+template <>
+UInt DiakopticsSolver<Complex>::tearVariablesPerComponent() {
+	return 2;
+}
+
+template <typename VarType>
+Int DiakopticsSolver<VarType>::buildTearTree(const std::vector<UInt>& subnets, Int parent) {
+	Int idx = static_cast<Int>(mTearTree.size());
+	mTearTree.emplace_back();
+	mTearTree[idx].parent = parent;
+	if (subnets.size() == 1) {
+		mSubnetTearNode[subnets[0]] = idx;
+		mTearTree[idx].subnet = subnets[0];
+		return idx;
+	}
+
+	// Bisection of the subnet graph with the tear components as edges
+	std::vector<Int> local(mSubnets.size(), -1), weights;
+	for (UInt i = 0; i < subnets.size(); ++i) {
+		local[subnets[i]] = i;
+		weights.push_back(mSubnets[subnets[i]].sysSize);
+	}
+	std::vector<std::array<Int, 3>> edges;
+	for (auto comp : mTearComponents) {
+		Int net1 = local[mNodeSubnetMap[comp->node(0)] - mSubnets.data()];
+		Int net2 = local[mNodeSubnetMap[comp->node(1)] - mSubnets.data()];
+		if (net1 >= 0 && net2 >= 0 && net1 != net2)
+			edges.push_back({net1, net2, 1});
+	}
+	NetworkPartitioner partitioner(2);
+	auto side = partitioner.partition(NetworkPartitioner::Graph::fromEdges(weights, edges), 2);
+	std::vector<UInt> halves[2];
+	for (UInt i = 0; i < subnets.size(); ++i)
+		halves[side[i]].push_back(subnets[i]);
+	if (halves[0].empty() || halves[1].empty()) {
+		halves[0].assign(subnets.begin(), subnets.begin() + subnets.size() / 2);
+		halves[1].assign(subnets.begin() + subnets.size() / 2, subnets.end());
+	}
+
+	for (auto& half : halves) {
+		Int child = buildTearTree(half, idx);
+		mTearTree[idx].children.push_back(child);
+	}
+	return idx;
+}
+
+template <typename VarType>
+void DiakopticsSolver<VarType>::initTearTree() {
+	mTearTree.clear();
+	mSubnetTearNode.assign(mSubnets.size(), -1);
+	std::vector<UInt> subnets(mSubnets.size());
+	std::iota(subnets.begin(), subnets.end(), 0);
+	buildTearTree(subnets, -1);
+
+	// Each tear component belongs to the lowest common ancestor of its two subnets
+	std::vector<Int> depth(mTearTree.size(), 0);
+	for (UInt i = 1; i < mTearTree.size(); ++i)
+		depth[i] = depth[mTearTree[i].parent] + 1;
+	UInt numComps = static_cast<UInt>(mTearComponents.size());
+	for (UInt compIdx = 0; compIdx < numComps; ++compIdx) {
+		auto comp = mTearComponents[compIdx];
+		UInt net1 = static_cast<UInt>(mNodeSubnetMap[comp->node(0)] - mSubnets.data());
+		UInt net2 = static_cast<UInt>(mNodeSubnetMap[comp->node(1)] - mSubnets.data());
+		Int node1 = mSubnetTearNode[net1], node2 = mSubnetTearNode[net2];
+		while (node1 != node2) {
+			if (depth[node1] < depth[node2])
+				node2 = mTearTree[node2].parent;
+			else
+				node1 = mTearTree[node1].parent;
+		}
+		auto& node = mTearTree[node1];
+		node.components.push_back(compIdx);
+		for (UInt var = 0; var < tearVariablesPerComponent(); ++var)
+			node.vars.push_back(compIdx + var * numComps);
+		for (UInt net : {net1, net2}) {
+			if (std::find(node.subnets.begin(), node.subnets.end(), net) == node.subnets.end())
+				node.subnets.push_back(net);
+		}
+	}
+
+	for (auto& node : mTearTree) {
+		if (node.parent >= 0) {
+			auto& parent = mTearTree[node.parent];
+			node.ancestorVars = parent.vars;
+			node.ancestorVars.insert(node.ancestorVars.end(), parent.ancestorVars.begin(), parent.ancestorVars.end());
+		}
+		std::vector<Eigen::Triplet<Real>> topology;
+		for (UInt j = 0; j < node.vars.size(); ++j) {
+			for (CPS::SparseMatrix::InnerIterator it(mTearTopology, node.vars[j]); it; ++it)
+				topology.emplace_back(it.row(), j, it.value());
+		}
+		node.topology = CPS::SparseMatrix(mTearTopology.rows(), node.vars.size());
+		node.topology.setFromTriplets(topology.begin(), topology.end());
+	}
+
+	// Block elimination from the leaves to the root
+	for (Int i = static_cast<Int>(mTearTree.size()) - 1; i >= 0; --i) {
+		auto& node = mTearTree[i];
+		factorizeTearNode(node);
+		node.solution = Matrix::Zero(node.vars.size(), 1);
+		node.update = Matrix::Zero(node.ancestorVars.size(), 1);
+		node.forward = AttributeStatic<Int>::make(0);
+		node.backward = AttributeStatic<Int>::make(0);
+		mSLog->info("Tear tree node {} has {} tear currents and {} ancestor tear currents",
+			i, node.vars.size(), node.ancestorVars.size());
+	}
+}
+
+template <typename VarType>
+void DiakopticsSolver<VarType>::factorizeTearNode(TearNode& node) {
+	// The frontal matrix of a node couples its own variables and the ones of its
+	// ancestors, the Schur complement of its own block is added to the frontal
+	// matrix of the parent. Only the subnets connected by the own tear components
+	// contribute to the own rows and columns.
+	UInt own = static_cast<UInt>(node.vars.size());
+	UInt anc = static_cast<UInt>(node.ancestorVars.size());
+	std::vector<Int> vars = node.vars;
+	vars.insert(vars.end(), node.ancestorVars.begin(), node.ancestorVars.end());
+
+	Matrix frontal = Matrix::Zero(own + anc, own + anc);
+	for (UInt r = 0; r < own + anc; ++r) {
+		for (UInt c = 0; c < own + anc; ++c) {
+			if (r < own || c < own)
+				frontal(r, c) = mTearImpedance(vars[r], vars[c]);
+		}
+	}
+	std::vector<Int> position(mTearImpedance.rows(), -1);
+	for (UInt k = 0; k < own + anc; ++k)
+		position[vars[k]] = k;
+	for (auto net : node.subnets) {
+		const auto& columns = mSubnets[net].tearColumns;
+		const auto& impedance = mSubnets[net].factorization->tearImpedance;
+		for (UInt i = 0; i < columns.size(); ++i) {
+			Int r = position[columns[i]];
+			if (r < 0)
+				continue;
+			for (UInt j = 0; j < columns.size(); ++j) {
+				Int c = position[columns[j]];
+				if (c >= 0 && (r < static_cast<Int>(own) || c < static_cast<Int>(own)))
+					frontal(r, c) += impedance(i, j);
+			}
+		}
+	}
+	for (auto child : node.children)
+		frontal += mTearTree[child].schur;
+
+	if (own > 0) {
+		node.pivot = CPS::LUFactorized(frontal.topLeftCorner(own, own));
+		node.upper = node.pivot.solve(frontal.topRightCorner(own, anc));
+	} else {
+		node.upper = Matrix::Zero(0, anc);
+	}
+	node.lower = frontal.bottomLeftCorner(anc, own);
+	node.schur = frontal.bottomRightCorner(anc, anc) - node.lower * node.upper;
+}
+
+template <>
+void DiakopticsSolver<Real>::applyTearComponentStamp(UInt compIdx, std::vector<Eigen::Triplet<Real>>& topology) {
 	auto comp = mTearComponents[compIdx];
-	mTearTopology(mNodeSubnetMap[comp->node(0)]->sysOff + comp->node(0)->matrixNodeIndex(), compIdx) = 1;
-	mTearTopology(mNodeSubnetMap[comp->node(1)]->sysOff + comp->node(1)->matrixNodeIndex(), compIdx) = -1;
+	topology.emplace_back(mNodeSubnetMap[comp->node(0)]->sysOff + comp->node(0)->matrixNodeIndex(), compIdx, 1);
+	topology.emplace_back(mNodeSubnetMap[comp->node(1)]->sysOff + comp->node(1)->matrixNodeIndex(), compIdx, -1);
 
 	auto tearComp = std::dynamic_pointer_cast<MNATearInterface>(comp);
 	tearComp->mnaTearApplyMatrixStamp(mTearImpedance);
 }
 
 template <>
-void DiakopticsSolver<Complex>::applyTearComponentStamp(UInt compIdx) {
+void DiakopticsSolver<Complex>::applyTearComponentStamp(UInt compIdx, std::vector<Eigen::Triplet<Real>>& topology) {
 	auto comp = mTearComponents[compIdx];
 
 	auto net1 = mNodeSubnetMap[comp->node(0)];
 	auto net2 = mNodeSubnetMap[comp->node(1)];
 
-	mTearTopology(net1->sysOff + comp->node(0)->matrixNodeIndex(), compIdx) = 1;
-	mTearTopology(net1->sysOff + net1->mCmplOff + comp->node(0)->matrixNodeIndex(), mTearComponents.size() + compIdx) = 1;
-	mTearTopology(net2->sysOff + comp->node(1)->matrixNodeIndex(), compIdx) = -1;
-	mTearTopology(net2->sysOff + net2->mCmplOff + comp->node(1)->matrixNodeIndex(), mTearComponents.size() + compIdx) = -1;
+	topology.emplace_back(net1->sysOff + comp->node(0)->matrixNodeIndex(), compIdx, 1);
+	topology.emplace_back(net1->sysOff + net1->mCmplOff + comp->node(0)->matrixNodeIndex(), mTearComponents.size() + compIdx, 1);
+	topology.emplace_back(net2->sysOff + comp->node(1)->matrixNodeIndex(), compIdx, -1);
+	topology.emplace_back(net2->sysOff + net2->mCmplOff + comp->node(1)->matrixNodeIndex(), mTearComponents.size() + compIdx, -1);
 
 	auto tearComp = std::dynamic_pointer_cast<MNATearInterface>(comp);
 	tearComp->mnaTearApplyMatrixStamp(mTearImpedance);
@@ -358,7 +634,14 @@ Task::List DiakopticsSolver<VarType>::getTasks() {
 			l.push_back(task);
 		}
 	}
-	l.push_back(std::make_shared<PreSolveTask>(*this));
+	if (mNestedTearing) {
+		for (UInt node = 0; node < mTearTree.size(); ++node) {
+			l.push_back(std::make_shared<ForwardTask>(*this, node));
+			l.push_back(std::make_shared<BackwardTask>(*this, node));
+		}
+	} else {
+		l.push_back(std::make_shared<PreSolveTask>(*this));
+	}
 	l.push_back(std::make_shared<PostSolveTask>(*this));
 	l.push_back(std::make_shared<LogTask>(*this));
 
@@ -367,6 +650,9 @@ Task::List DiakopticsSolver<VarType>::getTasks() {
 
 template <typename VarType>
 void DiakopticsSolver<VarType>::SubnetSolveTask::execute(Real time, Int timeStepCount) {
+	// Only this subnet is refactorized if one of its switches changed
+	mSolver.updateSwitchStatus(mSubnet);
+
 	auto rBlock = mSolver.mRightSideVector.block(mSubnet.sysOff, 0, mSubnet.sysSize, 1);
 	rBlock.setZero();
 
@@ -375,11 +661,19 @@ void DiakopticsSolver<VarType>::SubnetSolveTask::execute(Real time, Int timeStep
 
 	auto lBlock = (**mSolver.mOrigLeftSideVector).block(mSubnet.sysOff, 0, mSubnet.sysSize, 1);
 	// Solve Y' * v' = I
-	lBlock = mSubnet.luFactorization.solve(rBlock);
+	lBlock = mSubnet.factorization->lu->solve(rBlock);
 }
 
 template <typename VarType>
 void DiakopticsSolver<VarType>::PreSolveTask::execute(Real time, Int timeStepCount) {
+	// Z' changes with the tear impedance of switched subnets
+	for (auto& net : mSolver.mSubnets) {
+		if (net.switched) {
+			mSolver.factorizeTotalTearImpedance();
+			break;
+		}
+	}
+
 	mSolver.mTearVoltages.setZero();
 	for (auto comp : mSolver.mTearComponents) {
 		auto tComp = std::dynamic_pointer_cast<MNATearInterface>(comp);
@@ -394,13 +688,70 @@ void DiakopticsSolver<VarType>::PreSolveTask::execute(Real time, Int timeStepCou
 	mSolver.mLeftSideVector = **mSolver.mOrigLeftSideVector;
 }
 
+template <typename VarType>
+void DiakopticsSolver<VarType>::ForwardTask::execute(Real time, Int timeStepCount) {
+	// Refactorize the node if a switch state in its subtree changed,
+	// the frontal matrices of the children are already updated
+	mNode.switched = mNode.subnet >= 0 && mSolver.mSubnets[mNode.subnet].switched;
+	for (auto child : mNode.children)
+		mNode.switched = mNode.switched || mSolver.mTearTree[child].switched;
+	if (mNode.switched)
+		mSolver.factorizeTearNode(mNode);
+
+	// E - C^T * v' for the own tear currents
+	auto& voltages = mSolver.mTearVoltages;
+	for (auto var : mNode.vars)
+		voltages(var, 0) = 0;
+	for (auto compIdx : mNode.components) {
+		auto tComp = std::dynamic_pointer_cast<MNATearInterface>(mSolver.mTearComponents[compIdx]);
+		tComp->mnaTearApplyVoltageStamp(voltages);
+	}
+	Matrix rhs = -mNode.topology.transpose() * **mSolver.mOrigLeftSideVector;
+	for (UInt j = 0; j < mNode.vars.size(); ++j)
+		rhs(j, 0) += voltages(mNode.vars[j], 0);
+
+	// Add the updates of the subtrees and eliminate the own variables
+	mNode.update.setZero();
+	for (auto child : mNode.children) {
+		auto& update = mSolver.mTearTree[child].update;
+		rhs += update.topRows(mNode.vars.size());
+		mNode.update += update.bottomRows(mNode.ancestorVars.size());
+	}
+	if (mNode.vars.size() > 0) {
+		mNode.solution = mNode.pivot.solve(rhs);
+		mNode.update -= mNode.lower * mNode.solution;
+	}
+}
+
+template <typename VarType>
+void DiakopticsSolver<VarType>::BackwardTask::execute(Real time, Int timeStepCount) {
+	if (mNode.vars.size() == 0)
+		return;
+
+	auto& currents = mSolver.mTearCurrents;
+	Matrix solution = mNode.solution;
+	if (mNode.ancestorVars.size() > 0) {
+		Matrix ancestors(mNode.ancestorVars.size(), 1);
+		for (UInt k = 0; k < mNode.ancestorVars.size(); ++k)
+			ancestors(k, 0) = currents(mNode.ancestorVars[k], 0);
+		solution -= mNode.upper * ancestors;
+	}
+	for (UInt j = 0; j < mNode.vars.size(); ++j)
+		currents(mNode.vars[j], 0) = solution(j, 0);
+}
+
 template <typename VarType>
 void DiakopticsSolver<VarType>::SolveTask::execute(Real time, Int timeStepCount) {
 	auto lBlock = mSolver.mLeftSideVector.block(mSubnet.sysOff, 0, mSubnet.sysSize, 1);
 	auto rBlock = (**mSolver.mMappedTearCurrents).block(mSubnet.sysOff, 0, mSubnet.sysSize, 1);
+	if (mSolver.mNestedTearing) {
+		// Without the central PreSolveTask, each subnet maps its own tear currents
+		rBlock = mSubnet.tearTopology * mSolver.mTearCurrents;
+		lBlock = (**mSolver.mOrigLeftSideVector).block(mSubnet.sysOff, 0, mSubnet.sysSize, 1);
+	}
 	// Solve Y' * x = C * i
 	// v = v' + x
-	lBlock += mSubnet.luFactorization.solve(rBlock);
+	lBlock += mSubnet.factorization->lu->solve(rBlock);
 	**mSubnet.leftVector = lBlock;
 }
 
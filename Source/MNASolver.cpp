@@ -125,6 +125,9 @@ void MnaSolver<Real>::initializeComponents() {
 		const Matrix& stamp = comp->template attribute<Matrix>("right_vector")->get();
 		if (stamp.size() != 0) {
 			mRightVectorStamps.push_back(&stamp);
+			mRightVectorStampIndices.push_back(rightVectorStampIndices(comp));
+			mRightVectorStampComponents.push_back(comp);
+			comp->mnaSetRightVectorRows(mRightVectorStampIndices.back());
 		}
 	}
 
@@ -160,7 +163,12 @@ void MnaSolver<Complex>::initializeComponents() {
 			// Initialize MNA specific parts of components.
 			comp->mnaInitializeHarm(mSystem.mSystemOmega, mTimeStep, mLeftSideVectorHarm);
 			const Matrix& stamp = comp->template attribute<Matrix>("right_vector")->get();
-			if (stamp.size() != 0) mRightVectorStamps.push_back(&stamp);
+			if (stamp.size() != 0) {
+				mRightVectorStamps.push_back(&stamp);
+				mRightVectorStampIndices.push_back({});
+				mRightVectorStampComponents.push_back(comp);
+				comp->mnaSetRightVectorRows({});
+			}
 		}
 		// Initialize nodes
 		for (UInt nodeIdx = 0; nodeIdx < mNodes.size(); ++nodeIdx) {
@@ -174,6 +182,9 @@ void MnaSolver<Complex>::initializeComponents() {
 			const Matrix& stamp = comp->template attribute<Matrix>("right_vector")->get();
 			if (stamp.size() != 0) {
 				mRightVectorStamps.push_back(&stamp);
+				mRightVectorStampIndices.push_back(rightVectorStampIndices(comp));
+				mRightVectorStampComponents.push_back(comp);
+				comp->mnaSetRightVectorRows(mRightVectorStampIndices.back());
 			}
 		}
 
@@ -293,6 +304,93 @@ Bool MnaSolver<VarType>::hasVariableComponentChanged() {
 	return false;
 }
 
+template <typename VarType>
+std::vector<UInt> MnaSolver<VarType>::rightVectorStampIndices(CPS::MNAInterface::Ptr comp) {
+	std::vector<UInt> indices;
+	auto pComp = std::dynamic_pointer_cast<SimPowerComp<VarType>>(comp);
+	// Harmonics are stored in additional blocks of the vector
+	if (!mSparseRightVectorAssembly || !pComp || mNumTotalMatrixNodeIndices != mNumMatrixNodeIndices)
+		return indices;
+
+	// Components only write to the rows of their own and their subcomponents' nodes
+	std::function<void(std::shared_ptr<SimPowerComp<VarType>>)> collect =
+		[&](std::shared_ptr<SimPowerComp<VarType>> powerComp) {
+		for (auto terminal : powerComp->terminals()) {
+			auto node = terminal ? terminal->node() : nullptr;
+			if (node && !node->isGround())
+				for (auto idx : node->matrixNodeIndices())
+					indices.push_back(idx);
+		}
+		for (auto node : powerComp->virtualNodes())
+			for (auto idx : node->matrixNodeIndices())
+				indices.push_back(idx);
+		for (auto subComp : powerComp->subComponents())
+			collect(subComp);
+	};
+	collect(pComp);
+
+	// Imaginary parts are stored in the second half of the vector
+	if (std::is_same<VarType, Complex>::value) {
+		UInt numIndices = indices.size();
+		for (UInt i = 0; i < numIndices; ++i)
+			indices.push_back(indices[i] + mNumMatrixNodeIndices);
+	}
+	std::sort(indices.begin(), indices.end());
+	indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+	return indices;
+}
+
+template <typename VarType>
+void MnaSolver<VarType>::checkRightVectorStampIndices() {
+	// Only the rows outside of a stamp's own rows are checked, they are
+	// found with a row mask that is reset after each stamp
+	mRightVectorStampRowMask.resize(mRightSideVector.rows(), false);
+
+	// Fall back to the full stamp for components writing outside of their rows
+	for (UInt i = 0; i < mRightVectorStamps.size(); ++i) {
+		if (mRightVectorStampIndices[i].empty())
+			continue;
+		const Matrix& stamp = *mRightVectorStamps[i];
+		for (auto idx : mRightVectorStampIndices[i])
+			mRightVectorStampRowMask[idx] = true;
+		Bool outside = false;
+		for (Int row = 0; row < stamp.rows() && !outside; ++row)
+			outside = !mRightVectorStampRowMask[row] && !stamp.row(row).isZero(0);
+		for (auto idx : mRightVectorStampIndices[i])
+			mRightVectorStampRowMask[idx] = false;
+
+		if (outside) {
+			mSLog->warn("Right side vector stamp {:d} writes outside of its component's nodes", i);
+			mRightVectorStampIndices[i].clear();
+			mRightVectorStampComponents[i]->mnaSetRightVectorRows({});
+		}
+	}
+	mRightVectorStampIndicesChecked = true;
+}
+
+template <typename VarType>
+void MnaSolver<VarType>::assembleRightSideVector() {
+	mRightSideVector.setZero();
+
+	// The rows written by a component can change with switch events, so the stamps
+	// are checked on the first assembly and after each switch event
+	std::bitset<SWITCH_NUM> switchStatus;
+	for (UInt i = 0; i < mSwitches.size(); ++i)
+		switchStatus.set(i, mSwitches[i]->mnaIsClosed());
+	if (!mRightVectorStampIndicesChecked || switchStatus != mRightVectorStampSwitchStatus)
+		checkRightVectorStampIndices();
+	mRightVectorStampSwitchStatus = switchStatus;
+
+	for (UInt i = 0; i < mRightVectorStamps.size(); ++i) {
+		const Matrix& stamp = *mRightVectorStamps[i];
+		if (mRightVectorStampIndices[i].empty())
+			mRightSideVector += stamp;
+		else
+			for (auto idx : mRightVectorStampIndices[i])
+				mRightSideVector(idx, 0) += stamp(idx, 0);
+	}
+}
+
 template <typename VarType>
 void MnaSolver<VarType>::updateSwitchStatus() {
 	for (UInt i = 0; i < mSwitches.size(); ++i) {
@@ -378,7 +476,8 @@ void MnaSolver<Complex>::createEmptyVectors() {
 	if (mFrequencyParallel) {
 		for(Int freq = 0; freq < mSystem.mFrequencies.size(); ++freq) {
 			mRightSideVectorHarm.push_back(Matrix::Zero(2*(mNumMatrixNodeIndices), 1));
-			mLeftSideVectorHarm.push_back(Attribute<Matrix>::create("left_vector_harm_" + freq, mAttributes, Matrix::Zero(2*(mNumMatrixNodeIndices), 1)));
+			// The attributes are registered in initialize(), before the components are initialized with them
+			**mLeftSideVectorHarm[freq] = Matrix::Zero(2*(mNumMatrixNodeIndices), 1);
 		}
 	}
 	else {
@@ -536,7 +635,7 @@ void MnaSolver<VarType>::steadyStateInitialization() {
 }
 
 template <typename VarType>
-Task::List MnaSolver<VarType>::getTasks() {
+Task::List MnaSolver<VarType>::getComponentTasks() {
 	Task::List l;
 
 	for (auto comp : mMNAComponents) {
@@ -559,6 +658,13 @@ Task::List MnaSolver<VarType>::getTasks() {
 			l.push_back(task);
 		}
 	}
+	return l;
+}
+
+template <typename VarType>
+Task::List MnaSolver<VarType>::getTasks() {
+	Task::List l = getComponentTasks();
+
 	if (mFrequencyParallel) {
 		for (UInt i = 0; i < mSystem.mFrequencies.size(); ++i)
 			l.push_back(createSolveTaskHarm(i));
@@ -35,11 +35,14 @@ void MnaSolverEigenDense<VarType>::switchedMatrixStamp(std::size_t index, MNAInt
 	auto bit = std::bitset<SWITCH_NUM>(index);
 	auto& sys = mSwitchedMatrices[bit][0];
 
+	// Components stamp into a sparse matrix which is densified once afterwards
+	SparseMatrixRow sparseSys = sys.sparseView();
 	for (auto comp : components)
-		comp->mnaApplySystemMatrixStamp(sys);
+		comp->mnaApplySystemMatrixStamp(sparseSys);
 
 	for (UInt i = 0; i < mSwitches.size(); ++i)
-		mSwitches[i]->mnaApplySwitchSystemMatrixStamp(bit[i], sys, 0);
+		mSwitches[i]->mnaApplySwitchSystemMatrixStamp(bit[i], sparseSys, 0);
+	sys = Matrix(sparseSys);
 
 	// Compute LU-factorization for system matrix
 	mLuFactorizations[bit][0].compute(sys);
@@ -52,11 +55,13 @@ void MnaSolverEigenDense<VarType>::switchedMatrixStamp(std::size_t swIdx, Int fr
 	auto bit = std::bitset<SWITCH_NUM>(swIdx);
 	auto& sys = mSwitchedMatrices[bit][freqIdx];
 
+	SparseMatrixRow sparseSys = sys.sparseView();
 	for (auto comp : components)
-		comp->mnaApplySystemMatrixStampHarm(sys, freqIdx);
+		comp->mnaApplySystemMatrixStampHarm(sparseSys, freqIdx);
 
 	for (UInt i = 0; i < switches.size(); ++i)
-		switches[i]->mnaApplySwitchSystemMatrixStamp(bit[i], sys, freqIdx);
+		switches[i]->mnaApplySwitchSystemMatrixStamp(bit[i], sparseSys, freqIdx);
+	sys = Matrix(sparseSys);
 
 	mLuFactorizations[bit][freqIdx].compute(sys);
 }
@@ -116,13 +121,9 @@ std::shared_ptr<CPS::Task> MnaSolverEigenDense<VarType>::createLogTask()
 
 template <typename VarType>
 void MnaSolverEigenDense<VarType>::solve(Real time, Int timeStepCount) {
-	// Reset source vector
-	mRightSideVector.setZero();
-
 	// Add together the right side vector (computed by the components'
 	// pre-step tasks)
-	for (auto stamp : mRightVectorStamps)
-		mRightSideVector += *stamp;
+	assembleRightSideVector();
 
 	if (!mIsInInitialization)
 		MnaSolver<VarType>::updateSwitchStatus();
@@ -34,7 +34,28 @@ template <typename VarType>
 void MnaSolverEigenSparse<VarType>::switchedMatrixStamp(std::size_t index, std::vector<std::shared_ptr<CPS::MNAInterface>>& comp)
 {
 	auto bit = std::bitset<SWITCH_NUM>(index);
+	if (useComplexSystemMatrix()) {
+		if (complexSwitchedMatrixStamp(bit, comp))
+			return;
+
+		// Restamp the switch states handled so far as real split systems
+		mSLog->warn("System matrix is not complex linear, using real and imaginary part blocks");
+		mComplexSystemMatrix = false;
+		std::vector<std::bitset<SWITCH_NUM>> states;
+		for (auto& sys : mSwitchedMatricesComplex)
+			states.push_back(sys.first);
+		mSwitchedMatricesComplex.clear();
+		mLuFactorizationsComplex.clear();
+		for (auto state : states)
+			switchedMatrixStamp(state.to_ullong(), comp);
+	}
+
 	auto& sys = mSwitchedMatrices[bit][0];
+	if (!mUnionPatternAnalyzed)
+		analyzeUnionPattern(sys.rows());
+
+	// Start from the union pattern so that stamps only update existing entries
+	sys = mUnionPattern;
 	for (auto comp : comp) {
 		comp->mnaApplySystemMatrixStamp(sys);
 	}
@@ -42,8 +63,377 @@ void MnaSolverEigenSparse<VarType>::switchedMatrixStamp(std::size_t index, std::
 		mSwitches[i]->mnaApplySwitchSystemMatrixStamp(bit[i], sys, 0);
 
 	// Compute LU-factorization for system matrix
-	mLuFactorizations[bit][0]->analyzePattern(sys);
-	mLuFactorizations[bit][0]->factorize(sys);
+	if (mSwitchedMatrixFactorization)
+		factorizeSwitchedMatrix(bit, 0);
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::switchedMatrixStamp(std::size_t swIdx, Int freqIdx,
+	CPS::MNAInterface::List& components, CPS::MNASwitchInterface::List& switches) {
+
+	auto bit = std::bitset<SWITCH_NUM>(swIdx);
+	auto& sys = mSwitchedMatrices[bit][freqIdx];
+	if (!mUnionPatternAnalyzed)
+		analyzeUnionPattern(sys.rows());
+
+	sys = mUnionPattern;
+	for (auto comp : components)
+		comp->mnaApplySystemMatrixStampHarm(sys, freqIdx);
+	for (UInt i = 0; i < switches.size(); ++i)
+		switches[i]->mnaApplySwitchSystemMatrixStamp(bit[i], sys, freqIdx);
+
+	factorizeSwitchedMatrix(bit, freqIdx);
+}
+
+template <typename VarType>
+Bool MnaSolverEigenSparse<VarType>::useComplexSystemMatrix() {
+	return mComplexSystemMatrix && std::is_same<VarType, Complex>::value && !mFrequencyParallel
+		&& !mSystemMatrixRecomputation && mSystem.mFrequencies.size() == 1;
+}
+
+template <typename VarType>
+Bool MnaSolverEigenSparse<VarType>::complexSwitchedMatrixStamp(const std::bitset<SWITCH_NUM>& status,
+	CPS::MNAInterface::List& components) {
+
+	Int size = mRightSideVector.rows();
+	SparseMatrix split(size, size);
+	SparseMatrixComp sys(size / 2, size / 2);
+	for (auto comp : components) {
+		if (comp->mnaHasComplexSystemMatrixStamp())
+			comp->mnaApplyComplexSystemMatrixStamp(sys);
+		else
+			comp->mnaApplySystemMatrixStamp(split);
+	}
+	for (UInt i = 0; i < mSwitches.size(); ++i)
+		mSwitches[i]->mnaApplySwitchSystemMatrixStamp(status[i], split, 0);
+
+	if (!addComplexSplitMatrix(split, sys))
+		return false;
+
+	mSwitchedMatricesComplex[status] = sys;
+	if (!mSwitchedMatrixFactorization)
+		return true;
+
+	auto lu = std::make_shared<Eigen::SparseLU<CPS::SparseMatrixComp>>();
+	lu->compute(CPS::SparseMatrixComp(sys));
+	if (lu->info() != Eigen::Success)
+		throw SystemError("Factorization of complex system matrix of switch state " + status.to_string() + " failed");
+	mLuFactorizationsComplex[status] = lu;
+	return true;
+}
+
+template <typename VarType>
+Bool MnaSolverEigenSparse<VarType>::addComplexSplitMatrix(const SparseMatrix& split, SparseMatrixComp& mat) {
+	Int n = mat.rows();
+	SparseMatrix real = split.topLeftCorner(n, n);
+	SparseMatrix imag = split.bottomLeftCorner(n, n);
+
+	// The split form of a complex entry is [re -im; im re]
+	Real tolerance = 1e-12 * split.norm();
+	if (SparseMatrix(split.bottomRightCorner(n, n) - real).norm() > tolerance
+		|| SparseMatrix(split.topRightCorner(n, n) + imag).norm() > tolerance)
+		return false;
+
+	mat = mat + real.cast<Complex>() + imag.cast<Complex>() * Complex(0, 1);
+	mat.makeCompressed();
+	return true;
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::analyzeUnionPattern(Int size) {
+	mUnionPattern = SparseMatrix(size, size);
+	for (auto comp : mMNAComponents) {
+		if (mFrequencyParallel)
+			comp->mnaApplySystemMatrixStampHarm(mUnionPattern, 0);
+		else
+			comp->mnaApplySystemMatrixStamp(mUnionPattern);
+	}
+	for (auto sw : mSwitches) {
+		sw->mnaApplySwitchSystemMatrixStamp(false, mUnionPattern, 0);
+		sw->mnaApplySwitchSystemMatrixStamp(true, mUnionPattern, 0);
+	}
+	// Stamps are inserted in place, so squeeze out the reserved free space
+	mUnionPattern.makeCompressed();
+	mUnionPattern.coeffs().setZero();
+
+	if (mSwitchedMatrixFactorization)
+		analyzeUnionPatternSymbolic();
+	mUnionPatternAnalyzed = true;
+	mSLog->info("Union pattern of switch states with {:d} non-zeros", mUnionPattern.nonZeros());
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::analyzeUnionPatternSymbolic() {
+	mUnionPatternAnalysis.analyzePattern(mUnionPattern);
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::factorizeSwitchedMatrix(const std::bitset<SWITCH_NUM>& status, Int freqIdx) {
+	if (!mMixedPrecision) {
+		factorizeSwitchedMatrixDouble(status, freqIdx);
+		return;
+	}
+
+	auto& sys = mSwitchedMatrices[status][freqIdx];
+	auto& singles = mLuFactorizationsSingle[status];
+	if (singles.size() <= static_cast<std::size_t>(freqIdx))
+		singles.resize(freqIdx + 1);
+	auto lu = std::make_shared<LUFactorizedSparseSingle>();
+
+	Eigen::SparseMatrix<float> sysSingle = sys.template cast<float>();
+	if (sys.nonZeros() == mUnionPattern.nonZeros())
+		lu->adoptSymbolicAnalysis(mUnionPatternAnalysis, sysSingle);
+	else
+		lu->analyzePattern(sysSingle);
+	lu->factorize(sysSingle);
+
+	if (lu->info() == Eigen::Success) {
+		singles[freqIdx] = lu;
+	} else {
+		mSLog->warn("Single precision factorization of switch state {:s} failed, using double precision",
+			status.to_string());
+		singles[freqIdx].reset();
+		factorizeSwitchedMatrixDouble(status, freqIdx);
+	}
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::factorizeSwitchedMatrixDouble(const std::bitset<SWITCH_NUM>& status, Int freqIdx) {
+	auto& sys = mSwitchedMatrices.at(status)[freqIdx];
+	auto& lu = *mLuFactorizations.at(status)[freqIdx];
+	// Stamps outside of the union pattern add entries, which
+	// require an analysis of their own
+	if (sys.nonZeros() == mUnionPattern.nonZeros()) {
+		lu.adoptSymbolicAnalysis(mUnionPatternAnalysis, sys);
+	} else {
+		mSLog->debug("System matrix deviates from union pattern, analyzing separately");
+		sys.makeCompressed();
+		lu.analyzePattern(sys);
+	}
+	lu.factorize(sys);
+}
+
+template <typename VarType>
+Matrix MnaSolverEigenSparse<VarType>::solveSwitchedMatrix(const std::bitset<SWITCH_NUM>& status, Int freqIdx, const Matrix& rhs) {
+	auto complexLu = mLuFactorizationsComplex.find(status);
+	if (complexLu != mLuFactorizationsComplex.end()) {
+		Int n = rhs.rows() / 2;
+		MatrixComp complexRhs = rhs.topRows(n).cast<Complex>() + rhs.bottomRows(n).cast<Complex>() * Complex(0, 1);
+		MatrixComp complexSolution = complexLu->second->solve(complexRhs);
+		Matrix solution(rhs.rows(), rhs.cols());
+		solution.topRows(n) = complexSolution.real();
+		solution.bottomRows(n) = complexSolution.imag();
+		return solution;
+	}
+
+	// The frequencies are solved concurrently with frequency parallelization,
+	// so the shared maps are only looked up here and never inserted into
+	auto single = mLuFactorizationsSingle.find(status);
+	if (!mMixedPrecision || single == mLuFactorizationsSingle.end()
+		|| single->second.size() <= static_cast<std::size_t>(freqIdx) || !single->second[freqIdx])
+		return mLuFactorizations.at(status)[freqIdx]->solve(rhs);
+
+	auto& lu = *single->second[freqIdx];
+	auto& sys = mSwitchedMatrices.at(status)[freqIdx];
+
+	// Iterative refinement with the residual computed in double precision
+	Real tolerance = mMixedPrecisionTolerance * rhs.lpNorm<Eigen::Infinity>();
+	Matrix solution = lu.solve(rhs.cast<float>()).template cast<Real>();
+	Matrix residual = rhs - sys * solution;
+	for (UInt step = 0; step < mMixedPrecisionRefinementSteps
+		&& residual.lpNorm<Eigen::Infinity>() > tolerance; ++step) {
+		solution += lu.solve(residual.cast<float>()).template cast<Real>();
+		residual = rhs - sys * solution;
+	}
+	if (residual.lpNorm<Eigen::Infinity>() <= tolerance)
+		return solution;
+
+	// The switch state is too ill-conditioned for single precision factors
+	++mNumMixedPrecisionFallbacks;
+	mSLog->warn("Iterative refinement did not converge for switch state {:s}, refactorizing in double precision",
+		status.to_string());
+	single->second[freqIdx].reset();
+	factorizeSwitchedMatrixDouble(status, freqIdx);
+	return mLuFactorizations.at(status)[freqIdx]->solve(rhs);
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::releaseSwitchedMatrices() {
+	mSwitchedMatrices.clear();
+	mLuFactorizations.clear();
+	mLuFactorizationsSingle.clear();
+	mSwitchedMatricesComplex.clear();
+	mLuFactorizationsComplex.clear();
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::addScenario(std::shared_ptr<MnaSolverEigenSparse<VarType>> scenario) {
+	if (mSwitchedMatrixCaching || mSystemMatrixRecomputation || mFrequencyParallel)
+		throw SystemError("Scenarios require precomputed switch state matrices.");
+	if (scenario->mRightSideVector.rows() != mRightSideVector.rows()
+		|| scenario->mSwitches.size() != mSwitches.size())
+		throw SystemError("Scenario topology does not match the solver topology.");
+
+	// One factorization serves all scenarios, so only the right side vectors may differ
+	for (auto& sys : mSwitchedMatrices) {
+		auto other = scenario->mSwitchedMatrices.find(sys.first);
+		if (other == scenario->mSwitchedMatrices.end()
+			|| SparseMatrix(sys.second[0] - other->second[0]).norm() > 1e-12 * sys.second[0].norm())
+			throw SystemError("Scenario system matrices differ from the solver system matrices.");
+	}
+
+	for (auto& sys : mSwitchedMatricesComplex) {
+		auto other = scenario->mSwitchedMatricesComplex.find(sys.first);
+		if (other == scenario->mSwitchedMatricesComplex.end()
+			|| SparseMatrixComp(sys.second - other->second).norm() > 1e-12 * sys.second.norm())
+			throw SystemError("Scenario system matrices differ from the solver system matrices.");
+	}
+
+	scenario->releaseSwitchedMatrices();
+	mScenarios.push_back(scenario);
+	mSLog->info("Added scenario {:d}", mScenarios.size());
+}
+
+template <typename VarType>
+Task::List MnaSolverEigenSparse<VarType>::getTasks() {
+	Task::List l = MnaSolver<VarType>::getTasks();
+	for (auto scenario : mScenarios)
+		for (auto task : scenario->getComponentTasks())
+			l.push_back(task);
+	return l;
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::solveScenarios() {
+	// Group the scenarios by switch state, the first column belongs to this solver
+	std::vector<MnaSolverEigenSparse<VarType>*> solvers = { this };
+	std::unordered_map< std::bitset<SWITCH_NUM>, std::vector<UInt> > groups;
+	groups[mCurrentSwitchStatus].push_back(0);
+	for (auto scenario : mScenarios) {
+		scenario->assembleRightSideVector();
+		if (!scenario->mIsInInitialization)
+			scenario->updateSwitchStatus();
+		groups[scenario->mCurrentSwitchStatus].push_back(solvers.size());
+		solvers.push_back(scenario.get());
+	}
+
+	for (auto& group : groups) {
+		Matrix rhs(mRightSideVector.rows(), group.second.size());
+		for (UInt col = 0; col < group.second.size(); ++col)
+			rhs.col(col) = solvers[group.second[col]]->mRightSideVector;
+
+		Matrix solution = solveSwitchedMatrix(group.first, 0, rhs);
+		for (UInt col = 0; col < group.second.size(); ++col)
+			**solvers[group.second[col]]->mLeftSideVector = solution.col(col);
+	}
+
+	for (auto scenario : mScenarios)
+		for (UInt nodeIdx = 0; nodeIdx < scenario->mNumNetNodes; ++nodeIdx)
+			scenario->mNodes[nodeIdx]->mnaUpdateVoltage(**scenario->mLeftSideVector);
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::initializeSystem() {
+	// Component parameters may have changed since the last initialization
+	mUnionPatternAnalyzed = false;
+	mLuFactorizationsSingle.clear();
+	mSwitchedMatricesComplex.clear();
+	mLuFactorizationsComplex.clear();
+
+	if (mMixedPrecision && mSystemMatrixRecomputation)
+		mSLog->warn("Mixed precision solves are not supported with system matrix recomputation");
+	if (mMixedPrecision && useComplexSystemMatrix())
+		mSLog->warn("Mixed precision solves are not supported with complex system matrices");
+
+	if (!mSwitchedMatrixCaching || mFrequencyParallel || mSystemMatrixRecomputation) {
+		MnaSolver<VarType>::initializeSystem();
+		return;
+	}
+
+	mSLog->info("-- Initialize MNA system matrices on demand and source vector");
+	mRightSideVector.setZero();
+
+	clearSwitchedMatrixCache();
+
+	// Only the initial switch state is stamped and factorized here,
+	// all others follow when they are reached during simulation
+	if (mSwitches.size() > 0)
+		MnaSolver<VarType>::updateSwitchStatus();
+	cachedSwitchedFactorization(mCurrentSwitchStatus);
+
+	for (auto comp : mMNAComponents)
+		comp->mnaApplyRightSideVectorStamp(mRightSideVector);
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::cachedSwitchedFactorization(const std::bitset<SWITCH_NUM>& status) {
+	auto entry = mSwitchedCacheEntries.find(status);
+	if (entry != mSwitchedCacheEntries.end()) {
+		++mSwitchedCacheHits;
+		mSwitchedCacheOrder.splice(mSwitchedCacheOrder.begin(), mSwitchedCacheOrder, entry->second.first);
+		return;
+	}
+
+	++mSwitchedCacheMisses;
+	auto size = mRightSideVector.rows();
+	mSwitchedMatrices[status] = { SparseMatrix(size, size) };
+	mLuFactorizations[status] = { std::make_shared<LUFactorizedSparseShared>() };
+	switchedMatrixStamp(status.to_ullong(), mMNAComponents);
+
+	mSwitchedCacheOrder.push_front(status);
+	auto memory = switchedMatrixMemory(status);
+	mSwitchedCacheEntries[status] = { mSwitchedCacheOrder.begin(), memory };
+	mSwitchedCacheMemory += memory;
+
+	// Evict least recently used states, but always keep the one just created
+	while (mSwitchedMatrixCacheBudget > 0 && mSwitchedCacheMemory > mSwitchedMatrixCacheBudget
+		&& mSwitchedCacheOrder.size() > 1) {
+		auto victim = mSwitchedCacheOrder.back();
+		mSwitchedCacheOrder.pop_back();
+		mSwitchedCacheMemory -= mSwitchedCacheEntries[victim].second;
+		mSwitchedCacheEntries.erase(victim);
+		mSwitchedMatrices.erase(victim);
+		mLuFactorizations.erase(victim);
+		mLuFactorizationsSingle.erase(victim);
+		mSwitchedMatricesComplex.erase(victim);
+		mLuFactorizationsComplex.erase(victim);
+		++mSwitchedCacheEvictions;
+		mSLog->debug("Evicted switch state {:s} from cache", victim.to_string());
+	}
+}
+
+template <typename VarType>
+std::size_t MnaSolverEigenSparse<VarType>::switchedMatrixMemory(const std::bitset<SWITCH_NUM>& status) {
+	auto complexLu = mLuFactorizationsComplex.find(status);
+	if (complexLu != mLuFactorizationsComplex.end()) {
+		auto& sys = mSwitchedMatricesComplex[status];
+		const std::size_t entrySize = sizeof(Complex) + sizeof(SparseMatrix::StorageIndex);
+		return 2 * (sys.nonZeros() * entrySize + (sys.outerSize() + 1) * sizeof(SparseMatrix::StorageIndex))
+			+ (complexLu->second->nnzL() + complexLu->second->nnzU()) * entrySize
+			+ 4 * sys.rows() * sizeof(SparseMatrix::StorageIndex);
+	}
+
+	auto& sys = mSwitchedMatrices[status][0];
+	const std::size_t entrySize = sizeof(Real) + sizeof(SparseMatrix::StorageIndex);
+	std::size_t factorMemory;
+	auto single = mLuFactorizationsSingle.find(status);
+	if (single != mLuFactorizationsSingle.end() && single->second[0])
+		factorMemory = (single->second[0]->nnzL() + single->second[0]->nnzU())
+			* (sizeof(float) + sizeof(SparseMatrix::StorageIndex));
+	else
+		factorMemory = (mLuFactorizations[status][0]->nnzL() + mLuFactorizations[status][0]->nnzU()) * entrySize;
+	// The factorization keeps a permuted copy of the matrix next to its factors
+	// and stores row and column permutations besides the supernodal structure
+	return 2 * (sys.nonZeros() * entrySize + (sys.outerSize() + 1) * sizeof(SparseMatrix::StorageIndex))
+		+ factorMemory + 4 * sys.rows() * sizeof(SparseMatrix::StorageIndex);
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::clearSwitchedMatrixCache() {
+	mSwitchedCacheOrder.clear();
+	mSwitchedCacheEntries.clear();
+	mSwitchedCacheMemory = 0;
+	releaseSwitchedMatrices();
 }
 
 template <typename VarType>
@@ -58,6 +448,7 @@ void MnaSolverEigenSparse<VarType>::stampVariableSystemMatrix() {
 	mBaseSystemMatrix.setZero();
 	for (auto statElem : mMNAComponents)
 		statElem->mnaApplySystemMatrixStamp(mBaseSystemMatrix);
+	mBaseSystemMatrix.makeCompressed();
 	mSLog->info("Base matrix with only static elements: {}", Logger::matrixToString(mBaseSystemMatrix));
 	mSLog->flush();
 	
@@ -73,24 +464,32 @@ void MnaSolverEigenSparse<VarType>::stampVariableSystemMatrix() {
 	mSLog->info("Stamping variable elements");
 	for (auto varElem : mMNAIntfVariableComps)
 		varElem->mnaApplySystemMatrixStamp(mVariableSystemMatrix);
+	mVariableSystemMatrix.makeCompressed();
 
 	mSLog->info("Initial system matrix with variable elements {}", Logger::matrixToString(mVariableSystemMatrix));
 	mSLog->flush();
 
 	// Calculate factorization of current matrix
-	mLuFactorizationVariableSystemMatrix.analyzePattern(mVariableSystemMatrix);
+	factorizeVariableSystemMatrix(true);
+}
+
+template <typename VarType>
+void MnaSolverEigenSparse<VarType>::factorizeVariableSystemMatrix(Bool analyzePattern) {
+	if (analyzePattern)
+		mLuFactorizationVariableSystemMatrix.analyzePattern(mVariableSystemMatrix);
 	mLuFactorizationVariableSystemMatrix.factorize(mVariableSystemMatrix);
+
+	// Low-rank updates are relative to the factorized matrix
+	mFactorizedSystemMatrix = mVariableSystemMatrix;
+	mInverseColumns.clear();
+	mLowRankActive = false;
 }
 
 template <typename VarType>
 void MnaSolverEigenSparse<VarType>::solveWithSystemMatrixRecomputation(Real time, Int timeStepCount) {
-	// Reset source vector
-	mRightSideVector.setZero();
-	
 	// Add together the right side vector (computed by the components'
 	// pre-step tasks)
-	for (auto stamp : mRightVectorStamps)
-		mRightSideVector += *stamp;
+	assembleRightSideVector();
 
 	// Get switch and variable comp status and update system matrix and lu factorization accordingly
 	if (hasVariableComponentChanged())
@@ -99,6 +498,14 @@ void MnaSolverEigenSparse<VarType>::solveWithSystemMatrixRecomputation(Real time
 	// Calculate new solution vector
 	**mLeftSideVector = mLuFactorizationVariableSystemMatrix.solve(mRightSideVector);
 
+	// Correct the solution by the low-rank update (Woodbury identity)
+	if (mLowRankActive) {
+		Matrix projection(mLowRankCols.size(), 1);
+		for (UInt k = 0; k < mLowRankCols.size(); ++k)
+			projection(k, 0) = (**mLeftSideVector)(mLowRankCols[k], 0);
+		**mLeftSideVector -= mLowRankInverseColumns * (mLowRankCorrection * mLowRankCapacitance.solve(projection));
+	}
+
 	// TODO split into separate task? (dependent on x, updating all v attributes)
 	for (UInt nodeIdx = 0; nodeIdx < mNumNetNodes; ++nodeIdx)
 		mNodes[nodeIdx]->mnaUpdateVoltage(**mLeftSideVector);
@@ -118,13 +525,113 @@ void MnaSolverEigenSparse<VarType>::recomputeSystemMatrix(Real time) {
 	// Now stamp variable elements into matrix
 	for (auto comp : mMNAIntfVariableComps)
 		comp->mnaApplySystemMatrixStamp(mVariableSystemMatrix);
+	mVariableSystemMatrix.makeCompressed();
+
+	if (mLowRankUpdate && updateLowRankCorrection()) {
+		++mNumLowRankUpdates;
+		return;
+	}
 
 	// Refactorization of matrix assuming that structure remained
 	// constant by omitting analyzePattern
-	mLuFactorizationVariableSystemMatrix.factorize(mVariableSystemMatrix);
+	factorizeVariableSystemMatrix(false);
 	++mNumRecomputations;
 }
 
+template <typename VarType>
+Bool MnaSolverEigenSparse<VarType>::updateLowRankCorrection() {
+	// Check whether all changing entries are declared by the components
+	Bool entriesDeclared = true;
+	for (auto varElem : mVariableComps)
+		entriesDeclared &= !varElem->mVariableSystemMatrixEntries.empty();
+	for (auto sw : mSwitches)
+		entriesDeclared &= std::dynamic_pointer_cast<MNAVariableCompInterface>(sw) != nullptr;
+
+	// Collect differences to the factorized matrix
+	std::map<std::pair<UInt, UInt>, Real> delta;
+	if (entriesDeclared) {
+		// Complex systems are split into real and imaginary part blocks
+		UInt offset = std::is_same<VarType, Complex>::value ? mRightSideVector.rows() / 2 : 0;
+		for (auto entry : mListVariableSystemMatrixEntries) {
+			std::vector<std::pair<UInt, UInt>> positions = { entry };
+			if (offset > 0) {
+				positions.push_back({ entry.first + offset, entry.second });
+				positions.push_back({ entry.first, entry.second + offset });
+				positions.push_back({ entry.first + offset, entry.second + offset });
+			}
+			for (auto pos : positions) {
+				Real diff = mVariableSystemMatrix.coeff(pos.first, pos.second)
+					- mFactorizedSystemMatrix.coeff(pos.first, pos.second);
+				if (diff != 0)
+					delta[pos] = diff;
+			}
+		}
+	} else {
+		SparseMatrix diff = mVariableSystemMatrix - mFactorizedSystemMatrix;
+		for (Int row = 0; row < diff.outerSize(); ++row)
+			for (SparseMatrix::InnerIterator it(diff, row); it; ++it)
+				if (it.value() != 0)
+					delta[{ static_cast<UInt>(it.row()), static_cast<UInt>(it.col()) }] = it.value();
+	}
+
+	if (delta.empty()) {
+		mLowRankActive = false;
+		return true;
+	}
+
+	std::map<UInt, UInt> rows, cols;
+	for (auto entry : delta) {
+		rows.emplace(entry.first.first, 0);
+		cols.emplace(entry.first.second, 0);
+	}
+	if (rows.size() > mLowRankUpdateMaxRank || cols.size() > mLowRankUpdateMaxRank)
+		return false;
+
+	UInt idx = 0;
+	for (auto& row : rows)
+		row.second = idx++;
+	idx = 0;
+	mLowRankCols.clear();
+	for (auto& col : cols) {
+		col.second = idx++;
+		mLowRankCols.push_back(col.first);
+	}
+
+	// Changed block C and inverse columns Z = A^-1 U for the changed rows
+	mLowRankCorrection = Matrix::Zero(rows.size(), cols.size());
+	for (auto entry : delta)
+		mLowRankCorrection(rows[entry.first.first], cols[entry.first.second]) = entry.second;
+	mLowRankInverseColumns = Matrix(mRightSideVector.rows(), rows.size());
+	for (auto row : rows)
+		mLowRankInverseColumns.col(row.second) = inverseColumn(row.first);
+
+	// Capacitance matrix I + V^T Z C
+	Matrix capacitance = Matrix::Identity(cols.size(), cols.size());
+	for (auto col : cols)
+		capacitance.row(col.second) += mLowRankInverseColumns.row(col.first) * mLowRankCorrection;
+	mLowRankCapacitance.compute(capacitance);
+
+	// Refactorize if the update is close to singular
+	if (mLowRankCapacitance.rcond() < 1e-12) {
+		mSLog->debug("Ill-conditioned low-rank update, refactorizing system matrix");
+		return false;
+	}
+
+	mLowRankActive = true;
+	return true;
+}
+
+template <typename VarType>
+const Matrix& MnaSolverEigenSparse<VarType>::inverseColumn(UInt index) {
+	auto column = mInverseColumns.find(index);
+	if (column != mInverseColumns.end())
+		return column->second;
+
+	Matrix unit = Matrix::Zero(mRightSideVector.rows(), 1);
+	unit(index, 0) = 1;
+	return mInverseColumns[index] = mLuFactorizationVariableSystemMatrix.solve(unit);
+}
+
 template <>
 void MnaSolverEigenSparse<Real>::createEmptySystemMatrix() {
 	if (mSwitches.size() > SWITCH_NUM)
@@ -133,11 +640,11 @@ void MnaSolverEigenSparse<Real>::createEmptySystemMatrix() {
 	if (mSystemMatrixRecomputation) {
 		mBaseSystemMatrix = SparseMatrix(mNumMatrixNodeIndices, mNumMatrixNodeIndices);
 		mVariableSystemMatrix = SparseMatrix(mNumMatrixNodeIndices, mNumMatrixNodeIndices);
-	} else {
+	} else if (!mSwitchedMatrixCaching) {
 		for (std::size_t i = 0; i < (1ULL << mSwitches.size()); i++){
 			auto bit = std::bitset<SWITCH_NUM>(i);
 			mSwitchedMatrices[bit].push_back(SparseMatrix(mNumMatrixNodeIndices, mNumMatrixNodeIndices));
-			mLuFactorizations[bit].push_back(std::make_shared<LUFactorizedSparse>());
+			mLuFactorizations[bit].push_back(std::make_shared<LUFactorizedSparseShared>());
 		}
 	}
 }
@@ -152,17 +659,17 @@ void MnaSolverEigenSparse<Complex>::createEmptySystemMatrix() {
 			for(Int freq = 0; freq < mSystem.mFrequencies.size(); ++freq) {
 				auto bit = std::bitset<SWITCH_NUM>(i);
 				mSwitchedMatrices[bit].push_back(SparseMatrix(2*(mNumMatrixNodeIndices), 2*(mNumMatrixNodeIndices)));
-				mLuFactorizations[bit].push_back(std::make_shared<LUFactorizedSparse>());
+				mLuFactorizations[bit].push_back(std::make_shared<LUFactorizedSparseShared>());
 			}
 		}
 	} else if (mSystemMatrixRecomputation) {
 		mBaseSystemMatrix = SparseMatrix(2*(mNumMatrixNodeIndices), 2*(mNumMatrixNodeIndices));
 		mVariableSystemMatrix = SparseMatrix(2*(mNumMatrixNodeIndices), 2*(mNumMatrixNodeIndices));
-	} else {
+	} else if (!mSwitchedMatrixCaching) {
 		for (std::size_t i = 0; i < (1ULL << mSwitches.size()); i++) {
 			auto bit = std::bitset<SWITCH_NUM>(i);
 			mSwitchedMatrices[bit].push_back(SparseMatrix(2*(mNumTotalMatrixNodeIndices), 2*(mNumTotalMatrixNodeIndices)));
-			mLuFactorizations[bit].push_back(std::make_shared<LUFactorizedSparse>());
+			mLuFactorizations[bit].push_back(std::make_shared<LUFactorizedSparseShared>());
 		}
 	}
 }
@@ -193,19 +700,20 @@ std::shared_ptr<CPS::Task> MnaSolverEigenSparse<VarType>::createLogTask()
 
 template <typename VarType>
 void MnaSolverEigenSparse<VarType>::solve(Real time, Int timeStepCount) {
-	// Reset source vector
-	mRightSideVector.setZero();
-
 	// Add together the right side vector (computed by the components'
 	// pre-step tasks)
-	for (auto stamp : mRightVectorStamps)
-		mRightSideVector += *stamp;
+	assembleRightSideVector();
 
 	if (!mIsInInitialization)
 		MnaSolver<VarType>::updateSwitchStatus();
 
-	if (mSwitchedMatrices.size() > 0)
-		**mLeftSideVector = mLuFactorizations[mCurrentSwitchStatus][0]->solve(mRightSideVector);
+	if (mScenarios.size() > 0) {
+		solveScenarios();
+	} else if (mSwitchedMatrixCaching) {
+		cachedSwitchedFactorization(mCurrentSwitchStatus);
+		**mLeftSideVector = solveSwitchedMatrix(mCurrentSwitchStatus, 0, mRightSideVector);
+	} else if (mSwitchedMatrices.size() > 0)
+		**mLeftSideVector = solveSwitchedMatrix(mCurrentSwitchStatus, 0, mRightSideVector);
 
 
 	// TODO split into separate task? (dependent on x, updating all v attributes)
@@ -223,7 +731,7 @@ void MnaSolverEigenSparse<VarType>::solveWithHarmonics(Real time, Int timeStepCo
 	for (auto stamp : mRightVectorStamps)
 		mRightSideVectorHarm[freqIdx] += stamp->col(freqIdx);
 
-	**mLeftSideVectorHarm[freqIdx] = mLuFactorizations[mCurrentSwitchStatus][freqIdx]->solve(mRightSideVectorHarm[freqIdx]);
+	**mLeftSideVectorHarm[freqIdx] = solveSwitchedMatrix(mCurrentSwitchStatus, freqIdx, mRightSideVectorHarm[freqIdx]);
 }
 
 template <typename VarType>
@@ -246,6 +754,11 @@ void MnaSolverEigenSparse<VarType>::logSystemMatrices() {
 		mSLog->info("Base matrix with only static elements: {}", Logger::matrixToString(mBaseSystemMatrix));
 		mSLog->info("Initial system matrix with variable elements {}", Logger::matrixToString(mVariableSystemMatrix));
 		mSLog->info("Right side vector: {}", Logger::matrixToString(mRightSideVector));
+	} else if (mSwitchedMatricesComplex.size() > 0) {
+		for (auto& sys : mSwitchedMatricesComplex)
+			mSLog->info("Complex system matrix {:s} \n{:s}",
+				sys.first.to_string(), Logger::sparseMatrixCompToString(sys.second));
+		mSLog->info("Right side vector: \n{}", mRightSideVector);
 	} else {
 		if (mSwitches.size() < 1) {
 			mSLog->info("System matrix: \n{}", mSwitchedMatrices[std::bitset<SWITCH_NUM>(0)][0]);
@@ -162,13 +162,9 @@ Task::List MnaSolverGpuDense<VarType>::getTasks() {
 
 template <typename VarType>
 void MnaSolverGpuDense<VarType>::solve(Real time, Int timeStepCount) {
-    // Reset source vector
-	this->mRightSideVector.setZero();
-
     // Add together the right side vector (computed by the components'
 	// pre-step tasks)
-	for (const auto &stamp : this->mRightVectorStamps)
-		this->mRightSideVector += *stamp;
+    this->assembleRightSideVector();
 
     if (!this->mIsInInitialization)
 		this->updateSwitchStatus();
@@ -151,13 +151,9 @@ template <typename VarType>
 void MnaSolverGpuMagma<VarType>::solve(Real time, Int timeStepCount) {
 	int size = this->mRightSideVector.rows();
 	int one = 0;
-    // Reset source vector
-	this->mRightSideVector.setZero();
-
     // Add together the right side vector (computed by the components'
 	// pre-step tasks)
-	for (const auto &stamp : this->mRightVectorStamps)
-		this->mRightSideVector += *stamp;
+    this->assembleRightSideVector();
 
 	if (!this->mIsInInitialization)
 		this->updateSwitchStatus();
@@ -242,13 +242,9 @@ void MnaSolverGpuSparse<VarType>::solve(Real time, Int timeStepCount) {
 	cudaError_t status;
 	cusparseStatus_t csp_status;
 	int size = this->mRightSideVector.rows();
-    // Reset source vector
-	this->mRightSideVector.setZero();
-
     // Add together the right side vector (computed by the components'
 	// pre-step tasks)
-	for (const auto &stamp : this->mRightVectorStamps)
-		this->mRightSideVector += *stamp;
+    this->assembleRightSideVector();
 
 	if (!this->mIsInInitialization)
 		this->updateSwitchStatus();
@@ -0,0 +1,138 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <dpsim/MNASolverKLU.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+namespace DPsim {
+
+template <typename VarType>
+MnaSolverKLU<VarType>::MnaSolverKLU(String name, CPS::Domain domain, CPS::Logger::Level logLevel) :
+	MnaSolverEigenSparse<VarType>(name, domain, logLevel) {
+}
+
+template <typename VarType>
+void MnaSolverKLU<VarType>::initialize() {
+	// Switch states are few compared to the refactorizations that are
+	// cheap with KLU, so all of them are precomputed
+	if (mSwitchedMatrixCaching) {
+		mSLog->warn("On-demand switch state caching is not supported by the KLU implementation, precomputing all states");
+		mSwitchedMatrixCaching = false;
+	}
+	if (mLowRankUpdate) {
+		mSLog->warn("Low-rank updates are not supported by the KLU implementation, refactorizing instead");
+		mLowRankUpdate = false;
+	}
+	if (mComplexSystemMatrix) {
+		mSLog->warn("Complex system matrices are not supported by the KLU implementation, using real and imaginary part blocks");
+		mComplexSystemMatrix = false;
+	}
+	if (mMixedPrecision) {
+		mSLog->warn("Mixed precision solves are not supported by the KLU implementation, using double precision");
+		mMixedPrecision = false;
+	}
+	MnaSolverEigenSparse<VarType>::initialize();
+}
+
+template <typename VarType>
+void MnaSolverKLU<VarType>::analyzeUnionPatternSymbolic() {
+	mUnionPatternKLU.analyzePattern(mUnionPattern);
+	mSLog->info("Block triangular form of union pattern with {:d} blocks", mUnionPatternKLU.numBlocks());
+}
+
+template <typename VarType>
+void MnaSolverKLU<VarType>::factorizeSwitchedMatrix(const std::bitset<SWITCH_NUM>& status, Int freqIdx) {
+	auto& sys = mSwitchedMatrices[status][freqIdx];
+	sys.makeCompressed();
+
+	auto& lus = mKLUFactorizations[status];
+	if (lus.size() <= static_cast<std::size_t>(freqIdx))
+		lus.resize(freqIdx + 1);
+	auto& lu = lus[freqIdx];
+
+	// All switch states share the block triangular form and orderings of the union pattern
+	if (sys.nonZeros() == mUnionPattern.nonZeros()) {
+		lu = mUnionPatternKLU;
+	} else {
+		mSLog->debug("System matrix deviates from union pattern, analyzing separately");
+		lu.analyzePattern(sys);
+	}
+	lu.factorize(sys);
+}
+
+template <typename VarType>
+std::vector<Int> MnaSolverKLU<VarType>::declaredVaryingColumns() {
+	// Complex systems are split into real and imaginary part blocks
+	Int offset = std::is_same<VarType, Complex>::value ? mRightSideVector.rows() / 2 : 0;
+	std::vector<Int> columns;
+	for (auto entry : mListVariableSystemMatrixEntries) {
+		columns.push_back(entry.second);
+		if (offset > 0)
+			columns.push_back(entry.second + offset);
+	}
+	return columns;
+}
+
+template <typename VarType>
+void MnaSolverKLU<VarType>::factorizeVariableSystemMatrix(Bool analyzePattern) {
+	if (analyzePattern) {
+		mKLUVariableSystemMatrix.analyzePattern(mVariableSystemMatrix, declaredVaryingColumns());
+		mKLUVariableSystemMatrix.factorize(mVariableSystemMatrix);
+		mSLog->info("Block triangular form of variable system matrix with {:d} blocks, nnz(L) = {:d}, nnz(U) = {:d}",
+			mKLUVariableSystemMatrix.numBlocks(), mKLUVariableSystemMatrix.nnzL(), mKLUVariableSystemMatrix.nnzU());
+	} else {
+		// Numeric refactorization of the columns affected by changed values
+		mKLUVariableSystemMatrix.refactorize(mVariableSystemMatrix);
+
+		// Order columns found to vary last, so that following
+		// refactorizations only update the trailing part of the factors
+		if (mKLUVariableSystemMatrix.hasNewVaryingColumns()) {
+			auto columns = mKLUVariableSystemMatrix.varyingColumns();
+			mSLog->debug("Reordering system matrix with {:d} varying columns", columns.size());
+			mKLUVariableSystemMatrix.analyzePattern(mVariableSystemMatrix, columns);
+			mKLUVariableSystemMatrix.factorize(mVariableSystemMatrix);
+		}
+	}
+}
+
+template <typename VarType>
+void MnaSolverKLU<VarType>::solveWithSystemMatrixRecomputation(Real time, Int timeStepCount) {
+	// Add together the right side vector (computed by the components'
+	// pre-step tasks)
+	assembleRightSideVector();
+
+	// Get switch and variable comp status and update system matrix and lu factorization accordingly
+	if (hasVariableComponentChanged())
+		recomputeSystemMatrix(time);
+
+	// Calculate new solution vector
+	**mLeftSideVector = mKLUVariableSystemMatrix.solve(mRightSideVector);
+
+	for (UInt nodeIdx = 0; nodeIdx < mNumNetNodes; ++nodeIdx)
+		mNodes[nodeIdx]->mnaUpdateVoltage(**mLeftSideVector);
+
+	// Components' states will be updated by the post-step tasks
+}
+
+template <typename VarType>
+Matrix MnaSolverKLU<VarType>::solveSwitchedMatrix(const std::bitset<SWITCH_NUM>& status, Int freqIdx, const Matrix& rhs) {
+	return mKLUFactorizations[status][freqIdx].solve(rhs);
+}
+
+template <typename VarType>
+void MnaSolverKLU<VarType>::releaseSwitchedMatrices() {
+	MnaSolverEigenSparse<VarType>::releaseSwitchedMatrices();
+	mKLUFactorizations.clear();
+}
+
+}
+
+template class DPsim::MnaSolverKLU<Real>;
+template class DPsim::MnaSolverKLU<Complex>;
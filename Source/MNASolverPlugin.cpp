@@ -55,6 +55,7 @@ void MnaSolverPlugin<VarType>::recomputeSystemMatrix(Real time) {
 	// Now stamp variable elements into matrix
 	for (auto comp : this->mMNAIntfVariableComps)
 		comp->mnaApplySystemMatrixStamp(this->mVariableSystemMatrix);
+	this->mVariableSystemMatrix.makeCompressed();
 
     int size = this->mRightSideVector.rows();
 	int nnz = this->mVariableSystemMatrix.nonZeros();
@@ -143,13 +144,9 @@ Task::List MnaSolverPlugin<VarType>::getTasks() {
 
 template <typename VarType>
 void MnaSolverPlugin<VarType>::solve(Real time, Int timeStepCount) {
-    // Reset source vector
-	this->mRightSideVector.setZero();
-
     // Add together the right side vector (computed by the components'
 	// pre-step tasks)
-	for (const auto &stamp : this->mRightVectorStamps)
-		this->mRightSideVector += *stamp;
+    this->assembleRightSideVector();
 
 	if (!this->mIsInInitialization)
 		this->updateSwitchStatus();
@@ -0,0 +1,557 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <dpsim/NetworkPartitioner.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <cps/SimPowerComp.h>
+#include <cps/Solver/MNATearInterface.h>
+
+using namespace CPS;
+using namespace DPsim;
+
+using Graph = NetworkPartitioner::Graph;
+using Edge = std::array<Int, 3>;
+
+Int NetworkPartitioner::Graph::totalWeight() const {
+	return std::accumulate(vertexWeights.begin(), vertexWeights.end(), 0);
+}
+
+Graph NetworkPartitioner::Graph::fromEdges(std::vector<Int> vertexWeights, const std::vector<Edge>& edges) {
+	Int n = static_cast<Int>(vertexWeights.size());
+	std::vector<Int> offsets(n + 1, 0);
+	for (auto& e : edges) {
+		offsets[e[0] + 1]++;
+		offsets[e[1] + 1]++;
+	}
+	for (Int v = 0; v < n; v++)
+		offsets[v + 1] += offsets[v];
+	std::vector<Int> adjacency(offsets[n]), weights(offsets[n]);
+	std::vector<Int> fill(offsets.begin(), offsets.end() - 1);
+	for (auto& e : edges) {
+		adjacency[fill[e[0]]] = e[1];
+		weights[fill[e[0]]++] = e[2];
+		adjacency[fill[e[1]]] = e[0];
+		weights[fill[e[1]]++] = e[2];
+	}
+
+	Graph graph;
+	graph.vertexWeights = std::move(vertexWeights);
+	std::vector<Int> pos(n, -1);
+	for (Int v = 0; v < n; v++) {
+		Int start = static_cast<Int>(graph.adjacency.size());
+		for (Int k = offsets[v]; k < offsets[v + 1]; k++) {
+			Int u = adjacency[k];
+			if (pos[u] >= start) {
+				graph.edgeWeights[pos[u]] += weights[k];
+			} else {
+				pos[u] = static_cast<Int>(graph.adjacency.size());
+				graph.adjacency.push_back(u);
+				graph.edgeWeights.push_back(weights[k]);
+			}
+		}
+		graph.offsets.push_back(static_cast<Int>(graph.adjacency.size()));
+	}
+	return graph;
+}
+
+static Graph subgraph(const Graph& graph, const std::vector<Int>& vertices) {
+	std::vector<Int> local(graph.size(), -1);
+	std::vector<Int> weights;
+	for (Int v : vertices) {
+		local[v] = static_cast<Int>(weights.size());
+		weights.push_back(graph.vertexWeights[v]);
+	}
+	std::vector<Edge> edges;
+	for (Int v : vertices) {
+		for (Int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++) {
+			Int u = graph.adjacency[k];
+			if (v < u && local[u] >= 0)
+				edges.push_back({local[v], local[u], graph.edgeWeights[k]});
+		}
+	}
+	return Graph::fromEdges(std::move(weights), edges);
+}
+
+// Contracts a heavy edge matching, returns the coarse vertex of each vertex
+static std::vector<Int> coarsen(const Graph& graph, Int maxWeight, Graph& coarse) {
+	Int n = graph.size();
+	std::vector<Int> order(n);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&graph](Int a, Int b) {
+		return graph.offsets[a + 1] - graph.offsets[a] < graph.offsets[b + 1] - graph.offsets[b];
+	});
+
+	std::vector<Int> match(n, -1);
+	for (Int v : order) {
+		if (match[v] >= 0)
+			continue;
+		Int best = v, bestWeight = 0;
+		for (Int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++) {
+			Int u = graph.adjacency[k];
+			if (match[u] < 0 && graph.edgeWeights[k] > bestWeight
+				&& graph.vertexWeights[v] + graph.vertexWeights[u] <= maxWeight) {
+				best = u;
+				bestWeight = graph.edgeWeights[k];
+			}
+		}
+		match[v] = best;
+		match[best] = v;
+	}
+
+	std::vector<Int> map(n, -1), weights;
+	for (Int v : order) {
+		if (map[v] >= 0)
+			continue;
+		map[v] = map[match[v]] = static_cast<Int>(weights.size());
+		weights.push_back(graph.vertexWeights[v] + (match[v] != v ? graph.vertexWeights[match[v]] : 0));
+	}
+	std::vector<Edge> edges;
+	for (Int v = 0; v < n; v++) {
+		for (Int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++) {
+			Int u = graph.adjacency[k];
+			if (v < u && map[v] != map[u])
+				edges.push_back({map[v], map[u], graph.edgeWeights[k]});
+		}
+	}
+	coarse = Graph::fromEdges(std::move(weights), edges);
+	return map;
+}
+
+namespace {
+	// Target weight of side 0 of a bisection
+	struct Balance {
+		Int target;
+		Int tolerance;
+
+		Int deviation(Int weight) const { return std::abs(weight - target); }
+		Bool ok(Int weight) const { return deviation(weight) <= tolerance; }
+		// Balanced bisections are preferred, then the smaller cut
+		std::array<Int, 3> score(Int weight, Int cut) const {
+			if (ok(weight))
+				return {0, cut, deviation(weight)};
+			return {1, deviation(weight), cut};
+		}
+	};
+}
+
+static Int gainOf(const Graph& graph, const std::vector<Int>& part, Int v) {
+	Int gain = 0;
+	for (Int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++)
+		gain += part[graph.adjacency[k]] != part[v] ? graph.edgeWeights[k] : -graph.edgeWeights[k];
+	return gain;
+}
+
+static Int cutOf(const Graph& graph, const std::vector<Int>& part) {
+	Int cut = 0;
+	for (Int v = 0; v < graph.size(); v++) {
+		for (Int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++) {
+			if (part[graph.adjacency[k]] != part[v])
+				cut += graph.edgeWeights[k];
+		}
+	}
+	return cut / 2;
+}
+
+static Int weightOf(const Graph& graph, const std::vector<Int>& part) {
+	Int weight = 0;
+	for (Int v = 0; v < graph.size(); v++) {
+		if (part[v] == 0)
+			weight += graph.vertexWeights[v];
+	}
+	return weight;
+}
+
+// Fiduccia-Mattheyses passes, each pass moves every vertex at most once
+// and keeps the best prefix of the moves
+static void refine(const Graph& graph, std::vector<Int>& part, const Balance& balance) {
+	const Int MaxPasses = 10;
+	const Int MaxMovesWithoutImprovement = 100;
+
+	Int n = graph.size();
+	Int weight = weightOf(graph, part);
+	std::vector<Int> gain(n);
+	std::vector<Bool> locked(n);
+	for (Int pass = 0; pass < MaxPasses; pass++) {
+		std::priority_queue<std::pair<Int, Int>> queue;
+		for (Int v = 0; v < n; v++) {
+			gain[v] = gainOf(graph, part, v);
+			for (Int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++) {
+				if (part[graph.adjacency[k]] != part[v]) {
+					queue.emplace(gain[v], v);
+					break;
+				}
+			}
+		}
+		locked.assign(n, false);
+
+		std::vector<Int> moves;
+		Int cut = 0;
+		auto best = balance.score(weight, cut);
+		size_t bestMoves = 0;
+		Int sinceBest = 0;
+		while (!queue.empty() && sinceBest < MaxMovesWithoutImprovement) {
+			Int v = queue.top().second;
+			Bool stale = queue.top().first != gain[v];
+			queue.pop();
+			if (locked[v] || stale)
+				continue;
+			Int newWeight = part[v] == 0 ? weight - graph.vertexWeights[v] : weight + graph.vertexWeights[v];
+			if (!balance.ok(newWeight) && balance.deviation(newWeight) >= balance.deviation(weight))
+				continue;
+
+			locked[v] = true;
+			part[v] ^= 1;
+			weight = newWeight;
+			cut -= gain[v];
+			moves.push_back(v);
+			for (Int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++) {
+				Int u = graph.adjacency[k];
+				gain[u] += part[u] == part[v] ? -2 * graph.edgeWeights[k] : 2 * graph.edgeWeights[k];
+				if (!locked[u])
+					queue.emplace(gain[u], u);
+			}
+
+			auto score = balance.score(weight, cut);
+			if (score < best) {
+				best = score;
+				bestMoves = moves.size();
+				sinceBest = 0;
+			} else {
+				sinceBest++;
+			}
+		}
+
+		for (size_t i = moves.size(); i > bestMoves; i--) {
+			Int v = moves[i - 1];
+			weight += part[v] == 0 ? -graph.vertexWeights[v] : graph.vertexWeights[v];
+			part[v] ^= 1;
+		}
+		if (bestMoves == 0)
+			break;
+	}
+}
+
+// Greedy graph growing from a seed vertex, the vertex that adds the least cut joins next
+static std::vector<Int> grow(const Graph& graph, Int seed, const Balance& balance) {
+	Int n = graph.size();
+	std::vector<Int> part(n, 1), gain(n);
+	std::vector<Bool> done(n, false);
+	for (Int v = 0; v < n; v++)
+		gain[v] = gainOf(graph, part, v);
+
+	std::priority_queue<std::pair<Int, Int>> queue;
+	queue.emplace(gain[seed], seed);
+	Int weight = 0, next = 0;
+	while (weight < balance.target) {
+		if (queue.empty()) {
+			// Continue in another connected component
+			while (next < n && done[next])
+				next++;
+			if (next == n)
+				break;
+			queue.emplace(gain[next], next);
+		}
+		Int v = queue.top().second;
+		Bool stale = queue.top().first != gain[v];
+		queue.pop();
+		if (done[v] || stale)
+			continue;
+		done[v] = true;
+		if (balance.deviation(weight + graph.vertexWeights[v]) > balance.deviation(weight))
+			continue;
+
+		part[v] = 0;
+		weight += graph.vertexWeights[v];
+		for (Int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++) {
+			Int u = graph.adjacency[k];
+			gain[u] += 2 * graph.edgeWeights[k];
+			if (!done[u])
+				queue.emplace(gain[u], u);
+		}
+	}
+	return part;
+}
+
+// Last vertex reached by a breadth first search, which is far from the start
+static Int peripheralVertex(const Graph& graph, Int start) {
+	std::vector<Bool> visited(graph.size(), false);
+	std::vector<Int> order = {start};
+	visited[start] = true;
+	for (size_t i = 0; i < order.size(); i++) {
+		for (Int k = graph.offsets[order[i]]; k < graph.offsets[order[i] + 1]; k++) {
+			Int u = graph.adjacency[k];
+			if (!visited[u]) {
+				visited[u] = true;
+				order.push_back(u);
+			}
+		}
+	}
+	return order.back();
+}
+
+std::vector<Int> NetworkPartitioner::bisect(const Graph& graph, Real fraction, Int maxVertexWeight) const {
+	const Int CoarsestSize = 40;
+	const Int NumSeeds = 4;
+
+	Int total = graph.totalWeight();
+	Balance balance;
+	balance.target = static_cast<Int>(std::lround(fraction * total));
+	balance.tolerance = std::max(static_cast<Int>(mImbalance * total * std::min(fraction, 1 - fraction)), maxVertexWeight);
+
+	// Coarsening
+	std::vector<Graph> levels;
+	std::vector<std::vector<Int>> maps;
+	Int maxWeight = std::max(1, static_cast<Int>(1.5 * total / CoarsestSize));
+	while (true) {
+		const Graph& fine = levels.empty() ? graph : levels.back();
+		if (fine.size() <= CoarsestSize)
+			break;
+		Graph coarse;
+		auto map = coarsen(fine, maxWeight, coarse);
+		if (coarse.size() > 0.95 * fine.size())
+			break;
+		levels.push_back(std::move(coarse));
+		maps.push_back(std::move(map));
+	}
+
+	// Initial bisection of the coarsest graph from several seeds
+	const Graph& coarsest = levels.empty() ? graph : levels.back();
+	std::vector<Int> part;
+	std::array<Int, 3> best {};
+	for (Int i = 0; i < std::min(NumSeeds, coarsest.size()); i++) {
+		Int seed = i == 0 ? peripheralVertex(coarsest, 0) : i * coarsest.size() / NumSeeds;
+		auto candidate = grow(coarsest, seed, balance);
+		refine(coarsest, candidate, balance);
+		auto score = balance.score(weightOf(coarsest, candidate), cutOf(coarsest, candidate));
+		if (part.empty() || score < best) {
+			best = score;
+			part = std::move(candidate);
+		}
+	}
+
+	// Projection to the finer graphs
+	for (size_t level = levels.size(); level-- > 0;) {
+		const Graph& fine = level == 0 ? graph : levels[level - 1];
+		std::vector<Int> finePart(fine.size());
+		for (Int v = 0; v < fine.size(); v++)
+			finePart[v] = part[maps[level][v]];
+		refine(fine, finePart, balance);
+		part = std::move(finePart);
+	}
+	return part;
+}
+
+void NetworkPartitioner::partitionRecursive(const Graph& graph, const std::vector<Int>& vertices,
+	Int parts, Int firstPart, Int maxVertexWeight, std::vector<Int>& result) const {
+	if (parts <= 1 || vertices.size() <= 1) {
+		for (Int v : vertices)
+			result[v] = firstPart;
+		return;
+	}
+
+	Int parts0 = parts / 2;
+	auto side = bisect(subgraph(graph, vertices), static_cast<Real>(parts0) / parts, maxVertexWeight);
+	std::vector<Int> vertices0, vertices1;
+	for (size_t i = 0; i < vertices.size(); i++)
+		(side[i] == 0 ? vertices0 : vertices1).push_back(vertices[i]);
+	partitionRecursive(graph, vertices0, parts0, firstPart, maxVertexWeight, result);
+	partitionRecursive(graph, vertices1, parts - parts0, firstPart + parts0, maxVertexWeight, result);
+}
+
+std::vector<Int> NetworkPartitioner::partition(const Graph& graph, Int parts) const {
+	std::vector<Int> vertices(graph.size()), result(graph.size(), 0);
+	std::iota(vertices.begin(), vertices.end(), 0);
+	Int maxVertexWeight = graph.size() > 0 ? *std::max_element(graph.vertexWeights.begin(), graph.vertexWeights.end()) : 0;
+	partitionRecursive(graph, vertices, parts, 0, maxVertexWeight, result);
+	return result;
+}
+
+// Every connected subnet needs a connection to ground, otherwise its matrix is singular.
+// Subnets without one are joined to a neighbouring subnet that has one.
+static void joinUngroundedSubnets(const Graph& graph, const std::vector<Bool>& grounded, std::vector<Int>& part) {
+	Int n = graph.size();
+	Bool changed = true;
+	while (changed) {
+		changed = false;
+		std::vector<Int> component(n, -1);
+		std::vector<Bool> componentGrounded;
+		std::vector<std::vector<Int>> members;
+		for (Int start = 0; start < n; start++) {
+			if (component[start] >= 0)
+				continue;
+			Int c = static_cast<Int>(members.size());
+			members.emplace_back(1, start);
+			componentGrounded.push_back(false);
+			component[start] = c;
+			for (size_t i = 0; i < members[c].size(); i++) {
+				Int v = members[c][i];
+				if (grounded[v])
+					componentGrounded[c] = true;
+				for (Int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++) {
+					Int u = graph.adjacency[k];
+					if (component[u] < 0 && part[u] == part[v]) {
+						component[u] = c;
+						members[c].push_back(u);
+					}
+				}
+			}
+		}
+
+		for (size_t c = 0; c < members.size(); c++) {
+			if (componentGrounded[c])
+				continue;
+			// Heaviest connection to a grounded subnet
+			Int target = -1, targetWeight = 0;
+			std::unordered_map<Int, Int> connections;
+			for (Int v : members[c]) {
+				for (Int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++) {
+					Int u = graph.adjacency[k];
+					if (!componentGrounded[component[u]])
+						continue;
+					Int weight = connections[part[u]] += graph.edgeWeights[k];
+					if (weight > targetWeight) {
+						target = part[u];
+						targetWeight = weight;
+					}
+				}
+			}
+			if (target < 0)
+				continue;
+			for (Int v : members[c])
+				part[v] = target;
+			changed = true;
+		}
+	}
+}
+
+template <typename VarType>
+IdentifiedObject::List NetworkPartitioner::selectTearComponents(const SystemTopology& system) {
+	// Network nodes, a union-find structure joins the nodes that cannot be separated
+	std::unordered_map<SimNode<VarType>*, Int> nodeIndex;
+	std::vector<Int> nodeWeights, parent;
+	std::vector<Bool> nodeGrounded;
+	auto index = [&](const typename SimNode<VarType>::Ptr& node) {
+		auto it = nodeIndex.emplace(node.get(), static_cast<Int>(parent.size()));
+		if (it.second) {
+			nodeWeights.push_back(node->phaseType() == PhaseType::ABC ? 3 : 1);
+			parent.push_back(it.first->second);
+			nodeGrounded.push_back(false);
+		}
+		return it.first->second;
+	};
+	auto find = [&parent](Int node) {
+		while (parent[node] != node)
+			node = parent[node] = parent[parent[node]];
+		return node;
+	};
+
+	for (auto tnode : system.mNodes) {
+		auto node = std::dynamic_pointer_cast<SimNode<VarType>>(tnode);
+		if (node && !node->isGround())
+			index(node);
+	}
+
+	struct Candidate {
+		IdentifiedObject::Ptr component;
+		Int node1, node2;
+	};
+	std::vector<Candidate> candidates;
+	for (auto comp : system.mComponents) {
+		auto pcomp = std::dynamic_pointer_cast<SimPowerComp<VarType>>(comp);
+		if (!pcomp)
+			continue;
+
+		std::vector<Int> terminals;
+		Bool hasGround = false;
+		for (UInt idx = 0; idx < pcomp->terminalNumberConnected(); idx++) {
+			auto node = pcomp->node(idx);
+			if (node->isGround())
+				hasGround = true;
+			else
+				terminals.push_back(index(node));
+		}
+		if (terminals.empty())
+			continue;
+
+		if (std::dynamic_pointer_cast<MNATearInterface>(comp) && pcomp->terminalNumber() == 2
+			&& terminals.size() == 2 && terminals[0] != terminals[1]) {
+			candidates.push_back({comp, terminals[0], terminals[1]});
+			continue;
+		}
+		// One terminal components inject into ground as well
+		if (hasGround || terminals.size() == 1)
+			nodeGrounded[terminals[0]] = true;
+		nodeWeights[terminals[0]] += pcomp->virtualNodesNumber();
+		for (size_t idx = 1; idx < terminals.size(); idx++)
+			parent[find(terminals[idx])] = find(terminals[0]);
+	}
+
+	// Graph of the node groups with the tearable components as edges
+	std::vector<Int> vertex(parent.size(), -1), vertexWeights;
+	std::vector<Bool> vertexGrounded;
+	for (Int node = 0; node < static_cast<Int>(parent.size()); node++) {
+		Int root = find(node);
+		if (vertex[root] < 0) {
+			vertex[root] = static_cast<Int>(vertexWeights.size());
+			vertexWeights.push_back(0);
+			vertexGrounded.push_back(false);
+		}
+		vertex[node] = vertex[root];
+		vertexWeights[vertex[node]] += nodeWeights[node];
+		if (nodeGrounded[node])
+			vertexGrounded[vertex[node]] = true;
+	}
+	std::vector<Edge> edges;
+	for (auto& cand : candidates) {
+		if (vertex[cand.node1] != vertex[cand.node2])
+			edges.push_back({vertex[cand.node1], vertex[cand.node2], 1});
+	}
+	Graph graph = Graph::fromEdges(vertexWeights, edges);
+
+	auto part = partition(graph, static_cast<Int>(mParts));
+	joinUngroundedSubnets(graph, vertexGrounded, part);
+
+	mSubnetSizes.assign(std::max<UInt>(mParts, 1), 0);
+	for (Int v = 0; v < graph.size(); v++)
+		mSubnetSizes[part[v]] += graph.vertexWeights[v];
+	mSubnetSizes.erase(std::remove(mSubnetSizes.begin(), mSubnetSizes.end(), 0), mSubnetSizes.end());
+
+	IdentifiedObject::List tearComponents;
+	for (auto& cand : candidates) {
+		if (part[vertex[cand.node1]] != part[vertex[cand.node2]])
+			tearComponents.push_back(cand.component);
+	}
+	return tearComponents;
+}
+
+template <typename VarType>
+IdentifiedObject::List NetworkPartitioner::tear(SystemTopology& system) {
+	auto tearComponents = selectTearComponents<VarType>(system);
+	std::unordered_set<IdentifiedObject*> torn;
+	for (auto comp : tearComponents)
+		torn.insert(comp.get());
+
+	auto& comps = system.mComponents;
+	comps.erase(std::remove_if(comps.begin(), comps.end(),
+		[&torn](const IdentifiedObject::Ptr& comp) { return torn.count(comp.get()) > 0; }), comps.end());
+	system.mTearComponents.insert(system.mTearComponents.end(), tearComponents.begin(), tearComponents.end());
+	return tearComponents;
+}
+
+template IdentifiedObject::List NetworkPartitioner::selectTearComponents<Real>(const SystemTopology& system);
+template IdentifiedObject::List NetworkPartitioner::selectTearComponents<Complex>(const SystemTopology& system);
+template IdentifiedObject::List NetworkPartitioner::tear<Real>(SystemTopology& system);
+template IdentifiedObject::List NetworkPartitioner::tear<Complex>(SystemTopology& system);
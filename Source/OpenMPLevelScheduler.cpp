@@ -31,6 +31,20 @@ void OpenMPLevelScheduler::createSchedule(const Task::List& tasks, const Edges&
 		Scheduler::initMeasurements(tasks);
 }
 
+Bool OpenMPLevelScheduler::exportSchedule(std::vector<Task::List>& groups) const {
+	groups = mLevels;
+	return true;
+}
+
+void OpenMPLevelScheduler::importSchedule(const std::vector<Task::List>& groups, const Edges& inEdges, const Edges& outEdges) {
+	mLevels = groups;
+
+	if (!mOutMeasurementFile.empty()) {
+		for (auto& level : mLevels)
+			Scheduler::initMeasurements(level);
+	}
+}
+
 void OpenMPLevelScheduler::step(Real time, Int timeStepCount) {
 	long i, level = 0;
 	std::chrono::steady_clock::time_point start, end;
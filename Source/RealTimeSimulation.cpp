@@ -9,6 +9,7 @@
 #include <chrono>
 #include <ctime>
 #include <dpsim/RealTimeSimulation.h>
+#include <dpsim/ThreadPlacement.h>
 #include <iomanip>
 
 using namespace CPS;
@@ -26,6 +27,16 @@ void RealTimeSimulation::run(const Timer::StartClock::duration &startIn) {
 }
 
 void RealTimeSimulation::run(const Timer::StartClock::time_point &startAt) {
+	if (mLockMemory) {
+		ThreadPlacement::lockMemory();
+		mLog->info("Locked memory");
+	}
+	auto callerPlacement = ThreadPlacement::currentThreadState();
+	if (mCpu >= 0 || mRealTimePriority > 0) {
+		ThreadPlacement::applyToCurrentThread(mCpu, mRealTimePriority);
+		mLog->info("Simulation thread: {}", ThreadPlacement::describe(0, mCpu));
+	}
+
 	if (!mInitialized)
 		initialize();
 
@@ -59,6 +70,8 @@ void RealTimeSimulation::run(const Timer::StartClock::time_point &startAt) {
 	mLog->info("Simulation finished.");
 
 	mScheduler->stop();
+	if (mCpu >= 0 || mRealTimePriority > 0)
+		ThreadPlacement::restoreCurrentThread(callerPlacement);
 
 #ifdef WITH_SHMEM
 	for (auto ifm : mInterfaces)
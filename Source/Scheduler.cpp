@@ -7,11 +7,23 @@
  *********************************************************************************/
 
 #include <dpsim/Scheduler.h>
+#include <dpsim/TaskGraph.h>
 
+#include <algorithm>
+#include <climits>
 #include <fstream>
+#include <map>
 #include <iostream>
+#include <sstream>
 #include <unordered_map>
 #include <unordered_set>
+#include <thread>
+
+#ifdef __linux__
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
 
 using namespace CPS;
 using namespace DPsim;
@@ -21,23 +33,27 @@ CPS::AttributeBase::Ptr Scheduler::external;
 void Scheduler::initMeasurements(const Task::List& tasks) {
 	// Fill map here already since it's not protected by a mutex
 	for (auto task : tasks) {
-		mMeasurements[task.get()] = std::vector<TaskTime>();
+		mMeasurements[task.get()] = std::make_unique<TaskTimeStatistics>();
 	}
 }
 
 void Scheduler::updateMeasurement(Task* ptr, TaskTime time) {
-	mMeasurements[ptr].push_back(time);
+	auto it = mMeasurements.find(ptr);
+	if (it != mMeasurements.end())
+		it->second->update(time);
 }
 
 void Scheduler::writeMeasurements(String filename) {
 	std::ofstream os(filename);
-	std::unordered_map<String, TaskTime> averages;
+	std::map<String, TaskTimeStatistics::Summary> summaries;
 	for (auto& pair : mMeasurements) {
-		averages[pair.first->toString()] = getAveragedMeasurement(pair.first);
+		summaries[pair.first->toString()] = pair.second->summary();
 	}
-	// TODO think of nicer output format
-	for (auto pair : averages) {
-		os << pair.first << "," << pair.second.count() << std::endl;
+	for (auto& pair : summaries) {
+		auto& s = pair.second;
+		os << pair.first << "," << s.mean.count() << "," << s.count
+		   << "," << s.min.count() << "," << s.max.count()
+		   << "," << s.p50.count() << "," << s.p99.count() << "," << s.p999.count() << std::endl;
 	}
 	os.close();
 }
@@ -47,7 +63,16 @@ void Scheduler::readMeasurements(String filename, std::unordered_map<String, Tas
 	if (!fs.good())
 		throw SchedulingException();
 
-	String name;
+	// Column of each statistic in the lines written by writeMeasurements
+	size_t column = 1;
+	switch (mPlanningStatistic) {
+		case TaskTimeStatistics::Statistic::Max: column = 4; break;
+		case TaskTimeStatistics::Statistic::Median: column = 5; break;
+		case TaskTimeStatistics::Statistic::P99: column = 6; break;
+		case TaskTimeStatistics::Statistic::P999: column = 7; break;
+		default: column = 1;
+	}
+
 	while (fs.good()) {
 		std::string line;
 		std::getline(fs, line);
@@ -57,53 +82,97 @@ void Scheduler::readMeasurements(String filename, std::unordered_map<String, Tas
 				continue;
 			throw SchedulingException();
 		}
-		measurements[line.substr(0, idx)] = std::stol(line.substr(idx+1));
+		std::vector<String> fields;
+		std::stringstream ss(line.substr(idx+1));
+		for (String field; std::getline(ss, field, ',');)
+			fields.push_back(field);
+		if (fields.empty())
+			throw SchedulingException();
+		// Files with only the mean
+		const String& value = column <= fields.size() ? fields[column-1] : fields[0];
+		measurements[line.substr(0, idx)] = std::stol(value);
 	}
 }
 
-Scheduler::TaskTime Scheduler::getAveragedMeasurement(CPS::Task* task) {
-	TaskTime avg(0), tot(0);
+String Scheduler::configKey() const {
+	return std::to_string(static_cast<Int>(mPlanningStatistic));
+}
 
-	for (TaskTime time : mMeasurements[task]) {
-		tot += time;
-	}
+String Scheduler::measurementFileKey(const String& filename) {
+	if (filename.empty())
+		return filename;
+	std::ifstream file(filename);
+	std::stringstream key;
+	key << filename << ":" << file.rdbuf();
+	return key.str();
+}
 
-	if (!mMeasurements[task].empty())
-		avg = tot / mMeasurements[task].size();
+Scheduler::TaskTime Scheduler::getAveragedMeasurement(CPS::Task* task) {
+	auto it = mMeasurements.find(task);
+	if (it == mMeasurements.end())
+		return TaskTime(0);
+	return it->second->summary().mean;
+}
 
-	return avg;
+TaskTimeStatistics::Summary Scheduler::getMeasurementStatistics(CPS::Task::Ptr task) {
+	auto it = mMeasurements.find(task.get());
+	if (it == mMeasurements.end())
+		return TaskTimeStatistics::Summary();
+	return it->second->summary();
 }
 
 
 void Scheduler::resolveDeps(Task::List& tasks, Edges& inEdges, Edges& outEdges) {
 	// Create graph (list of out/in edges for each node) from attribute dependencies
 	tasks.push_back(mRoot);
-	std::unordered_map<AttributeBase::Ptr, std::deque<Task::Ptr>, std::hash<AttributeBase::Ptr>, CPS::AttributeEq<AttributeBase>> dependencies;
-	std::unordered_set<AttributeBase::Ptr, std::hash<AttributeBase::Ptr>, CPS::AttributeEq<AttributeBase>> prevStepDependencies;
-	for (auto task : tasks) {
+	Int numTasks = static_cast<Int>(tasks.size());
+
+	// Tasks depending on each attribute. Attributes are identified by their address,
+	// the external attribute is the nullptr.
+	std::unordered_map<AttributeBase*, std::vector<Int>> dependencies;
+	std::unordered_set<AttributeBase*> prevStepDependencies;
+	// Many tasks depend on the same (dynamic) attributes, so the recursive
+	// dependency sets are only collected once per attribute
+	std::unordered_map<AttributeBase*, std::vector<AttributeBase*>> attrDependencyCache;
+	for (Int idx = 0; idx < numTasks; idx++) {
+		auto& task = tasks[idx];
 		for (AttributeBase::Ptr attr : task->getAttributeDependencies()) {
 			/// CHECK: Having external be the nullptr can lead to segfaults rather quickly. Maybe make it a special kind of attribute
+			AttributeBase* ptr = attr.getPtr().get();
 			if (attr.getPtr() != Scheduler::external.getPtr()) {
-				AttributeBase::Set attrDependencies = attr->getDependencies();
-				for (AttributeBase::Ptr dep : attrDependencies) {
-					dependencies[dep].push_back(task);
+				auto cached = attrDependencyCache.find(ptr);
+				if (cached == attrDependencyCache.end()) {
+					std::vector<AttributeBase*> deps;
+					for (AttributeBase::Ptr dep : attr->getDependencies())
+						deps.push_back(dep.getPtr().get());
+					cached = attrDependencyCache.emplace(ptr, std::move(deps)).first;
+				}
+				for (AttributeBase* dep : cached->second) {
+					dependencies[dep].push_back(idx);
 				}
 			} else {
-				dependencies[attr].push_back(task);
+				dependencies[ptr].push_back(idx);
 			}
 		}
 		for (AttributeBase::Ptr attr : task->getPrevStepDependencies()) {
-			prevStepDependencies.insert(attr);
+			prevStepDependencies.insert(attr.getPtr().get());
 		}
 	}
 
-	for (auto from : tasks) {
+	outEdges.reserve(outEdges.size() + numTasks);
+	inEdges.reserve(inEdges.size() + numTasks);
+	for (auto& from : tasks) {
 		for (AttributeBase::Ptr attr : from->getModifiedAttributes()) {
-			for (auto to : dependencies[attr]) {
-				outEdges[from].push_back(to);
-				inEdges[to].push_back(from);
+			AttributeBase* ptr = attr.getPtr().get();
+			auto deps = dependencies.find(ptr);
+			if (deps != dependencies.end()) {
+				auto& out = outEdges[from];
+				for (Int to : deps->second) {
+					out.push_back(tasks[to]);
+					inEdges[tasks[to]].push_back(from);
+				}
 			}
-			if (prevStepDependencies.count(attr)) {
+			if (prevStepDependencies.count(ptr)) {
 				outEdges[from].push_back(mRoot);
 				inEdges[mRoot].push_back(from);
 			}
@@ -111,94 +180,214 @@ void Scheduler::resolveDeps(Task::List& tasks, Edges& inEdges, Edges& outEdges)
 	}
 }
 
-void Scheduler::topologicalSort(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges, Task::List& sortedTasks) {
-	sortedTasks.clear();
+Scheduler::FusedTask::FusedTask(const Task::List& tasks) :
+	Task("Fused:" + tasks.front()->toString() + "+" + std::to_string(tasks.size() - 1)), mTasks(tasks) {
+	for (auto& task : mTasks) {
+		for (auto& attr : task->getAttributeDependencies())
+			mAttributeDependencies.push_back(attr);
+		for (auto& attr : task->getModifiedAttributes())
+			mModifiedAttributes.push_back(attr);
+		for (auto& attr : task->getPrevStepDependencies())
+			mPrevStepDependencies.push_back(attr);
+	}
+}
 
-	// make copies of the edge lists because we modify them (and it makes
-	// things easier since empty lists are automatically created)
-	Edges inEdgesCpy = inEdges, outEdgesCpy = outEdges;
+void Scheduler::coarsenTasks(Task::List& tasks, Edges& inEdges, Edges& outEdges, const CoarseningConfig& config) {
+	if (!config.enabled)
+		return;
 
-	// do a breadth-first search backwards from the root node first to filter
-	// out unnecessary nodes
-	std::deque<Task::Ptr> q;
-	std::unordered_set<Task::Ptr> visited;
+	std::unordered_map<String, TaskTime::rep> measurements;
+	if (!config.inMeasurementFile.empty())
+		readMeasurements(config.inMeasurementFile, measurements);
 
-	q.push_back(mRoot);
-	while (!q.empty()) {
-		auto t = q.front();
-		q.pop_front();
-		if (visited.count(t))
-			continue;
+	TaskGraph graph(tasks, outEdges, true);
+	Int numTasks = graph.size();
+	auto succ = [&graph](Int idx) { return graph.successors(idx); };
+	auto pred = [&graph](Int idx) { return graph.predecessors(idx); };
+
+	// Tasks that the root does not depend on are dropped by the schedulers
+	// and must not be fused with needed tasks
+	Int root = graph.index(mRoot.get());
+	std::vector<Bool> needed = graph.ancestors(root);
 
-		visited.insert(t);
-		for (auto dep : inEdgesCpy[t]) {
-			if (!visited.count(dep)) {
-				q.push_back(dep);
+	std::vector<TaskTime::rep> cost(numTasks, 0);
+	std::vector<Bool> fusable(numTasks, false);
+	for (Int i = 0; i < numTasks; i++) {
+		if (i == root || !needed[i] || pred(i).size() > config.maxDegree || succ(i).size() > config.maxDegree)
+			continue;
+		if (measurements.empty()) {
+			fusable[i] = true;
+		} else {
+			auto it = measurements.find(tasks[i]->toString());
+			if (it != measurements.end() && it->second <= config.maxCost) {
+				fusable[i] = true;
+				cost[i] = it->second;
 			}
 		}
 	}
 
-	for (auto t : tasks) {
-		if (inEdgesCpy[t].empty()) {
-			q.push_back(t);
+	std::vector<Int> order = graph.topologicalOrder();
+
+	// Contract chains in which each task has a single successor that has a single predecessor
+	std::vector<Int> unit(numTasks, -1);
+	std::vector<std::vector<Int>> units;
+	std::vector<TaskTime::rep> unitCost;
+	for (Int t : order) {
+		if (unit[t] >= 0)
+			continue;
+		Int u = static_cast<Int>(units.size());
+		units.push_back({t});
+		unitCost.push_back(cost[t]);
+		unit[t] = u;
+		if (!fusable[t])
+			continue;
+		Int cur = t;
+		while (succ(cur).size() == 1) {
+			Int next = *succ(cur).begin();
+			if (pred(next).size() != 1 || !fusable[next] || unit[next] >= 0
+				|| units[u].size() >= config.maxTasks
+				|| (!measurements.empty() && unitCost[u] + cost[next] > config.maxCost))
+				break;
+			units[u].push_back(next);
+			unitCost[u] += cost[next];
+			unit[next] = u;
+			cur = next;
 		}
 	}
-	// keep list of tasks without incoming edges;
-	// iteratively remove such tasks from the graph and put them into the schedule
-	while (!q.empty()) {
-		Task::Ptr t = q.front();
-		q.pop_front();
-		if (!visited.count(t)) {
-			// don't put unneeded tasks in the schedule, but process them as usual
-			// so the cycle check still works
-			mSLog->info("Dropping {:s}", t->toString());
-		} else if (t != mRoot) {
-			sortedTasks.push_back(t);
+
+	// Levels of the contracted graph. External predecessors only connect to the
+	// first task of a chain and external successors only to the last one.
+	Int numUnits = static_cast<Int>(units.size());
+	std::vector<Int> level(numUnits, 0);
+	Int maxLevel = 0;
+	for (Int t : order) {
+		for (Int p : pred(t)) {
+			if (unit[p] != unit[t])
+				level[unit[t]] = std::max(level[unit[t]], level[unit[p]] + 1);
 		}
+		maxLevel = std::max(maxLevel, level[unit[t]]);
+	}
 
-		for (auto after : outEdgesCpy[t]) {
-			for (auto edgeIt = inEdgesCpy[after].begin(); edgeIt != inEdgesCpy[after].end(); ++edgeIt) {
-				if (*edgeIt == t) {
-					inEdgesCpy[after].erase(edgeIt);
-					break;
-				}
-			}
-			if (inEdgesCpy[after].empty()) {
-				q.push_back(after);
+	// Pack fusable units of the same level into batches. There is no path between
+	// units of the same level, so merging them cannot create cycles.
+	std::vector<std::vector<Int>> unitsPerLevel(maxLevel + 1);
+	for (Int u = 0; u < numUnits; u++) {
+		if (fusable[units[u][0]])
+			unitsPerLevel[level[u]].push_back(u);
+	}
+	std::vector<Int> batch(numUnits);
+	for (Int u = 0; u < numUnits; u++)
+		batch[u] = u;
+	for (auto& levelUnits : unitsPerLevel) {
+		Int current = -1;
+		size_t size = 0;
+		TaskTime::rep batchCost = 0;
+		for (Int u : levelUnits) {
+			if (current < 0 || size + units[u].size() > config.maxTasks
+				|| (!measurements.empty() && batchCost + unitCost[u] > config.maxCost)) {
+				current = u;
+				size = 0;
+				batchCost = 0;
 			}
+			batch[u] = current;
+			size += units[u].size();
+			batchCost += unitCost[u];
 		}
-		outEdgesCpy.erase(t);
 	}
 
-	// sanity check: all edges should have been removed, otherwise
-	// the graph had a cycle
-	for (auto t : tasks) {
-		if (!outEdgesCpy[t].empty() || !inEdgesCpy[t].empty())
-			throw SchedulingException();
+	// Create the fused tasks with their members in topological order
+	std::vector<Task::List> members(numUnits);
+	for (Int t : order)
+		members[batch[unit[t]]].push_back(tasks[t]);
+
+	std::vector<Task::Ptr> replacement(numTasks);
+	UInt numFused = 0;
+	for (Int u = 0; u < numUnits; u++) {
+		if (members[u].size() < 2)
+			continue;
+		auto fused = std::make_shared<FusedTask>(members[u]);
+		for (auto& task : members[u])
+			replacement[graph.index(task.get())] = fused;
+		numFused += members[u].size();
+	}
+	for (Int i = 0; i < numTasks; i++) {
+		if (!replacement[i])
+			replacement[i] = tasks[i];
+	}
+
+	Task::List coarseTasks;
+	std::unordered_set<Task*> added;
+	for (Int i = 0; i < numTasks; i++) {
+		if (added.insert(replacement[i].get()).second)
+			coarseTasks.push_back(replacement[i]);
 	}
 
+	Edges coarseIn, coarseOut;
+	std::unordered_map<Task*, std::unordered_set<Task*>> targets;
+	for (Int i = 0; i < numTasks; i++) {
+		auto it = outEdges.find(tasks[i]);
+		if (it == outEdges.end())
+			continue;
+		auto& from = replacement[i];
+		for (auto& to : it->second) {
+			Int idx = graph.index(to.get());
+			auto target = idx >= 0 ? replacement[idx] : to;
+			if (target != from && targets[from.get()].insert(target.get()).second) {
+				coarseOut[from].push_back(target);
+				coarseIn[target].push_back(from);
+			}
+		}
+	}
+
+	mSLog->info("Task coarsening fused {} of {} tasks, {} tasks remaining",
+		numFused, numTasks, coarseTasks.size());
+
+	tasks = coarseTasks;
+	inEdges = coarseIn;
+	outEdges = coarseOut;
 }
 
-void Scheduler::levelSchedule(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges, std::vector<Task::List>& levels) {
-	std::unordered_map<Task::Ptr, int> time;
+void Scheduler::topologicalSort(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges, Task::List& sortedTasks) {
+	sortedTasks.clear();
 
-	for (auto task : tasks) {
-		if (inEdges.find(task) == inEdges.end() || inEdges.at(task).empty()) {
-			time[task] = 0;
-		} else {
-			int maxdist = 0;
-			for (auto before : inEdges.at(task)) {
-				if (time[before] > maxdist)
-					maxdist = time[before];
-			}
-			time[task] = maxdist + 1;
+	TaskGraph graph(tasks, outEdges);
+
+	// filter out tasks that the root does not depend on
+	std::vector<Bool> needed = graph.ancestors(graph.index(mRoot.get()));
+
+	// iteratively remove tasks without incoming edges from the graph and put
+	// them into the schedule; throws if the graph has a cycle
+	for (Int idx : graph.topologicalOrder()) {
+		auto& t = graph.task(idx);
+		if (!needed[idx]) {
+			// don't put unneeded tasks in the schedule
+			mSLog->info("Dropping {:s}", t->toString());
+		} else if (t != mRoot) {
+			sortedTasks.push_back(t);
 		}
 	}
+}
+
+void Scheduler::levelSchedule(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges, std::vector<Task::List>& levels) {
+	// tasks are topologically sorted, so the levels of all predecessors are known
+	TaskGraph graph(tasks, outEdges);
+	std::vector<Int> time(tasks.size(), 0);
+	Int maxTime = 0;
+	for (Int idx = 0; idx < graph.size(); idx++) {
+		for (Int before : graph.predecessors(idx)) {
+			if (time[before] + 1 > time[idx])
+				time[idx] = time[before] + 1;
+		}
+		if (time[idx] > maxTime)
+			maxTime = time[idx];
+	}
 
 	levels.clear();
-	levels.resize(time[tasks.back()] + 1);
-	for (auto task : tasks) {
-		levels[time[task]].push_back(task);
+	if (tasks.empty())
+		return;
+	levels.resize(maxTime + 1);
+	for (Int idx = 0; idx < graph.size(); idx++) {
+		levels[time[idx]].push_back(tasks[idx]);
 	}
 }
 
@@ -216,3 +405,28 @@ void BarrierTask::execute(Real time, Int timeStepCount) {
 		mBarriers[mBarriers.size()-1]->wait();
 	}
 }
+
+void AdaptiveWait::block(std::atomic<Int>& word, Int value) {
+#ifdef __linux__
+	static_assert(sizeof(std::atomic<Int>) == sizeof(int), "futex requires a 32 bit word");
+	syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+#else
+	// No portable futex before C++20, fall back to yielding
+	std::this_thread::yield();
+#endif
+}
+
+void AdaptiveWait::wake(std::atomic<Int>& word) {
+#ifdef __linux__
+	syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+void AdaptiveWait::addStatistics(std::chrono::nanoseconds spin, std::chrono::nanoseconds blocked, Bool didBlock) {
+	std::lock_guard<std::mutex> lk(mStatisticsMutex);
+	mStatistics.numWaits++;
+	if (didBlock)
+		mStatistics.numBlocked++;
+	mStatistics.spinTime += spin;
+	mStatistics.blockTime += blocked;
+}
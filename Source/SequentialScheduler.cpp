@@ -28,6 +28,20 @@ void SequentialScheduler::createSchedule(const Task::List& tasks, const Edges& i
         mSLog->info("{}", task->toString());
 }
 
+Bool SequentialScheduler::exportSchedule(std::vector<Task::List>& groups) const {
+	groups = {mSchedule};
+	return true;
+}
+
+void SequentialScheduler::importSchedule(const std::vector<Task::List>& groups, const Edges& inEdges, const Edges& outEdges) {
+	if (groups.size() != 1)
+		throw SchedulingException();
+
+	mSchedule = groups[0];
+	if (mOutMeasurementFile.size() != 0)
+		Scheduler::initMeasurements(mSchedule);
+}
+
 void SequentialScheduler::step(Real time, Int timeStepCount) {
 	if (mOutMeasurementFile.size() != 0) {
 		for (auto task : mSchedule) {
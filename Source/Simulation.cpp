@@ -9,8 +9,11 @@
 #include <chrono>
 #include <iomanip>
 #include <algorithm>
+#include <sstream>
 #include <typeindex>
+#include <unordered_set>
 
+#include <dpsim/CompiledSchedule.h>
 #include <dpsim/SequentialScheduler.h>
 #include <dpsim/Simulation.h>
 #include <dpsim/Utils.h>
@@ -18,6 +21,7 @@
 #include <dpsim/MNASolverFactory.h>
 #include <dpsim/PFSolverPowerPolar.h>
 #include <dpsim/DiakopticsSolver.h>
+#include <dpsim/NetworkPartitioner.h>
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 
@@ -135,13 +139,58 @@ template <typename VarType>
 void Simulation::createMNASolver() {
 	Solver::Ptr solver;
 	std::vector<SystemTopology> subnets;
+	if (mAutomaticDecoupling) {
+		auto lines = mSystem.decoupleLines(**mTimeStep);
+		mLog->info("Automatic decoupling replaced {} lines", lines.size());
+	}
+	if (mAutomaticTearingSubnets > 1 && mTearComponents.size() == 0 && mScenarios.size() == 0) {
+		NetworkPartitioner partitioner(mAutomaticTearingSubnets);
+		mTearComponents = partitioner.tear<VarType>(mSystem);
+		auto sizes = partitioner.subnetSizes();
+		mLog->info("Automatic tearing selected {} tear components for {} subnets",
+			mTearComponents.size(), sizes.size());
+		if (!sizes.empty())
+			mLog->info("Subnet sizes between {} and {}",
+				*std::min_element(sizes.begin(), sizes.end()), *std::max_element(sizes.begin(), sizes.end()));
+	}
 	// The Diakoptics solver splits the system at a later point.
 	// That is why the system is not split here if tear components exist.
-	if (**mSplitSubnets && mTearComponents.size() == 0)
+	if (**mSplitSubnets && mTearComponents.size() == 0 && mScenarios.size() == 0)
 		mSystem.splitSubnets<VarType>(subnets);
 	else
 		subnets.push_back(mSystem);
 
+	auto createMnaSolver = [this](const SystemTopology& system, const String& name, Bool scenario = false) {
+		auto mnaSolver = MnaSolverFactory::factory<VarType>(name, mDomain,
+											 mLogLevel, mMnaImpl, mSolverPluginName);
+		mnaSolver->doSwitchedMatrixCaching(mSwitchedMatrixCaching);
+		mnaSolver->setSwitchedMatrixCacheBudget(mSwitchedMatrixCacheBudget);
+		mnaSolver->doSparseRightVectorAssembly(mSparseRightVectorAssembly);
+		mnaSolver->doLowRankSystemMatrixUpdate(mLowRankUpdate);
+		mnaSolver->setLowRankUpdateMaxRank(mLowRankUpdateMaxRank);
+		mnaSolver->doMixedPrecisionSolve(mMixedPrecision);
+		mnaSolver->setMixedPrecisionRefinement(mMixedPrecisionRefinementSteps, mMixedPrecisionTolerance);
+		mnaSolver->doComplexSystemMatrix(mComplexSystemMatrix);
+		mnaSolver->setTimeStep(**mTimeStep);
+		mnaSolver->doSteadyStateInit(**mSteadyStateInit);
+		mnaSolver->doFrequencyParallelization(mFreqParallel);
+		mnaSolver->setSteadStIniTimeLimit(mSteadStIniTimeLimit);
+		mnaSolver->setSteadStIniAccLimit(mSteadStIniAccLimit);
+		mnaSolver->setSystem(system);
+		mnaSolver->setSolverAndComponentBehaviour(mSolverBehaviour);
+		mnaSolver->doInitFromNodesAndTerminals(mInitFromNodesAndTerminals);
+		mnaSolver->doSystemMatrixRecomputation(mSystemMatrixRecomputation);
+#ifdef WITH_SPARSE
+		// Scenarios only need their matrices for the comparison with the main solver,
+		// unless the steady state initialization solves them on their own
+		auto sparseSolver = std::dynamic_pointer_cast<MnaSolverEigenSparse<VarType>>(mnaSolver);
+		if (scenario && sparseSolver && !**mSteadyStateInit)
+			sparseSolver->doSwitchedMatrixFactorization(false);
+#endif
+		mnaSolver->initialize();
+		return mnaSolver;
+	};
+
 	for (UInt net = 0; net < subnets.size(); ++net) {
 		String copySuffix;
 	   	if (subnets.size() > 1)
@@ -151,22 +200,28 @@ void Simulation::createMNASolver() {
 		// solvers for different subnets if deemed useful
 		if (mTearComponents.size() > 0) {
 			// Tear components available, use diakoptics
-			solver = std::make_shared<DiakopticsSolver<VarType>>(**mName,
-				subnets[net], mTearComponents, **mTimeStep, mLogLevel);
+			auto diakopticsSolver = std::make_shared<DiakopticsSolver<VarType>>(**mName,
+				subnets[net], mTearComponents, **mTimeStep, mLogLevel, mNestedDiakoptics);
+			diakopticsSolver->setSwitchedMatrixCacheBudget(mSwitchedMatrixCacheBudget);
+			solver = diakopticsSolver;
 		} else {
 			// Default case with lu decomposition from mna factory
-			solver = MnaSolverFactory::factory<VarType>(**mName + copySuffix, mDomain,
-												 mLogLevel, mMnaImpl, mSolverPluginName);
-			solver->setTimeStep(**mTimeStep);
-			solver->doSteadyStateInit(**mSteadyStateInit);
-			solver->doFrequencyParallelization(mFreqParallel);
-			solver->setSteadStIniTimeLimit(mSteadStIniTimeLimit);
-			solver->setSteadStIniAccLimit(mSteadStIniAccLimit);
-			solver->setSystem(subnets[net]);
-			solver->setSolverAndComponentBehaviour(mSolverBehaviour);
-			solver->doInitFromNodesAndTerminals(mInitFromNodesAndTerminals);
-			solver->doSystemMatrixRecomputation(mSystemMatrixRecomputation);
-			solver->initialize();
+			auto mnaSolver = createMnaSolver(subnets[net], **mName + copySuffix);
+			if (mScenarios.size() > 0) {
+#ifdef WITH_SPARSE
+				auto ensemble = std::dynamic_pointer_cast<MnaSolverEigenSparse<VarType>>(mnaSolver);
+				if (!ensemble)
+					throw SystemError("Scenarios require a sparse MNA solver implementation.");
+				for (UInt idx = 0; idx < mScenarios.size(); ++idx) {
+					auto scenario = std::dynamic_pointer_cast<MnaSolverEigenSparse<VarType>>(
+						createMnaSolver(mScenarios[idx], **mName + "_scenario_" + std::to_string(idx + 1), true));
+					ensemble->addScenario(scenario);
+				}
+#else
+				throw SystemError("Scenarios require a sparse MNA solver implementation.");
+#endif
+			}
+			solver = mnaSolver;
 		}
 		mSolvers.push_back(solver);
 	}
@@ -191,7 +246,7 @@ void Simulation::sync() {
 	mLog->info("Synchronized simulation start with remotes");
 }
 
-void Simulation::prepSchedule() {
+void Simulation::collectTasks() {
 	mTasks.clear();
 	mTaskOutEdges.clear();
 	mTaskInEdges.clear();
@@ -208,21 +263,165 @@ void Simulation::prepSchedule() {
 	}
 
 	for (auto logger : mLoggers) {
-		mTasks.push_back(logger->getTask());
+		for (auto t : logger->getTasks(mPipelinedOutput)) {
+			mTasks.push_back(t);
+		}
 	}
 	if (!mScheduler) {
 		mScheduler = std::make_shared<SequentialScheduler>();
 	}
+}
+
+void Simulation::prepSchedule() {
 	mScheduler->resolveDeps(mTasks, mTaskInEdges, mTaskOutEdges);
+	mScheduler->coarsenTasks(mTasks, mTaskInEdges, mTaskOutEdges, mTaskCoarsening);
 }
 
 void Simulation::schedule() {
 	mLog->info("Scheduling tasks.");
+	collectTasks();
+
+	std::uint64_t hash = 0;
+	if (!mScheduleFile.empty()) {
+		// The fused tasks are stored in the file, so the coarsening settings are part of the key
+		auto& scheduler = *mScheduler;
+		std::stringstream key;
+		key << typeid(scheduler).name() << "," << scheduler.configKey() << "," << mTaskCoarsening.enabled
+			<< "," << mTaskCoarsening.maxTasks << "," << mTaskCoarsening.maxCost
+			<< "," << mTaskCoarsening.maxDegree << "," << Scheduler::measurementFileKey(mTaskCoarsening.inMeasurementFile);
+		hash = CompiledSchedule::computeHash(mTasks, key.str());
+		if (loadSchedule(hash)) {
+			mLog->info("Loaded compiled schedule from {}", mScheduleFile);
+			return;
+		}
+	}
+
 	prepSchedule();
 	mScheduler->createSchedule(mTasks, mTaskInEdges, mTaskOutEdges);
+	if (!mScheduleFile.empty())
+		saveSchedule(hash);
 	mLog->info("Scheduling done.");
 }
 
+Bool Simulation::loadSchedule(std::uint64_t hash) {
+	CompiledSchedule compiled;
+	try {
+		if (!compiled.read(mScheduleFile))
+			return false;
+	} catch (SchedulingException&) {
+		mLog->warn("Ignoring invalid compiled schedule {}", mScheduleFile);
+		return false;
+	}
+	if (compiled.hash != hash) {
+		mLog->info("Compiled schedule {} does not match the simulation", mScheduleFile);
+		return false;
+	}
+
+	std::unordered_map<String, Task::Ptr> tasksByName;
+	for (auto& task : mTasks) {
+		if (!tasksByName.emplace(task->toString(), task).second) {
+			mLog->warn("Task name {} is not unique, compiled schedule ignored", task->toString());
+			return false;
+		}
+	}
+
+	// Each task may only be scheduled once
+	Task::List tasks;
+	for (auto& names : compiled.tasks) {
+		Task::List members;
+		for (auto& name : names) {
+			auto it = tasksByName.find(name);
+			if (it == tasksByName.end() || !it->second) {
+				mLog->warn("Ignoring compiled schedule {} with unknown task {}", mScheduleFile, name);
+				return false;
+			}
+			members.push_back(it->second);
+			it->second = nullptr;
+		}
+		if (members.size() == 1)
+			tasks.push_back(members[0]);
+		else
+			tasks.push_back(std::make_shared<Scheduler::FusedTask>(members));
+	}
+
+	Scheduler::Edges inEdges, outEdges;
+	for (auto& edge : compiled.edges) {
+		outEdges[tasks[edge.first]].push_back(tasks[edge.second]);
+		inEdges[tasks[edge.second]].push_back(tasks[edge.first]);
+	}
+	std::vector<Task::List> groups;
+	for (auto& group : compiled.groups) {
+		groups.emplace_back();
+		for (Int idx : group)
+			groups.back().push_back(tasks[idx]);
+	}
+
+	try {
+		mScheduler->importSchedule(groups, inEdges, outEdges);
+	} catch (SchedulingException&) {
+		mLog->warn("Compiled schedule {} cannot be used by the scheduler", mScheduleFile);
+		return false;
+	}
+	mTasks = tasks;
+	mTaskInEdges = inEdges;
+	mTaskOutEdges = outEdges;
+	return true;
+}
+
+void Simulation::saveSchedule(std::uint64_t hash) {
+	std::vector<Task::List> groups;
+	if (!mScheduler->exportSchedule(groups)) {
+		mLog->warn("Scheduler does not support compiled schedules");
+		return;
+	}
+
+	CompiledSchedule compiled;
+	compiled.hash = hash;
+	std::unordered_map<Task*, Int> index;
+	std::unordered_set<String> names;
+	for (auto& group : groups) {
+		compiled.groups.emplace_back();
+		for (auto& task : group) {
+			auto it = index.find(task.get());
+			if (it == index.end()) {
+				it = index.emplace(task.get(), static_cast<Int>(compiled.tasks.size())).first;
+				std::vector<String> taskNames;
+				if (auto fused = std::dynamic_pointer_cast<Scheduler::FusedTask>(task)) {
+					for (auto& member : fused->tasks())
+						taskNames.push_back(member->toString());
+				} else {
+					taskNames.push_back(task->toString());
+				}
+				// Tasks are identified by their names in the file
+				for (auto& name : taskNames) {
+					if (name.find(',') != String::npos || !names.insert(name).second) {
+						mLog->warn("Task name {} is not unique or contains a comma, compiled schedule not written", name);
+						return;
+					}
+				}
+				compiled.tasks.push_back(taskNames);
+			}
+			compiled.groups.back().push_back(it->second);
+		}
+	}
+
+	// Merge edges that result from multiple shared attributes
+	for (auto& pair : mTaskOutEdges) {
+		auto from = index.find(pair.first.get());
+		if (from == index.end())
+			continue;
+		std::unordered_set<Int> targets;
+		for (auto& to : pair.second) {
+			auto it = index.find(to.get());
+			if (it != index.end() && targets.insert(it->second).second)
+				compiled.edges.emplace_back(from->second, it->second);
+		}
+	}
+
+	compiled.write(mScheduleFile);
+	mLog->info("Wrote compiled schedule to {}", mScheduleFile);
+}
+
 #ifdef WITH_GRAPHVIZ
 Graph::Graph Simulation::dependencyGraph() {
 	if (!mInitialized)
@@ -301,6 +500,9 @@ Graph::Graph Simulation::dependencyGraph() {
 		label << "<FONT POINT-SIZE=\"10\" COLOR=\"gray28\">"
 		      << Utils::encodeXml(type) << "<BR/>";
 
+		if (auto fused = std::dynamic_pointer_cast<Scheduler::FusedTask>(task))
+			label << "Fused tasks: " << fused->tasks().size() << "<BR/>";
+
 		if (isScheduled(task))
 			label << "Avg. time: " << avgTimes[task].count() << "ns<BR/>";
 		else
@@ -0,0 +1,95 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <dpsim/TaskGraph.h>
+
+using namespace CPS;
+using namespace DPsim;
+
+TaskGraph::TaskGraph(const Task::List& tasks, const Scheduler::Edges& outEdges, Bool removeDuplicates) :
+	mTasks(tasks) {
+	Int n = static_cast<Int>(tasks.size());
+	mIndex.reserve(n);
+	for (Int i = 0; i < n; i++)
+		mIndex.emplace(tasks[i].get(), i);
+
+	// Successors in task order, optionally without duplicates
+	mSuccessorOffsets.assign(n + 1, 0);
+	std::vector<Int> lastSource(removeDuplicates ? n : 0, -1);
+	for (Int from = 0; from < n; from++) {
+		mSuccessorOffsets[from] = static_cast<Int>(mSuccessors.size());
+		auto it = outEdges.find(tasks[from]);
+		if (it == outEdges.end())
+			continue;
+		for (auto& to : it->second) {
+			Int idx = index(to.get());
+			if (idx < 0)
+				continue;
+			if (removeDuplicates) {
+				if (lastSource[idx] == from)
+					continue;
+				lastSource[idx] = from;
+			}
+			mSuccessors.push_back(idx);
+		}
+	}
+	mSuccessorOffsets[n] = static_cast<Int>(mSuccessors.size());
+
+	// Transpose by counting
+	mPredecessorOffsets.assign(n + 1, 0);
+	for (Int to : mSuccessors)
+		mPredecessorOffsets[to + 1]++;
+	for (Int i = 0; i < n; i++)
+		mPredecessorOffsets[i + 1] += mPredecessorOffsets[i];
+	mPredecessors.resize(mSuccessors.size());
+	std::vector<Int> fill(mPredecessorOffsets.begin(), mPredecessorOffsets.end() - 1);
+	for (Int from = 0; from < n; from++) {
+		for (Int to : successors(from))
+			mPredecessors[fill[to]++] = from;
+	}
+}
+
+std::vector<Bool> TaskGraph::ancestors(Int idx) const {
+	std::vector<Bool> visited(mTasks.size(), false);
+	if (idx < 0)
+		return visited;
+
+	std::vector<Int> stack = {idx};
+	visited[idx] = true;
+	while (!stack.empty()) {
+		Int t = stack.back();
+		stack.pop_back();
+		for (Int p : predecessors(t)) {
+			if (!visited[p]) {
+				visited[p] = true;
+				stack.push_back(p);
+			}
+		}
+	}
+	return visited;
+}
+
+std::vector<Int> TaskGraph::topologicalOrder() const {
+	Int n = size();
+	std::vector<Int> order, inDegree(n);
+	order.reserve(n);
+	for (Int i = 0; i < n; i++) {
+		inDegree[i] = static_cast<Int>(predecessors(i).size());
+		if (inDegree[i] == 0)
+			order.push_back(i);
+	}
+	for (size_t k = 0; k < order.size(); k++) {
+		for (Int s : successors(order[k])) {
+			if (--inDegree[s] == 0)
+				order.push_back(s);
+		}
+	}
+	if (static_cast<Int>(order.size()) != n)
+		throw SchedulingException();
+	return order;
+}
@@ -0,0 +1,123 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <dpsim/TaskTimeStatistics.h>
+#include <cps/Definitions.h>
+
+using namespace DPsim;
+
+TaskTimeStatistics::TaskTimeStatistics() :
+	mMin(std::numeric_limits<std::uint64_t>::max()) {
+	for (auto& bucket : mBuckets)
+		bucket.store(0, std::memory_order_relaxed);
+}
+
+Int TaskTimeStatistics::bucketIndex(std::uint64_t ns) {
+	if (ns < static_cast<std::uint64_t>(SubBuckets))
+		return static_cast<Int>(ns);
+	ns = std::min(ns, (std::uint64_t(1) << MaxExponent) - 1);
+
+	// Exact for integers below 2^53
+	Int exponent = std::ilogb(static_cast<double>(ns));
+	Int sub = static_cast<Int>(ns >> (exponent - SubBucketBits)) - SubBuckets;
+	return (exponent - SubBucketBits + 1) * SubBuckets + sub;
+}
+
+std::uint64_t TaskTimeStatistics::bucketValue(Int index) {
+	if (index < SubBuckets)
+		return index;
+
+	Int shift = index / SubBuckets - 1;
+	std::uint64_t low = static_cast<std::uint64_t>(SubBuckets + index % SubBuckets) << shift;
+	return low + ((std::uint64_t(1) << shift) >> 1);
+}
+
+void TaskTimeStatistics::update(TaskTime time) {
+	auto ns = static_cast<std::uint64_t>(std::max<TaskTime::rep>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(), 0));
+
+	mCount.fetch_add(1, std::memory_order_relaxed);
+	mSum.fetch_add(ns, std::memory_order_relaxed);
+	mBuckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+
+	std::uint64_t prev = mMin.load(std::memory_order_relaxed);
+	while (ns < prev && !mMin.compare_exchange_weak(prev, ns, std::memory_order_relaxed));
+	prev = mMax.load(std::memory_order_relaxed);
+	while (ns > prev && !mMax.compare_exchange_weak(prev, ns, std::memory_order_relaxed));
+}
+
+TaskTimeStatistics::TaskTime TaskTimeStatistics::percentile(Real fraction) const {
+	std::uint64_t count = 0;
+	for (auto& bucket : mBuckets)
+		count += bucket.load(std::memory_order_relaxed);
+	if (count == 0)
+		return TaskTime(0);
+
+	auto rank = static_cast<std::uint64_t>(std::ceil(fraction * count));
+	rank = std::max<std::uint64_t>(rank, 1);
+
+	std::uint64_t cumulative = 0;
+	Int index = 0;
+	for (; index < NumBuckets - 1; index++) {
+		cumulative += mBuckets[index].load(std::memory_order_relaxed);
+		if (cumulative >= rank)
+			break;
+	}
+
+	// The exact extremes are known, so do not report values outside of them
+	std::uint64_t value = bucketValue(index);
+	value = std::max(value, mMin.load(std::memory_order_relaxed));
+	value = std::min(value, mMax.load(std::memory_order_relaxed));
+	return std::chrono::duration_cast<TaskTime>(std::chrono::nanoseconds(value));
+}
+
+TaskTimeStatistics::Summary TaskTimeStatistics::summary() const {
+	Summary s;
+	s.count = mCount.load(std::memory_order_relaxed);
+	if (s.count == 0)
+		return s;
+
+	auto toTime = [](std::uint64_t ns) {
+		return std::chrono::duration_cast<TaskTime>(std::chrono::nanoseconds(ns));
+	};
+	s.mean = toTime(mSum.load(std::memory_order_relaxed) / s.count);
+	s.min = toTime(mMin.load(std::memory_order_relaxed));
+	s.max = toTime(mMax.load(std::memory_order_relaxed));
+	s.p50 = percentile(0.5);
+	s.p99 = percentile(0.99);
+	s.p999 = percentile(0.999);
+	return s;
+}
+
+TaskTimeStatistics::TaskTime TaskTimeStatistics::Summary::get(Statistic statistic) const {
+	switch (statistic) {
+		case Statistic::Median: return p50;
+		case Statistic::P99: return p99;
+		case Statistic::P999: return p999;
+		case Statistic::Max: return max;
+		default: return mean;
+	}
+}
+
+TaskTimeStatistics::Statistic TaskTimeStatistics::parseStatistic(const String& name) {
+	if (name == "mean")
+		return Statistic::Mean;
+	if (name == "p50" || name == "median")
+		return Statistic::Median;
+	if (name == "p99")
+		return Statistic::P99;
+	if (name == "p99.9" || name == "p999")
+		return Statistic::P999;
+	if (name == "max")
+		return Statistic::Max;
+	throw CPS::InvalidArgumentException();
+}
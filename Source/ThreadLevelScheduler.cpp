@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <sstream>
 #include <typeinfo>
 
 using namespace CPS;
@@ -19,14 +20,22 @@ ThreadLevelScheduler::ThreadLevelScheduler(Int threads, String outMeasurementFil
 	ThreadScheduler(threads, outMeasurementFile, useConditionVariable), mInMeasurementFile(inMeasurementFile), mSortTaskTypes(sortTaskTypes) {
 }
 
+String ThreadLevelScheduler::configKey() const {
+	std::stringstream key;
+	key << ThreadScheduler::configKey() << "," << measurementFileKey(mInMeasurementFile) << "," << mSortTaskTypes;
+	return key.str();
+}
+
 void ThreadLevelScheduler::createSchedule(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges) {
 	Task::List ordered;
 	std::vector<Task::List> levels;
 
 	Scheduler::topologicalSort(tasks, inEdges, outEdges, ordered);
-	Scheduler::initMeasurements(ordered);
+	if (!mOutMeasurementFile.empty())
+		Scheduler::initMeasurements(ordered);
 
 	Scheduler::levelSchedule(ordered, inEdges, outEdges, levels);
+	ThreadScheduler::setTaskGraph(ordered, inEdges, outEdges);
 
 	if (!mInMeasurementFile.empty()) {
 		std::unordered_map<String, TaskTime::rep> measurements;
@@ -52,6 +61,13 @@ void ThreadLevelScheduler::createSchedule(const Task::List& tasks, const Edges&
 	ThreadScheduler::finishSchedule(inEdges);
 }
 
+void ThreadLevelScheduler::assignTasks(const std::unordered_map<String, TaskTime::rep>& costs) {
+	std::vector<Task::List> levels;
+	Scheduler::levelSchedule(mOrdered, mInEdges, mOutEdges, levels);
+	for (auto& level : levels)
+		scheduleLevel(level, costs, mInEdges);
+}
+
 void ThreadLevelScheduler::sortTasksByType(Task::List::iterator begin, CPS::Task::List::iterator end) {
 	auto cmp = [](const Task::Ptr& p1, const Task::Ptr& p2) -> bool {
 		// TODO: according to the standard, the ordering may change between invocations
@@ -7,23 +7,74 @@
  *********************************************************************************/
 
 #include <dpsim/ThreadListScheduler.h>
+#include <dpsim/TaskGraph.h>
 
+#include <algorithm>
 #include <queue>
+#include <sstream>
 
 using namespace CPS;
 using namespace DPsim;
 
+typedef Scheduler::TaskTime::rep Cost;
+
+// Tasks are named "<component>.<task>", so tasks with the same prefix access the same component state
+static std::vector<Int> taskComponents(const TaskGraph& graph) {
+	std::unordered_map<String, Int> components;
+	std::vector<Int> component(graph.size());
+	for (Int i = 0; i < graph.size(); i++) {
+		String name = graph.task(i)->toString();
+		auto it = components.emplace(name.substr(0, name.rfind('.')), static_cast<Int>(components.size())).first;
+		component[i] = it->second;
+	}
+	return component;
+}
+
+// Makespan and number of edges between threads for tasks assigned
+// in the given order, according to the communication model
+static Cost evaluateAssignment(const TaskGraph& graph, const std::vector<Cost>& cost, const std::vector<Int>& order,
+	const std::vector<Int>& threadOf, Int numThreads, const ThreadListScheduler::CommunicationModel& model, size_t& crossEdges) {
+	auto component = taskComponents(graph);
+	std::vector<Int> lastThread(graph.size(), -1);
+	std::vector<Cost> threadTimes(numThreads, 0), finish(graph.size(), 0);
+	crossEdges = 0;
+	for (Int i : order) {
+		Int thread = threadOf[i];
+		Cost start = threadTimes[thread];
+		for (Int p : graph.predecessors(i)) {
+			if (threadOf[p] != thread) {
+				start = std::max(start, finish[p] + model.edgeCost);
+				crossEdges++;
+			} else {
+				start = std::max(start, finish[p]);
+			}
+		}
+		Cost migration = lastThread[component[i]] >= 0 && lastThread[component[i]] != thread ? model.componentCost : 0;
+		finish[i] = threadTimes[thread] = start + cost[i] + migration;
+		lastThread[component[i]] = thread;
+	}
+	return *std::max_element(threadTimes.begin(), threadTimes.end());
+}
+
 ThreadListScheduler::ThreadListScheduler(Int threads, String outMeasurementFile, String inMeasurementFile, Bool useConditionVariables) :
 	ThreadScheduler(threads, outMeasurementFile, useConditionVariables), mInMeasurementFile(inMeasurementFile) {
 }
 
+String ThreadListScheduler::configKey() const {
+	std::stringstream key;
+	key << ThreadScheduler::configKey() << "," << measurementFileKey(mInMeasurementFile)
+		<< "," << mCommunication.enabled << "," << mCommunication.edgeCost
+		<< "," << mCommunication.componentCost << "," << mCommunication.taskCost;
+	return key.str();
+}
+
 void ThreadListScheduler::createSchedule(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges) {
 	Task::List ordered;
 
 	Scheduler::topologicalSort(tasks, inEdges, outEdges, ordered);
-	Scheduler::initMeasurements(ordered);
+	if (!mOutMeasurementFile.empty())
+		Scheduler::initMeasurements(ordered);
 
-	std::unordered_map<Task::Ptr, int64_t> priorities;
 	std::unordered_map<String, TaskTime::rep> measurements;
 	if (!mInMeasurementFile.empty()) {
 		readMeasurements(mInMeasurementFile, measurements);
@@ -36,61 +87,144 @@ void ThreadListScheduler::createSchedule(const Task::List& tasks, const Edges& i
 	} else {
 		// Insert constant cost for each task (HLFNET)
 		for (auto task : ordered) {
-			measurements[task->toString()] = 1;
+			measurements[task->toString()] = mCommunication.enabled ? mCommunication.taskCost : 1;
 		}
 	}
 
+	ThreadScheduler::setTaskGraph(ordered, inEdges, outEdges);
+	scheduleList(ordered, outEdges, measurements);
+	ThreadScheduler::finishSchedule(inEdges);
+}
+
+void ThreadListScheduler::assignTasks(const std::unordered_map<String, TaskTime::rep>& costs) {
+	scheduleList(mOrdered, mOutEdges, costs);
+}
+
+void ThreadListScheduler::scheduleList(const Task::List& ordered, const Edges& outEdges, const std::unordered_map<String, TaskTime::rep>& costs) {
+	if (mCommunication.enabled) {
+		scheduleEarliestFinish(ordered, outEdges, costs);
+		return;
+	}
+
+	TaskGraph graph(ordered, outEdges, true);
+	Int numTasks = graph.size();
+	std::vector<TaskTime::rep> cost(numTasks);
+	for (Int i = 0; i < numTasks; i++)
+		cost[i] = costs.at(ordered[i]->toString());
+
 	// HLFET
-	for (auto it = ordered.rbegin(); it != ordered.rend(); ++it) {
-		auto task = *it;
+	std::vector<int64_t> priorities(numTasks, 0);
+	for (Int i = numTasks - 1; i >= 0; i--) {
 		int64_t maxLevel = 0;
-		if (outEdges.find(task) != outEdges.end()) {
-			for (auto dep : outEdges.at(task)) {
-				if (priorities[dep] > maxLevel) {
-					maxLevel = priorities[dep];
-				}
-			}
-		}
-		priorities[task] = measurements.at(task->toString()) + maxLevel;
+		for (Int dep : graph.successors(i))
+			maxLevel = std::max(maxLevel, priorities[dep]);
+		priorities[i] = cost[i] + maxLevel;
 	}
 
-	auto cmp = [&priorities](const Task::Ptr& p1, const Task::Ptr& p2) -> bool {
-		return priorities[p1] < priorities[p2];
+	// Ties are broken by the topological order to keep the schedule deterministic
+	auto cmp = [&priorities](Int i1, Int i2) -> bool {
+		return priorities[i1] < priorities[i2] || (priorities[i1] == priorities[i2] && i1 > i2);
 	};
-	std::priority_queue<Task::Ptr, std::deque<Task::Ptr>, decltype(cmp)> queue(cmp);
-	for (auto task : ordered) {
-		if (inEdges.find(task) == inEdges.end() || inEdges.at(task).empty()) {
-			queue.push(task);
-		} else {
-			break;
-		}
+	std::priority_queue<Int, std::vector<Int>, decltype(cmp)> queue(cmp);
+	std::vector<Int> remaining(numTasks);
+	for (Int i = 0; i < numTasks; i++) {
+		remaining[i] = static_cast<Int>(graph.predecessors(i).size());
+		if (remaining[i] == 0)
+			queue.push(i);
 	}
 
 	std::vector<TaskTime::rep> totalTimes(mNumThreads, 0);
-	Edges inEdgesCpy = inEdges;
+	std::vector<Int> threadOf(numTasks, -1), order;
+	order.reserve(numTasks);
 	while (!queue.empty()) {
-		auto task = queue.top();
+		Int idx = queue.top();
 		queue.pop();
 
 		auto minIt = std::min_element(totalTimes.begin(), totalTimes.end());
 		Int minIdx = static_cast<UInt>(minIt - totalTimes.begin());
-		scheduleTask(minIdx, task);
-		totalTimes[minIdx] += measurements.at(task->toString());
-
-		if (outEdges.find(task) != outEdges.end()) {
-			for (auto after : outEdges.at(task)) {
-				for (auto edgeIt = inEdgesCpy[after].begin(); edgeIt != inEdgesCpy[after].end(); ++edgeIt) {
-					if (*edgeIt == task) {
-						inEdgesCpy[after].erase(edgeIt);
-						break;
-					}
-				}
-				if (inEdgesCpy[after].empty() && std::find(ordered.begin(), ordered.end(), after) != ordered.end()) {
-					queue.push(after);
-				}
+		scheduleTask(minIdx, ordered[idx]);
+		totalTimes[minIdx] += cost[idx];
+		threadOf[idx] = minIdx;
+		order.push_back(idx);
+
+		for (Int after : graph.successors(idx)) {
+			if (--remaining[after] == 0)
+				queue.push(after);
+		}
+	}
+
+	// Same estimate as for the earliest finish time placement for comparison
+	size_t crossEdges;
+	Cost makespan = evaluateAssignment(graph, cost, order, threadOf, mNumThreads, mCommunication, crossEdges);
+	mSLog->info("List schedule: estimated makespan {} ns, {} of {} edges between threads",
+		makespan, crossEdges, graph.numEdges());
+}
+
+void ThreadListScheduler::scheduleEarliestFinish(const Task::List& ordered, const Edges& outEdges, const std::unordered_map<String, TaskTime::rep>& costs) {
+	TaskGraph graph(ordered, outEdges, true);
+	Int numTasks = graph.size();
+	std::vector<Cost> cost(numTasks);
+	for (Int i = 0; i < numTasks; i++)
+		cost[i] = costs.at(ordered[i]->toString());
+	auto component = taskComponents(graph);
+
+	// Upward rank: longest path to an exit task, assuming that every edge crosses threads
+	std::vector<Cost> rank(numTasks, 0);
+	for (Int i = numTasks - 1; i >= 0; i--) {
+		Cost maxRank = 0;
+		for (Int succ : graph.successors(i))
+			maxRank = std::max(maxRank, mCommunication.edgeCost + rank[succ]);
+		rank[i] = cost[i] + maxRank;
+	}
+
+	auto cmp = [&rank](Int i1, Int i2) -> bool {
+		return rank[i1] < rank[i2] || (rank[i1] == rank[i2] && i1 > i2);
+	};
+	std::priority_queue<Int, std::vector<Int>, decltype(cmp)> queue(cmp);
+	std::vector<Int> remaining(numTasks);
+	for (Int i = 0; i < numTasks; i++) {
+		remaining[i] = static_cast<Int>(graph.predecessors(i).size());
+		if (remaining[i] == 0)
+			queue.push(i);
+	}
+
+	// Tasks are appended to the threads, so the threads execute them in the order
+	// of assignment, which is a topological order
+	std::vector<Cost> threadTimes(mNumThreads, 0), finish(numTasks, 0);
+	std::vector<Int> threadOf(numTasks, -1), lastThread(numTasks, -1), order;
+	order.reserve(numTasks);
+	while (!queue.empty()) {
+		Int idx = queue.top();
+		queue.pop();
+
+		Int bestThread = 0;
+		Cost bestFinish = 0;
+		for (Int thread = 0; thread < mNumThreads; thread++) {
+			Cost start = threadTimes[thread];
+			for (Int p : graph.predecessors(idx))
+				start = std::max(start, finish[p] + (threadOf[p] != thread ? mCommunication.edgeCost : 0));
+			Int last = lastThread[component[idx]];
+			Cost end = start + cost[idx] + (last >= 0 && last != thread ? mCommunication.componentCost : 0);
+			if (thread == 0 || end < bestFinish) {
+				bestThread = thread;
+				bestFinish = end;
 			}
 		}
+
+		scheduleTask(bestThread, ordered[idx]);
+		threadOf[idx] = bestThread;
+		finish[idx] = threadTimes[bestThread] = bestFinish;
+		lastThread[component[idx]] = bestThread;
+		order.push_back(idx);
+
+		for (Int after : graph.successors(idx)) {
+			if (--remaining[after] == 0)
+				queue.push(after);
+		}
 	}
 
-	ThreadScheduler::finishSchedule(inEdges);
+	size_t crossEdges;
+	Cost makespan = evaluateAssignment(graph, cost, order, threadOf, mNumThreads, mCommunication, crossEdges);
+	mSLog->info("Earliest finish time schedule: estimated makespan {} ns, {} of {} edges between threads",
+		makespan, crossEdges, graph.numEdges());
 }
@@ -0,0 +1,186 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <dpsim/ThreadPlacement.h>
+#include <cps/Definitions.h>
+
+#ifdef __linux__
+  #include <pthread.h>
+  #include <sched.h>
+  #include <sys/mman.h>
+#endif
+
+using namespace DPsim;
+using CPS::SystemError;
+
+std::vector<Int> ThreadPlacement::parseCpuList(const String& list) {
+	std::vector<Int> cpus;
+	std::stringstream ss(list);
+	String range;
+	while (std::getline(ss, range, ',')) {
+		range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+		if (range.empty())
+			continue;
+		try {
+			auto dash = range.find('-');
+			if (dash == String::npos) {
+				cpus.push_back(std::stoi(range));
+			} else {
+				Int first = std::stoi(range.substr(0, dash));
+				Int last = std::stoi(range.substr(dash + 1));
+				for (Int cpu = first; cpu <= last; cpu++)
+					cpus.push_back(cpu);
+			}
+		} catch (std::logic_error&) {
+			throw SystemError("Invalid CPU list '" + list + "'", EINVAL);
+		}
+	}
+	return cpus;
+}
+
+std::vector<Int> ThreadPlacement::isolatedCpus() {
+	std::ifstream fs("/sys/devices/system/cpu/isolated");
+	String list;
+	if (fs.good())
+		std::getline(fs, list);
+	return parseCpuList(list);
+}
+
+Int ThreadPlacement::numaNode(Int cpu) {
+	// Each NUMA node lists its CPUs in sysfs
+	for (Int node = 0; node < 64; node++) {
+		std::ifstream fs("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+		if (!fs.good())
+			return -1;
+		String list;
+		std::getline(fs, list);
+		auto cpus = parseCpuList(list);
+		if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end())
+			return node;
+	}
+	return -1;
+}
+
+std::vector<Int> ThreadPlacement::assignCpus(const ThreadPlacementConfig& config, Int numThreads) {
+	std::vector<Int> cpus = config.cpus;
+	if (config.isolatedCores) {
+		auto isolated = isolatedCpus();
+		if (cpus.empty()) {
+			cpus = isolated;
+		} else {
+			for (Int cpu : cpus) {
+				if (std::find(isolated.begin(), isolated.end(), cpu) == isolated.end())
+					throw SystemError("CPU " + std::to_string(cpu) + " is not isolated", EINVAL);
+			}
+		}
+		if (cpus.empty())
+			throw SystemError("No isolated CPUs available", ENODEV);
+	}
+
+	std::vector<Int> assignment(numThreads, -1);
+	if (!cpus.empty()) {
+		for (Int thread = 0; thread < numThreads; thread++)
+			assignment[thread] = cpus[thread % cpus.size()];
+	}
+	return assignment;
+}
+
+#ifdef __linux__
+static void applyToHandle(pthread_t handle, Int cpu, Int realTimePriority) {
+	if (cpu >= 0) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		int ret = pthread_setaffinity_np(handle, sizeof(set), &set);
+		if (ret)
+			throw SystemError("Failed to pin thread to CPU " + std::to_string(cpu), ret);
+	}
+	if (realTimePriority > 0) {
+		sched_param param;
+		param.sched_priority = realTimePriority;
+		int ret = pthread_setschedparam(handle, SCHED_FIFO, &param);
+		if (ret)
+			throw SystemError("Failed to set real-time priority", ret);
+	}
+}
+#endif
+
+void ThreadPlacement::applyToCurrentThread(Int cpu, Int realTimePriority) {
+#ifdef __linux__
+	applyToHandle(pthread_self(), cpu, realTimePriority);
+#else
+	if (cpu >= 0 || realTimePriority > 0)
+		throw SystemError("Thread placement is not supported on this platform", ENOSYS);
+#endif
+}
+
+ThreadPlacement::State ThreadPlacement::currentThreadState() {
+	State state;
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (!pthread_getaffinity_np(pthread_self(), sizeof(set), &set)) {
+		for (Int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (CPU_ISSET(cpu, &set))
+				state.cpus.push_back(cpu);
+		}
+	}
+	sched_param param;
+	if (!pthread_getschedparam(pthread_self(), &state.policy, &param))
+		state.priority = param.sched_priority;
+#endif
+	return state;
+}
+
+void ThreadPlacement::restoreCurrentThread(const State& state) {
+#ifdef __linux__
+	if (!state.cpus.empty()) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (Int cpu : state.cpus)
+			CPU_SET(cpu, &set);
+		int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+		if (ret)
+			throw SystemError("Failed to restore CPU affinity", ret);
+	}
+	sched_param param;
+	param.sched_priority = state.priority;
+	int ret = pthread_setschedparam(pthread_self(), state.policy, &param);
+	if (ret)
+		throw SystemError("Failed to restore scheduling policy", ret);
+#endif
+}
+
+void ThreadPlacement::applyToThread(std::thread& thread, Int cpu, Int realTimePriority) {
+#ifdef __linux__
+	applyToHandle(thread.native_handle(), cpu, realTimePriority);
+#else
+	if (cpu >= 0 || realTimePriority > 0)
+		throw SystemError("Thread placement is not supported on this platform", ENOSYS);
+#endif
+}
+
+void ThreadPlacement::lockMemory() {
+#ifdef __linux__
+	if (mlockall(MCL_CURRENT | MCL_FUTURE))
+		throw SystemError("Failed to lock memory");
+#else
+	throw SystemError("Memory locking is not supported on this platform", ENOSYS);
+#endif
+}
+
+String ThreadPlacement::describe(Int thread, Int cpu) {
+	if (cpu < 0)
+		return "Thread " + std::to_string(thread) + ": unpinned";
+	return "Thread " + std::to_string(thread) + ": CPU " + std::to_string(cpu)
+		+ ", NUMA node " + std::to_string(numaNode(cpu));
+}
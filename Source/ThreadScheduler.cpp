@@ -7,14 +7,19 @@
  *********************************************************************************/
 
 #include <dpsim/ThreadScheduler.h>
+#include <dpsim/TaskGraph.h>
 
+#include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <unordered_map>
 
 using namespace CPS;
 using namespace DPsim;
 
 ThreadScheduler::ThreadScheduler(Int threads, String outMeasurementFile, Bool useConditionVariable) :
-	mNumThreads(threads), mOutMeasurementFile(outMeasurementFile), mStartBarrier(threads, useConditionVariable) {
+	mNumThreads(threads), mOutMeasurementFile(outMeasurementFile),
+	mStartBarrier(threads, useConditionVariable), mEndBarrier(threads, useConditionVariable) {
 	if (threads < 1)
 		throw SchedulingException();
 	mTempSchedules.resize(threads);
@@ -30,9 +35,72 @@ void ThreadScheduler::scheduleTask(int thread, CPS::Task::Ptr task) {
 	mTempSchedules[thread].push_back(task);
 }
 
+Bool ThreadScheduler::exportSchedule(std::vector<Task::List>& groups) const {
+	groups = mTempSchedules;
+	return true;
+}
+
+void ThreadScheduler::importSchedule(const std::vector<Task::List>& groups, const Edges& inEdges, const Edges& outEdges) {
+	if (static_cast<Int>(groups.size()) != mNumThreads)
+		throw SchedulingException();
+
+	mTempSchedules = groups;
+	if (!mOutMeasurementFile.empty()) {
+		for (auto& schedule : mTempSchedules)
+			Scheduler::initMeasurements(schedule);
+	}
+	if (mAdaptive.enabled) {
+		Task::List tasks;
+		for (auto& schedule : mTempSchedules)
+			tasks.insert(tasks.end(), schedule.begin(), schedule.end());
+		TaskGraph graph(tasks, outEdges);
+		Task::List ordered;
+		for (Int idx : graph.topologicalOrder())
+			ordered.push_back(graph.task(idx));
+		setTaskGraph(ordered, inEdges, outEdges);
+	}
+	finishSchedule(inEdges);
+}
+
+String ThreadScheduler::configKey() const {
+	std::stringstream key;
+	key << Scheduler::configKey() << "," << mNumThreads << "," << mAdaptive.enabled << "," << mAdaptive.interval
+		<< "," << mAdaptive.continuous << "," << mAdaptive.threshold;
+	return key.str();
+}
+
+void ThreadScheduler::setTaskGraph(const Task::List& ordered, const Edges& inEdges, const Edges& outEdges) {
+	if (!mAdaptive.enabled)
+		return;
+	mOrdered = ordered;
+	mInEdges = inEdges;
+	mOutEdges = outEdges;
+}
+
 void ThreadScheduler::finishSchedule(const Edges& inEdges) {
-	std::map<CPS::Task::Ptr, Counter*> counters;
+	createEntries(inEdges, 0);
+	mMeasureInterval = mAdaptive.enabled;
+
+	for (int i = 1; i < mNumThreads; i++) {
+		mThreads.emplace_back(threadFunction, this, i);
+	}
+
+	if (mThreadPlacement.enabled()) {
+		auto cpus = ThreadPlacement::assignCpus(mThreadPlacement, mNumThreads);
+		mCallerPlacement = ThreadPlacement::currentThreadState();
+		mCallerPlaced = true;
+		ThreadPlacement::applyToCurrentThread(cpus[0], mThreadPlacement.realTimePriority);
+		for (Int i = 1; i < mNumThreads; i++)
+			ThreadPlacement::applyToThread(mThreads[i-1], cpus[i], mThreadPlacement.realTimePriority);
+		for (Int i = 0; i < mNumThreads; i++)
+			mSLog->info(ThreadPlacement::describe(i, cpus[i]));
+	}
+}
+
+void ThreadScheduler::createEntries(const Edges& inEdges, Int counterValue) {
+	std::unordered_map<CPS::Task::Ptr, Counter*> counters;
 	for (int thread = 0; thread < mNumThreads; thread++) {
+		delete[] mSchedules[thread];
 	//	std::cout << "Thread " << thread << std::endl;
 	//	for (auto& entry : mSchedules[thread]) {
 	//		Task* t = entry.task.get();
@@ -44,6 +112,8 @@ void ThreadScheduler::finishSchedule(const Edges& inEdges) {
 		for (size_t i = 0; i < mTempSchedules[thread].size(); i++) {
 			auto& task = mTempSchedules[thread][i];
 			mSchedules[thread][i].task = task.get();
+			mSchedules[thread][i].endCounter.setWaitConfig(mWaitConfig);
+			mSchedules[thread][i].endCounter.reset(counterValue);
 			counters[task] = &mSchedules[thread][i].endCounter;
 		}
 	}
@@ -57,9 +127,6 @@ void ThreadScheduler::finishSchedule(const Edges& inEdges) {
 			}
 		}
 	}
-	for (int i = 1; i < mNumThreads; i++) {
-		mThreads.emplace_back(threadFunction, this, i);
-	}
 }
 
 void ThreadScheduler::step(Real time, Int timeStepCount) {
@@ -73,6 +140,122 @@ void ThreadScheduler::step(Real time, Int timeStepCount) {
 		if (mTempSchedules[thread].size() != 0)
 			mSchedules[thread][mTempSchedules[thread].size()-1].endCounter.wait(mTimeStepCount+1);
 	}
+	if (!mMeasureInterval)
+		return;
+
+	// The helper threads may still be inside their last Counter::inc(), wait
+	// until they are done with the entries before the schedule can be replaced.
+	// mMeasureInterval only changes after this barrier, so that the helper
+	// threads decide the same as the main thread whether to signal it.
+	mEndBarrier.wait();
+	if (++mIntervalSteps == mAdaptive.interval) {
+		rebalance();
+		mIntervalSteps = 0;
+		mMeasureInterval = mAdaptive.continuous;
+	}
+}
+
+void ThreadScheduler::rebalance() {
+	// Average costs of the last interval
+	std::unordered_map<String, TaskTime::rep> costs;
+	size_t numTasks = 0;
+	for (int thread = 0; thread < mNumThreads; thread++) {
+		for (size_t i = 0; i < mTempSchedules[thread].size(); i++) {
+			auto& entry = mSchedules[thread][i];
+			costs[entry.task->toString()] = std::max<TaskTime::rep>(entry.intervalTime / mIntervalSteps, 1);
+			entry.intervalTime = 0;
+		}
+		numTasks += mTempSchedules[thread].size();
+	}
+
+	auto current = mTempSchedules;
+	for (auto& schedule : mTempSchedules)
+		schedule.clear();
+	assignTasks(costs);
+
+	size_t numAssigned = 0;
+	for (auto& schedule : mTempSchedules)
+		numAssigned += schedule.size();
+	if (numAssigned != numTasks) {
+		mSLog->warn("Adaptive scheduling is not supported by this scheduler");
+		mTempSchedules = current;
+		mMeasureInterval = false;
+		return;
+	}
+
+	TaskTime::rep before = estimateMakespan(current, costs);
+	TaskTime::rep after = estimateMakespan(mTempSchedules, costs);
+	if (after >= before * (1 - mAdaptive.threshold)) {
+		mSLog->debug("Schedule kept at step {}: estimated makespan {} ns, rebuilt {} ns",
+			mTimeStepCount, before, after);
+		mTempSchedules = current;
+		return;
+	}
+
+	for (int thread = 0; thread < mNumThreads; thread++) {
+		for (size_t i = 0; i < current[thread].size(); i++)
+			mReplacedWaitStatistics += mSchedules[thread][i].endCounter.waitStatistics();
+	}
+	createEntries(mInEdges, mTimeStepCount + 1);
+	mSLog->info("Rebalanced schedule at step {}: estimated makespan {} ns -> {} ns",
+		mTimeStepCount, before, after);
+}
+
+Scheduler::TaskTime::rep ThreadScheduler::estimateMakespan(const std::vector<Task::List>& schedules, const std::unordered_map<String, TaskTime::rep>& costs) const {
+	// Advance each thread as far as the dependencies allow until all tasks are finished
+	std::unordered_map<Task*, TaskTime::rep> finish;
+	std::vector<size_t> next(schedules.size(), 0);
+	std::vector<TaskTime::rep> threadTimes(schedules.size(), 0);
+	Bool progress = true;
+	while (progress) {
+		progress = false;
+		for (size_t thread = 0; thread < schedules.size(); thread++) {
+			for (; next[thread] < schedules[thread].size(); next[thread]++) {
+				auto& task = schedules[thread][next[thread]];
+				TaskTime::rep start = threadTimes[thread];
+				Bool ready = true;
+				auto edges = mInEdges.find(task);
+				if (edges != mInEdges.end()) {
+					for (auto& req : edges->second) {
+						auto it = finish.find(req.get());
+						if (it == finish.end()) {
+							ready = false;
+							break;
+						}
+						start = std::max(start, it->second);
+					}
+				}
+				if (!ready)
+					break;
+				threadTimes[thread] = start + costs.at(task->toString());
+				finish[task.get()] = threadTimes[thread];
+				progress = true;
+			}
+		}
+	}
+	for (size_t thread = 0; thread < schedules.size(); thread++) {
+		// Tasks left over wait for each other
+		if (next[thread] != schedules[thread].size())
+			throw SchedulingException();
+	}
+	return *std::max_element(threadTimes.begin(), threadTimes.end());
+}
+
+void ThreadScheduler::setWaitConfig(const WaitConfig& config) {
+	mWaitConfig = config;
+	mStartBarrier.setWaitConfig(config);
+	mEndBarrier.setWaitConfig(config);
+}
+
+WaitStatistics ThreadScheduler::waitStatistics() const {
+	WaitStatistics stats = mStartBarrier.waitStatistics();
+	stats += mEndBarrier.waitStatistics();
+	stats += mReplacedWaitStatistics;
+	for (int thread = 0; thread < mNumThreads; thread++) {
+		for (size_t i = 0; i < mTempSchedules[thread].size(); i++)
+			stats += mSchedules[thread][i].endCounter.waitStatistics();
+	}
+	return stats;
 }
 
 void ThreadScheduler::stop() {
@@ -83,6 +266,15 @@ void ThreadScheduler::stop() {
 			mThreads[thread].join();
 		}
 	}
+	if (mCallerPlaced) {
+		ThreadPlacement::restoreCurrentThread(mCallerPlacement);
+		mCallerPlaced = false;
+	}
+	if (mWaitConfig.collectStatistics) {
+		auto stats = waitStatistics();
+		mSLog->info("Waits: {} ({} blocked), spin time: {} ns, block time: {} ns",
+			stats.numWaits, stats.numBlocked, stats.spinTime.count(), stats.blockTime.count());
+	}
 	if (!mOutMeasurementFile.empty()) {
 		writeMeasurements(mOutMeasurementFile);
 	}
@@ -95,12 +287,16 @@ void ThreadScheduler::threadFunction(ThreadScheduler* sched, Int idx) {
 			return;
 
 		sched->doStep(idx);
+		if (sched->mMeasureInterval)
+			sched->mEndBarrier.signal();
 	}
 }
 
 void ThreadScheduler::doStep(Int thread) {
-	if (mOutMeasurementFile.empty()) {
-		for (size_t i = 0; i != mTempSchedules[thread].size(); i++) {
+	// Read once, the main thread may replace the schedule after the last entry
+	size_t numEntries = mTempSchedules[thread].size();
+	if (mOutMeasurementFile.empty() && !mMeasureInterval) {
+		for (size_t i = 0; i != numEntries; i++) {
 			ScheduleEntry* entry = &mSchedules[thread][i];
 			for (Counter* counter : entry->reqCounters)
 				counter->wait(mTimeStepCount+1);
@@ -108,14 +304,16 @@ void ThreadScheduler::doStep(Int thread) {
 			entry->endCounter.inc();
 		}
 	} else {
-		for (size_t i = 0; i != mTempSchedules[thread].size(); i++) {
+		for (size_t i = 0; i != numEntries; i++) {
 			ScheduleEntry* entry = &mSchedules[thread][i];
 			for (Counter* counter : entry->reqCounters)
 				counter->wait(mTimeStepCount+1);
 			auto start = std::chrono::steady_clock::now();
 			entry->task->execute(mTime, mTimeStepCount);
 			auto end = std::chrono::steady_clock::now();
-			updateMeasurement(entry->task, end-start);
+			if (!mOutMeasurementFile.empty())
+				updateMeasurement(entry->task, end-start);
+			entry->intervalTime += (end-start).count();
 			entry->endCounter.inc();
 		}
 	}
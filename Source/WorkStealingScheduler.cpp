@@ -0,0 +1,274 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <dpsim/WorkStealingScheduler.h>
+#include <dpsim/TaskGraph.h>
+
+using namespace CPS;
+using namespace DPsim;
+
+void WorkStealingScheduler::TaskDeque::resize(Int capacity) {
+	mBuffer.reset(new std::atomic<Int>[capacity > 0 ? capacity : 1]);
+	reset();
+}
+
+void WorkStealingScheduler::TaskDeque::reset() {
+	mTop.store(0, std::memory_order_relaxed);
+	mBottom.store(0, std::memory_order_relaxed);
+}
+
+void WorkStealingScheduler::TaskDeque::push(Int task) {
+	Int bottom = mBottom.load(std::memory_order_relaxed);
+	mBuffer[bottom].store(task, std::memory_order_relaxed);
+	mBottom.store(bottom + 1, std::memory_order_release);
+}
+
+Int WorkStealingScheduler::TaskDeque::pop() {
+	Int bottom = mBottom.load(std::memory_order_relaxed) - 1;
+	mBottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	Int top = mTop.load(std::memory_order_relaxed);
+
+	if (top > bottom) {
+		mBottom.store(bottom + 1, std::memory_order_relaxed);
+		return -1;
+	}
+	Int task = mBuffer[bottom].load(std::memory_order_relaxed);
+	if (top == bottom) {
+		// Last task, race against thieves
+		if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			task = -1;
+		mBottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return task;
+}
+
+Int WorkStealingScheduler::TaskDeque::steal() {
+	Int top = mTop.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	Int bottom = mBottom.load(std::memory_order_acquire);
+
+	if (top >= bottom)
+		return -1;
+	Int task = mBuffer[top].load(std::memory_order_relaxed);
+	if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return -1;
+	return task;
+}
+
+WorkStealingScheduler::WorkStealingScheduler(Int threads, String outMeasurementFile, Bool useConditionVariable) :
+	mNumThreads(threads), mOutMeasurementFile(outMeasurementFile),
+	mStartBarrier(threads, useConditionVariable), mEndBarrier(threads, useConditionVariable) {
+	if (threads < 1)
+		throw SchedulingException();
+	mWorkers.reset(new Worker[threads]);
+	for (Int thread = 0; thread < threads; thread++)
+		mWorkers[thread].numSteals = 0;
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+	// Helper threads must not outlive the scheduler even if stop() was not called
+	joinThreads();
+}
+
+void WorkStealingScheduler::createSchedule(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges) {
+	Task::List ordered;
+	Scheduler::topologicalSort(tasks, inEdges, outEdges, ordered);
+
+	if (!mOutMeasurementFile.empty())
+		Scheduler::initMeasurements(ordered);
+
+	initSchedule(ordered, outEdges);
+}
+
+Bool WorkStealingScheduler::exportSchedule(std::vector<Task::List>& groups) const {
+	groups = {mTasks};
+	return true;
+}
+
+void WorkStealingScheduler::importSchedule(const std::vector<Task::List>& groups, const Edges& inEdges, const Edges& outEdges) {
+	if (groups.size() != 1)
+		throw SchedulingException();
+
+	if (!mOutMeasurementFile.empty())
+		Scheduler::initMeasurements(groups[0]);
+
+	initSchedule(groups[0], outEdges);
+}
+
+void WorkStealingScheduler::initSchedule(const Task::List& ordered, const Edges& outEdges) {
+	// Only keep edges between scheduled tasks and merge edges
+	// that result from multiple shared attributes
+	TaskGraph graph(ordered, outEdges, true);
+	Int numTasks = graph.size();
+	mTasks.clear();
+	mNumDependencies.assign(numTasks, 0);
+	mSuccessors.assign(numTasks, std::vector<Int>());
+	for (Int i = 0; i < numTasks; i++) {
+		mTasks.push_back(ordered[i]);
+		auto successors = graph.successors(i);
+		mSuccessors[i].assign(successors.begin(), successors.end());
+		mNumDependencies[i] = static_cast<Int>(graph.predecessors(i).size());
+	}
+	mPendingDependencies.reset(new std::atomic<Int>[numTasks > 0 ? numTasks : 1]);
+
+	// Distribute the initially ready tasks round-robin, everything else
+	// is pushed by the thread that finishes the last dependency
+	Int next = 0;
+	for (Int thread = 0; thread < mNumThreads; thread++) {
+		mWorkers[thread].deque.resize(numTasks);
+		mWorkers[thread].initialTasks.clear();
+	}
+	for (Int task = numTasks - 1; task >= 0; task--) {
+		if (mNumDependencies[task] == 0) {
+			mWorkers[next].initialTasks.push_back(task);
+			next = (next + 1) % mNumThreads;
+		}
+	}
+
+	mSLog->info("Work stealing schedule with {} tasks on {} threads", numTasks, mNumThreads);
+
+	for (Int i = 1; i < mNumThreads; i++) {
+		mThreads.emplace_back(threadFunction, this, i);
+	}
+
+	if (mThreadPlacement.enabled()) {
+		auto cpus = ThreadPlacement::assignCpus(mThreadPlacement, mNumThreads);
+		mCallerPlacement = ThreadPlacement::currentThreadState();
+		mCallerPlaced = true;
+		ThreadPlacement::applyToCurrentThread(cpus[0], mThreadPlacement.realTimePriority);
+		for (Int i = 1; i < mNumThreads; i++)
+			ThreadPlacement::applyToThread(mThreads[i-1], cpus[i], mThreadPlacement.realTimePriority);
+		for (Int i = 0; i < mNumThreads; i++)
+			mSLog->info(ThreadPlacement::describe(i, cpus[i]));
+	}
+}
+
+void WorkStealingScheduler::step(Real time, Int timeStepCount) {
+	mTime = time;
+	mTimeStepCount = timeStepCount;
+
+	// All helper threads wait at the start barrier, so the shared state
+	// can be reset without synchronization
+	for (size_t task = 0; task < mTasks.size(); task++)
+		mPendingDependencies[task].store(mNumDependencies[task], std::memory_order_relaxed);
+	for (Int thread = 0; thread < mNumThreads; thread++) {
+		mWorkers[thread].deque.reset();
+		for (Int task : mWorkers[thread].initialTasks)
+			mWorkers[thread].deque.push(task);
+	}
+	mRemainingTasks.store(static_cast<Int>(mTasks.size()), std::memory_order_relaxed);
+
+	mStartBarrier.wait();
+	doStep(0);
+	// Helper threads may still be looking for work, wait until they are
+	// back at the start barrier before the state is reset again
+	mEndBarrier.wait();
+}
+
+void WorkStealingScheduler::joinThreads() {
+	if (!mThreads.empty()) {
+		mJoining = true;
+		mStartBarrier.wait();
+		for (size_t thread = 0; thread < mThreads.size(); thread++) {
+			mThreads[thread].join();
+		}
+		mThreads.clear();
+	}
+}
+
+void WorkStealingScheduler::setWaitConfig(const WaitConfig& config) {
+	mWaitConfig = config;
+	mStartBarrier.setWaitConfig(config);
+	mEndBarrier.setWaitConfig(config);
+}
+
+WaitStatistics WorkStealingScheduler::waitStatistics() const {
+	WaitStatistics stats = mStartBarrier.waitStatistics();
+	stats += mEndBarrier.waitStatistics();
+	return stats;
+}
+
+void WorkStealingScheduler::stop() {
+	joinThreads();
+	if (mCallerPlaced) {
+		ThreadPlacement::restoreCurrentThread(mCallerPlacement);
+		mCallerPlaced = false;
+	}
+	mSLog->info("Stolen tasks: {}", numSteals());
+	if (mWaitConfig.collectStatistics) {
+		auto stats = waitStatistics();
+		mSLog->info("Waits: {} ({} blocked), spin time: {} ns, block time: {} ns",
+			stats.numWaits, stats.numBlocked, stats.spinTime.count(), stats.blockTime.count());
+	}
+	if (!mOutMeasurementFile.empty()) {
+		writeMeasurements(mOutMeasurementFile);
+	}
+}
+
+UInt WorkStealingScheduler::numSteals() const {
+	UInt steals = 0;
+	for (Int thread = 0; thread < mNumThreads; thread++)
+		steals += mWorkers[thread].numSteals.load(std::memory_order_relaxed);
+	return steals;
+}
+
+void WorkStealingScheduler::threadFunction(WorkStealingScheduler* sched, Int idx) {
+	while (true) {
+		sched->mStartBarrier.wait();
+		if (sched->mJoining)
+			return;
+
+		sched->doStep(idx);
+		sched->mEndBarrier.signal();
+	}
+}
+
+Int WorkStealingScheduler::findTask(Int thread) {
+	Int task = mWorkers[thread].deque.pop();
+	if (task >= 0)
+		return task;
+
+	for (Int offset = 1; offset < mNumThreads; offset++) {
+		task = mWorkers[(thread + offset) % mNumThreads].deque.steal();
+		if (task >= 0) {
+			mWorkers[thread].numSteals.fetch_add(1, std::memory_order_relaxed);
+			return task;
+		}
+	}
+	return -1;
+}
+
+void WorkStealingScheduler::execute(Int thread, Int task) {
+	if (mOutMeasurementFile.empty()) {
+		mTasks[task]->execute(mTime, mTimeStepCount);
+	} else {
+		auto start = std::chrono::steady_clock::now();
+		mTasks[task]->execute(mTime, mTimeStepCount);
+		auto end = std::chrono::steady_clock::now();
+		updateMeasurement(mTasks[task].get(), end-start);
+	}
+
+	// The thread that resolves the last dependency runs the successor next,
+	// which keeps data produced by this task in the local cache
+	for (Int after : mSuccessors[task]) {
+		if (mPendingDependencies[after].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			mWorkers[thread].deque.push(after);
+	}
+	mRemainingTasks.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void WorkStealingScheduler::doStep(Int thread) {
+	while (mRemainingTasks.load(std::memory_order_acquire) > 0) {
+		Int task = findTask(thread);
+		if (task >= 0)
+			execute(thread, task);
+		else
+			AdaptiveWait::cpuRelax();
+	}
+}
@@ -85,6 +85,21 @@ PYBIND11_MODULE(dpsimpy, m) {
 		.def("log_attribute", &DPsim::Simulation::logAttribute, "name"_a, "attr"_a)
 		.def("do_init_from_nodes_and_terminals", &DPsim::Simulation::doInitFromNodesAndTerminals)
 		.def("do_system_matrix_recomputation", &DPsim::Simulation::doSystemMatrixRecomputation)
+		.def("do_switched_matrix_caching", &DPsim::Simulation::doSwitchedMatrixCaching)
+		.def("set_switched_matrix_cache_budget", &DPsim::Simulation::setSwitchedMatrixCacheBudget)
+		.def("do_sparse_right_vector_assembly", &DPsim::Simulation::doSparseRightVectorAssembly)
+		.def("do_low_rank_system_matrix_update", &DPsim::Simulation::doLowRankSystemMatrixUpdate)
+		.def("set_low_rank_update_max_rank", &DPsim::Simulation::setLowRankUpdateMaxRank)
+		.def("do_mixed_precision_solve", &DPsim::Simulation::doMixedPrecisionSolve)
+		.def("do_task_coarsening", &DPsim::Simulation::doTaskCoarsening, "value"_a = true)
+		.def("set_schedule_file", &DPsim::Simulation::setScheduleFile)
+		.def("set_automatic_tearing", &DPsim::Simulation::setAutomaticTearing)
+		.def("do_nested_diakoptics", &DPsim::Simulation::doNestedDiakoptics, "value"_a = true)
+		.def("do_automatic_decoupling", &DPsim::Simulation::doAutomaticDecoupling, "value"_a = true)
+		.def("do_pipelined_output", &DPsim::Simulation::doPipelinedOutput, "value"_a = true)
+		.def("add_scenario", &DPsim::Simulation::addScenario)
+		.def("do_complex_system_matrix", &DPsim::Simulation::doComplexSystemMatrix)
+		.def("set_mixed_precision_refinement", &DPsim::Simulation::setMixedPrecisionRefinement)
 		.def("do_steady_state_init", &DPsim::Simulation::doSteadyStateInit)
 		.def("do_frequency_parallelization", &DPsim::Simulation::doFrequencyParallelization)
 		.def("set_tearing_components", &DPsim::Simulation::setTearingComponents)
@@ -102,6 +117,8 @@ PYBIND11_MODULE(dpsimpy, m) {
 		.def("run", static_cast<void (DPsim::RealTimeSimulation::*)(CPS::Int startIn)>(&DPsim::RealTimeSimulation::run))
 		.def("set_solver", &DPsim::RealTimeSimulation::setSolverType)
 		.def("set_domain", &DPsim::RealTimeSimulation::setDomain)
+		.def("do_lock_memory", &DPsim::RealTimeSimulation::doLockMemory, "value"_a = true)
+		.def("set_thread_placement", &DPsim::RealTimeSimulation::setThreadPlacement, "cpu"_a, "real_time_priority"_a = 0)
 		.def("add_interface", &DPsim::RealTimeSimulation::addInterface, "interface"_a, "syncStart"_a = false); // cppcheck-suppress assignBoolToPointer
 
 	py::class_<CPS::SystemTopology, std::shared_ptr<CPS::SystemTopology>>(m, "SystemTopology")
@@ -116,6 +133,7 @@ PYBIND11_MODULE(dpsimpy, m) {
 		.def("connect_component", py::overload_cast<CPS::SimPowerComp<CPS::Complex>::Ptr, CPS::SimNode<CPS::Complex>::List>(&DPsim::SystemTopology::connectComponentToNodes<CPS::Complex>))
 		.def("component", &DPsim::SystemTopology::component<CPS::TopologicalPowerComp>)
 		.def("add_tear_component", &DPsim::SystemTopology::addTearComponent)
+		.def("decouple_lines", &DPsim::SystemTopology::decoupleLines, "time_step"_a, "log_level"_a = CPS::Logger::Level::off)
 #ifdef WITH_GRAPHVIZ
 		.def("_repr_svg_", &DPsim::SystemTopology::render)
 		.def("render_to_file", &DPsim::SystemTopology::renderToFile)
@@ -193,6 +211,7 @@ PYBIND11_MODULE(dpsimpy, m) {
 		.value("Undef", DPsim::MnaSolverFactory::MnaSolverImpl::Undef)
 		.value("EigenDense", DPsim::MnaSolverFactory::MnaSolverImpl::EigenDense)
 		.value("EigenSparse", DPsim::MnaSolverFactory::MnaSolverImpl::EigenSparse)
+		.value("KLU", DPsim::MnaSolverFactory::MnaSolverImpl::KLU)
 		.value("CUDADense", DPsim::MnaSolverFactory::MnaSolverImpl::CUDADense)
 		.value("CUDASparse", DPsim::MnaSolverFactory::MnaSolverImpl::CUDASparse)
 		.value("CUDAMagma", DPsim::MnaSolverFactory::MnaSolverImpl::CUDAMagma);
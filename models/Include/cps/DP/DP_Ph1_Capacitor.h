@@ -54,8 +54,12 @@ namespace Ph1 {
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
 		void mnaInitializeHarm(Real omega, Real timeStep, std::vector<Attribute<Matrix>::Ptr> leftVector);
 		/// Stamps system matrix
-		void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
-		void mnaApplySystemMatrixStampHarm(Matrix& systemMatrix, Int freqIdx);
+		void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
+		/// Stamps complex system matrix
+		void mnaApplyComplexSystemMatrixStamp(SparseMatrixCompRow& systemMatrix);
+		///
+		Bool mnaHasComplexSystemMatrixStamp() { return mNumFreqs == 1; }
+		void mnaApplySystemMatrixStampHarm(SparseMatrixRow& systemMatrix, Int freqIdx);
 		/// Stamps right side (source) vector
 		void mnaApplyRightSideVectorStamp(Matrix& rightVector);
 		void mnaApplyRightSideVectorStampHarm(Matrix& rightVector);
@@ -48,7 +48,7 @@ namespace Ph1 {
 		///
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
 		/// Stamps system matrix
-		void mnaApplySystemMatrixStamp(Matrix& systemMatrix) { }
+		void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) { }
 		/// Stamps right side (source) vector
 		void mnaApplyRightSideVectorStamp(Matrix& rightVector);
 		///
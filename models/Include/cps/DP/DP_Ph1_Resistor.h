@@ -40,9 +40,13 @@ namespace Ph1 {
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
 		void mnaInitializeHarm(Real omega, Real timeStep, std::vector<Attribute<Matrix>::Ptr> leftVector);
 		/// Stamps system matrix
-		void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
+		void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
+		/// Stamps complex system matrix
+		void mnaApplyComplexSystemMatrixStamp(SparseMatrixCompRow& systemMatrix);
+		///
+		Bool mnaHasComplexSystemMatrixStamp() { return mNumFreqs == 1; }
 		/// Stamps system matrix considering the frequency index
-		void mnaApplySystemMatrixStampHarm(Matrix& systemMatrix, Int freqIdx);
+		void mnaApplySystemMatrixStampHarm(SparseMatrixRow& systemMatrix, Int freqIdx);
 		/// Update interface voltage from MNA system result
 		void mnaUpdateVoltage(const Matrix& leftVector);
 		void mnaUpdateVoltageHarm(const Matrix& leftVector, Int freqIdx);
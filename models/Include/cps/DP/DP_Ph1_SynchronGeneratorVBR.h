@@ -65,7 +65,7 @@ namespace Ph1 {
 		Matrix get_parkTransformMatrix();        
 
 		// ### MNA Section ###
-		void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
+		void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
         void mnaApplyRightSideVectorStamp(Matrix& rightVector);
 		void mnaPostStep(const Matrix& leftVector);
 
@@ -44,7 +44,7 @@ namespace Ph3 {
 		///
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
 		/// Stamps system matrix
-		void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
+		void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
 		/// Update interface voltage from MNA system result
 		void mnaUpdateVoltage(const Matrix& leftVector);
 		/// Update interface current from MNA system result
@@ -54,7 +54,7 @@ namespace Ph3 {
 		/// Check if switch is closed
 		Bool mnaIsClosed() { return **mIsClosed; }
 		/// Stamps system matrix considering the defined switch position
-		void mnaApplySwitchSystemMatrixStamp(Bool closed, Matrix& systemMatrix, Int freqIdx);
+		void mnaApplySwitchSystemMatrixStamp(Bool closed, SparseMatrixRow& systemMatrix, Int freqIdx);
 
 		class MnaPostStep : public Task {
 		public:
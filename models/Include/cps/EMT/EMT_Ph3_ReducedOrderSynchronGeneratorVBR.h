@@ -50,7 +50,7 @@ namespace Ph3 {
 		Matrix get_inverseParkTransformMatrix();
 		
         // ### MNA Section ###
-        void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
+        void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
         void mnaApplyRightSideVectorStamp(Matrix& rightVector);
 		void mnaPostStep(const Matrix& leftVector);
 
@@ -99,7 +99,7 @@ namespace Ph3 {
 		///
 		void mnaApplyRightSideVectorStamp(Matrix& rightVector);
 		///
-		void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
+		void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
 		/// Retrieves calculated voltage from simulation for next step
 		void mnaPostStep(Matrix& rightVector, Matrix& leftVector, Real time);
 		///
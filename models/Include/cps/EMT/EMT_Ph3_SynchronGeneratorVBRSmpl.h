@@ -161,7 +161,7 @@ namespace Ph3 {
 		/// to calculate the flux and current from the voltage vector.
 		void mnaStep(Matrix& systemMatrix, Matrix& rightVector, Matrix& leftVector, Real time);
 		///
-		void mnaApplySystemMatrixStamp(Matrix& systemMatrix) override;
+		void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) override;
 		/// Retrieves calculated voltage from simulation for next step
 		void mnaPostStep(Matrix& rightVector, Matrix& leftVector, Real time);
 	};
@@ -70,7 +70,7 @@ namespace CPS {
 				/// Initializes internal variables of the component
 				void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
 				/// Stamps system matrix
-				void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
+				void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
 				/// Stamps right side (source) vector
 				void mnaApplyRightSideVectorStamp(Matrix& rightVector);
 				/// Updates internal current variable of the component
@@ -180,6 +180,79 @@ namespace CPS {
 					addToMatrixElement(mat, rows[phase], columns[phase], value);
 		}
 
+		// #### Sparse Matrix Operations ####
+		//
+		// Same layout as the dense operations above. Entries are accumulated in place
+		// via coeffRef, so stamping costs O(nnz) and never creates a dense copy.
+
+		static void setMatrixElement(SparseMatrixRow& mat, Matrix::Index row, Matrix::Index column, Complex value, Int maxFreq = 1, Int freqIdx = 0) {
+			// Assume square matrix
+			Eigen::Index harmonicOffset = mat.rows() / maxFreq;
+			Eigen::Index complexOffset = harmonicOffset / 2;
+			Eigen::Index harmRow = row + harmonicOffset * freqIdx;
+			Eigen::Index harmCol = column + harmonicOffset * freqIdx;
+
+			mat.coeffRef(harmRow, harmCol) = value.real();
+			mat.coeffRef(harmRow + complexOffset, harmCol + complexOffset) = value.real();
+			mat.coeffRef(harmRow, harmCol + complexOffset) = - value.imag();
+			mat.coeffRef(harmRow + complexOffset, harmCol) = value.imag();
+		}
+
+		static void addToMatrixElement(SparseMatrixRow& mat, Matrix::Index row, Matrix::Index column, Complex value, Int maxFreq = 1, Int freqIdx = 0) {
+			// Assume square matrix
+			Eigen::Index harmonicOffset = mat.rows() / maxFreq;
+			Eigen::Index complexOffset = harmonicOffset / 2;
+			Eigen::Index harmRow = row + harmonicOffset * freqIdx;
+			Eigen::Index harmCol = column + harmonicOffset * freqIdx;
+
+			mat.coeffRef(harmRow, harmCol) += value.real();
+			mat.coeffRef(harmRow + complexOffset, harmCol + complexOffset) += value.real();
+			mat.coeffRef(harmRow, harmCol + complexOffset) -= value.imag();
+			mat.coeffRef(harmRow + complexOffset, harmCol) += value.imag();
+		}
+
+		static void addToMatrixElement(SparseMatrixRow& mat, Matrix::Index row, Matrix::Index column, Matrix value, Int maxFreq = 1, Int freqIdx = 0) {
+			// Assume square matrix
+			Eigen::Index harmonicOffset = mat.rows() / maxFreq;
+			Eigen::Index complexOffset = harmonicOffset / 2;
+			Eigen::Index harmRow = row + harmonicOffset * freqIdx;
+			Eigen::Index harmCol = column + harmonicOffset * freqIdx;
+
+			mat.coeffRef(harmRow, harmCol) += value(0,0);
+			mat.coeffRef(harmRow + complexOffset, harmCol + complexOffset) += value(1,1);
+			mat.coeffRef(harmRow, harmCol + complexOffset) += value(0,1);
+			mat.coeffRef(harmRow + complexOffset, harmCol) += value(1,0);
+		}
+
+		static void setMatrixElement(SparseMatrixRow& mat, Matrix::Index row, Matrix::Index column, Real value) {
+			mat.coeffRef(row, column) = value;
+		}
+
+		static void addToMatrixElement(SparseMatrixRow& mat, std::vector<UInt> rows, std::vector<UInt> columns, Complex value) {
+			for (UInt phase = 0; phase < rows.size(); phase++)
+					addToMatrixElement(mat, rows[phase], columns[phase], value);
+		}
+
+		static void addToMatrixElement(SparseMatrixRow& mat, Matrix::Index row, Matrix::Index column, Real value) {
+			mat.coeffRef(row, column) += value;
+		}
+
+		static void addToMatrixElement(SparseMatrixRow& mat, std::vector<UInt> rows, std::vector<UInt> columns, Real value) {
+			for (UInt phase = 0; phase < rows.size(); phase++)
+					addToMatrixElement(mat, rows[phase], columns[phase], value);
+		}
+
+		// #### Complex sparse matrix operations ####
+		// One complex entry per matrix node index instead of the real and imaginary part blocks.
+
+		static void setMatrixElement(SparseMatrixCompRow& mat, Matrix::Index row, Matrix::Index column, Complex value) {
+			mat.coeffRef(row, column) = value;
+		}
+
+		static void addToMatrixElement(SparseMatrixCompRow& mat, Matrix::Index row, Matrix::Index column, Complex value) {
+			mat.coeffRef(row, column) += value;
+		}
+
 		// #### Integration Methods ####
 		static Matrix StateSpaceTrapezoidal(Matrix states, Matrix A, Matrix B, Real dt, Matrix u_new, Matrix u_old);
 		static Matrix StateSpaceTrapezoidal(Matrix states, Matrix A, Matrix B, Matrix C, Real dt, Matrix u_new, Matrix u_old);
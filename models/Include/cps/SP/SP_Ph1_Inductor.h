@@ -42,7 +42,11 @@ namespace Ph1 {
 		/// Initializes internal variables of the component
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
 		/// Stamps system matrix
-		void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
+		void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
+		/// Stamps complex system matrix
+		void mnaApplyComplexSystemMatrixStamp(SparseMatrixCompRow& systemMatrix);
+		///
+		Bool mnaHasComplexSystemMatrixStamp() { return true; }
 		/// Update interface voltage from MNA system results
 		void mnaUpdateVoltage(const Matrix& leftVector);
 		/// Update interface current from MNA system results
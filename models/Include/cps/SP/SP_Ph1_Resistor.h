@@ -69,7 +69,11 @@ namespace Ph1 {
 		///
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
 		/// Stamps system matrix
-		void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
+		void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
+		/// Stamps complex system matrix
+		void mnaApplyComplexSystemMatrixStamp(SparseMatrixCompRow& systemMatrix);
+		///
+		Bool mnaHasComplexSystemMatrixStamp() { return mNumFreqs == 1; }
 		/// Update interface voltage from MNA system result
 		void mnaUpdateVoltage(const Matrix& leftVector);
 		/// Update interface current from MNA system result
@@ -48,7 +48,7 @@ namespace Ph1 {
 
         // ### MNA Section ###
         ///
-        void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
+        void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
         void mnaApplyRightSideVectorStamp(Matrix& rightVector);      
         void mnaPostStep(const Matrix& leftVector);
         
@@ -41,7 +41,7 @@ namespace CPS {
 				///
 				void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
 				/// Stamps system matrix
-				void mnaApplySystemMatrixStamp(Matrix& systemMatrix);
+				void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
 				///
 				void mnaUpdateVoltage(const Matrix& leftVector);
 				///
@@ -23,6 +23,8 @@ namespace Signal {
 		public SharedFactory<DecouplingLine> {
 	protected:
 		Real mDelay;
+		/// Angular frequency of the phasors
+		Real mOmega;
 		Real mResistance;
 		Real mInductance, mCapacitance;
 		Real mSurgeImpedance;
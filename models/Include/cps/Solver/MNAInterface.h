@@ -21,7 +21,7 @@ namespace CPS {
 		typedef std::vector<Ptr> List;
 
 		/// This component's contribution ("stamp") to the right-side vector.
-		/// TODO performance improvements from a sparse representation, at least during copying / summation?
+		/// Only the rows of the component's nodes are added up by the solver.
 		const Attribute<Matrix>::Ptr mRightVector;
 
 		// #### MNA Base Functions ####
@@ -32,14 +32,12 @@ namespace CPS {
 		virtual void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector) {
 			mnaInitialize(omega, timeStep);
 		}
-		/// Stamps system matrix
-		virtual void mnaApplySystemMatrixStamp(Matrix& systemMatrix) { }
 		/// Stamps (sparse) system matrix
-		virtual void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
-			Matrix mat = Matrix(systemMatrix);
-			mnaApplySystemMatrixStamp(mat);
-			systemMatrix = mat.sparseView();
-		}
+		virtual void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) { }
+		/// Indicates that the component can stamp the complex system matrix of DP and SP simulations
+		virtual Bool mnaHasComplexSystemMatrixStamp() { return false; }
+		/// Stamps the complex system matrix with one row and column per matrix node index
+		virtual void mnaApplyComplexSystemMatrixStamp(SparseMatrixCompRow& systemMatrix) { }
 		/// Stamps right side (source) vector
 		virtual void mnaApplyRightSideVectorStamp(Matrix& rightVector) { }
 		/// Update interface voltage from MNA system result
@@ -61,7 +59,7 @@ namespace CPS {
 			mnaInitialize(omega, timeStep);
 		}
 		/// Stamps system matrix considering the frequency index
-		virtual void mnaApplySystemMatrixStampHarm(Matrix& systemMatrix, Int freqIdx) { }
+		virtual void mnaApplySystemMatrixStampHarm(SparseMatrixRow& systemMatrix, Int freqIdx) { }
 		/// Stamps right side (source) vector considering the frequency index
 		virtual void mnaApplyRightSideVectorStampHarm(Matrix& sourceVector) { }
 		virtual void mnaApplyRightSideVectorStampHarm(Matrix& sourceVector, Int freqIdx) { }
@@ -69,11 +67,35 @@ namespace CPS {
 		const Task::List& mnaTasks() {
 			return mMnaTasks;
 		}
+		/// Sets the rows of the right-side vector that the solver adds up for this
+		/// component, an empty list stands for the whole vector
+		void mnaSetRightVectorRows(const std::vector<UInt>& rows) {
+			mRightVectorRows = rows;
+		}
 	protected:
 		/// Every MNA component modifies its source vector attribute.
 		MNAInterface() : mRightVector(Attribute<Matrix>::createDynamic("right_vector", mAttributes)) { }
 
+		/// Sets the rows of the right-side vector used by this component to zero
+		void mnaZeroRightVectorRows(Matrix& rightVector) {
+			if (mRightVectorRows.empty())
+				rightVector.setZero();
+			else
+				for (auto row : mRightVectorRows)
+					rightVector(row, 0) = 0;
+		}
+		/// Adds the rows of a subcomponent stamp used by this component
+		void mnaAddRightVectorRows(Matrix& rightVector, const Matrix& stamp) {
+			if (mRightVectorRows.empty())
+				rightVector += stamp;
+			else
+				for (auto row : mRightVectorRows)
+					rightVector(row, 0) += stamp(row, 0);
+		}
+
 		/// List of tasks that relate to using MNA for this component (usually pre-step and/or post-step)
 		Task::List mMnaTasks;
+		/// Rows of the right-side vector used by this component, all rows if empty
+		std::vector<UInt> mRightVectorRows;
 	};
 }
@@ -254,6 +254,11 @@ namespace CPS {
 		template <typename VarType>
 		void splitSubnets(std::vector<CPS::SystemTopology>& splitSystems);
 
+		/// Replaces the lines whose propagation delay is at least the time step by decoupling
+		/// lines, so that the network splits into independent subnets. Only single phase DP
+		/// PiLines are replaced, their parallel conductance is neglected. Returns the decoupling lines.
+		IdentifiedObject::List decoupleLines(Real timeStep, Logger::Level logLevel = Logger::Level::off);
+
 #ifdef WITH_GRAPHVIZ
 		Graph::Graph topologyGraph();
 		String render();
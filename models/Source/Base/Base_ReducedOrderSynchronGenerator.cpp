@@ -289,7 +289,7 @@ template <typename VarType>
 void Base::ReducedOrderSynchronGenerator<VarType>::MnaPreStep::execute(Real time, Int timeStepCount) {
 	mSynGen.mSimTime = time;
 	mSynGen.stepInPerUnit();
-	(**mSynGen.mRightVector).setZero();
+	mSynGen.mnaZeroRightVectorRows(**mSynGen.mRightVector);
 	mSynGen.mnaApplyRightSideVectorStamp(**mSynGen.mRightVector);
 }
 
@@ -271,16 +271,16 @@ void DP::Ph1::AvVoltageSourceInverterDQ::mnaInitialize(Real omega, Real timeStep
 }
 
 
-void DP::Ph1::AvVoltageSourceInverterDQ::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::AvVoltageSourceInverterDQ::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	for (auto subcomp: mSubComponents)
 		if (auto mnasubcomp = std::dynamic_pointer_cast<MNAInterface>(subcomp))
 			mnasubcomp->mnaApplySystemMatrixStamp(systemMatrix);
 }
 
 void DP::Ph1::AvVoltageSourceInverterDQ::mnaApplyRightSideVectorStamp(Matrix& rightVector) {
-	rightVector.setZero();
+	mnaZeroRightVectorRows(rightVector);
 	for (auto stamp : mRightVectorStamps)
-		rightVector += *stamp;
+		mnaAddRightVectorRows(rightVector, *stamp);
 }
 
 void DP::Ph1::AvVoltageSourceInverterDQ::addControlPreStepDependencies(AttributeBase::List &prevStepDependencies, AttributeBase::List &attributeDependencies, AttributeBase::List &modifiedAttributes) {
@@ -111,7 +111,7 @@ void DP::Ph1::Inductor::mnaInitializeHarm(Real omega, Real timeStep, std::vector
 	**mRightVector = Matrix::Zero(leftVectors[0]->get().rows(), mNumFreqs);
 }
 
-void DP::Ph1::Inductor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::Inductor::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	for (UInt freq = 0; freq < mNumFreqs; freq++) {
 		if (terminalNotGrounded(0))
 			Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0), matrixNodeIndex(0), mEquivCond(freq,0), mNumFreqs, freq);
@@ -138,7 +138,18 @@ void DP::Ph1::Inductor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
 	}
 }
 
-void DP::Ph1::Inductor::mnaApplySystemMatrixStampHarm(Matrix& systemMatrix, Int freqIdx) {
+void DP::Ph1::Inductor::mnaApplyComplexSystemMatrixStamp(SparseMatrixCompRow& systemMatrix) {
+	if (terminalNotGrounded(0))
+		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0), matrixNodeIndex(0), mEquivCond(0,0));
+	if (terminalNotGrounded(1))
+		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(1), matrixNodeIndex(1), mEquivCond(0,0));
+	if (terminalNotGrounded(0) && terminalNotGrounded(1)) {
+		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0), matrixNodeIndex(1), -mEquivCond(0,0));
+		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(1), matrixNodeIndex(0), -mEquivCond(0,0));
+	}
+}
+
+void DP::Ph1::Inductor::mnaApplySystemMatrixStampHarm(SparseMatrixRow& systemMatrix, Int freqIdx) {
 		if (terminalNotGrounded(0))
 			Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0), matrixNodeIndex(0), mEquivCond(freqIdx,0));
 		if (terminalNotGrounded(1))
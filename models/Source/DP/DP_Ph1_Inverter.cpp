@@ -130,7 +130,7 @@ void DP::Ph1::Inverter::mnaInitializeHarm(Real omega, Real timeStep, std::vector
 	calculatePhasors();
 }
 
-void DP::Ph1::Inverter::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::Inverter::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mSLog->info("--- Stamping into system matrix ---");
 
 	for (UInt freq = 0; freq < mNumFreqs; freq++) {
@@ -148,7 +148,7 @@ void DP::Ph1::Inverter::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
 	mSLog->info("--- Stamping into system matrix end ---");
 }
 
-void DP::Ph1::Inverter::mnaApplySystemMatrixStampHarm(Matrix& systemMatrix, Int freqIdx) {
+void DP::Ph1::Inverter::mnaApplySystemMatrixStampHarm(SparseMatrixRow& systemMatrix, Int freqIdx) {
 	mSLog->info("Stamp frequency {:d}", freqIdx);
 	if (terminalNotGrounded(0)) {
 		Math::setMatrixElement(systemMatrix, mVirtualNodes[0]->matrixNodeIndex(), matrixNodeIndex(0), Complex(1, 0));
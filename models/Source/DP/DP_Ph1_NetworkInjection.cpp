@@ -116,16 +116,16 @@ void DP::Ph1::NetworkInjection::mnaInitialize(Real omega, Real timeStep, Attribu
 	**mRightVector = Matrix::Zero(leftVector->get().rows(), 1);
 }
 
-void DP::Ph1::NetworkInjection::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::NetworkInjection::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	for (auto subcomp: mSubComponents)
 		if (auto mnasubcomp = std::dynamic_pointer_cast<MNAInterface>(subcomp))
 			mnasubcomp->mnaApplySystemMatrixStamp(systemMatrix);
 }
 
 void DP::Ph1::NetworkInjection::mnaApplyRightSideVectorStamp(Matrix& rightVector) {
-	rightVector.setZero();
+	mnaZeroRightVectorRows(rightVector);
 	for (auto stamp : mRightVectorStamps)
-		rightVector += *stamp;
+		mnaAddRightVectorRows(rightVector, *stamp);
 
 	mSLog->debug("Right Side Vector: {:s}",
 				Logger::matrixToString(rightVector));
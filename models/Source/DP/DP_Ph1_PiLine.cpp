@@ -132,7 +132,7 @@ void DP::Ph1::PiLine::mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>
 	**mRightVector = Matrix::Zero(leftVector->get().rows(), 1);
 }
 
-void DP::Ph1::PiLine::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::PiLine::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mSubSeriesResistor->mnaApplySystemMatrixStamp(systemMatrix);
 	mSubSeriesInductor->mnaApplySystemMatrixStamp(systemMatrix);
 
@@ -146,9 +146,9 @@ void DP::Ph1::PiLine::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
 }
 
 void DP::Ph1::PiLine::mnaApplyRightSideVectorStamp(Matrix& rightVector) {
-	rightVector.setZero();
+	mnaZeroRightVectorRows(rightVector);
 	for (auto stamp : mRightVectorStamps)
-		rightVector += *stamp;
+		mnaAddRightVectorRows(rightVector, *stamp);
 }
 
 void DP::Ph1::PiLine::mnaAddPreStepDependencies(AttributeBase::List &prevStepDependencies, AttributeBase::List &attributeDependencies, AttributeBase::List &modifiedAttributes) {
@@ -136,7 +136,7 @@ void DP::Ph1::RXLoad::mnaApplyRightSideVectorStamp(Matrix& rightVector) {
 		mSubCapacitor->mnaApplyRightSideVectorStamp(rightVector);
 }
 
-void DP::Ph1::RXLoad::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::RXLoad::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	if (mSubResistor)
 		mSubResistor->mnaApplySystemMatrixStamp(systemMatrix);
 	if (mSubInductor)
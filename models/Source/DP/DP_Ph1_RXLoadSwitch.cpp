@@ -87,17 +87,17 @@ void DP::Ph1::RXLoadSwitch::mnaInitialize(Real omega, Real timeStep, Attribute<M
 }
 
 void DP::Ph1::RXLoadSwitch::mnaApplyRightSideVectorStamp(Matrix& rightVector) {
-	rightVector.setZero();
+	mnaZeroRightVectorRows(rightVector);
 	for (auto stamp : mRightVectorStamps)
-		rightVector += *stamp;
+		mnaAddRightVectorRows(rightVector, *stamp);
 }
 
-void DP::Ph1::RXLoadSwitch::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::RXLoadSwitch::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mSubRXLoad->mnaApplySystemMatrixStamp(systemMatrix);
 	mSubSwitch->mnaApplySystemMatrixStamp(systemMatrix);
 }
 
-void DP::Ph1::RXLoadSwitch::mnaApplySwitchSystemMatrixStamp(Bool closed, Matrix& systemMatrix, Int freqIdx) {
+void DP::Ph1::RXLoadSwitch::mnaApplySwitchSystemMatrixStamp(Bool closed, SparseMatrixRow& systemMatrix, Int freqIdx) {
 	mSubRXLoad->mnaApplySystemMatrixStamp(systemMatrix);
 	mSubSwitch->mnaApplySwitchSystemMatrixStamp(closed, systemMatrix, freqIdx);
 }
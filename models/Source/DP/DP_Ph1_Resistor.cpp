@@ -70,7 +70,7 @@ void DP::Ph1::Resistor::mnaInitializeHarm(Real omega, Real timeStep, std::vector
 	mMnaTasks.push_back(std::make_shared<MnaPostStepHarm>(*this, leftVectors));
 }
 
-void DP::Ph1::Resistor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::Resistor::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	Complex conductance = Complex(1. / **mResistance, 0);
 
 	for (UInt freq = 0; freq < mNumFreqs; freq++) {
@@ -97,7 +97,19 @@ void DP::Ph1::Resistor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
 	}
 }
 
-void DP::Ph1::Resistor::mnaApplySystemMatrixStampHarm(Matrix& systemMatrix, Int freqIdx) {
+void DP::Ph1::Resistor::mnaApplyComplexSystemMatrixStamp(SparseMatrixCompRow& systemMatrix) {
+	Complex conductance = Complex(1. / **mResistance, 0);
+	if (terminalNotGrounded(0))
+		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0), matrixNodeIndex(0), conductance);
+	if (terminalNotGrounded(1))
+		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(1), matrixNodeIndex(1), conductance);
+	if (terminalNotGrounded(0) && terminalNotGrounded(1)) {
+		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0), matrixNodeIndex(1), -conductance);
+		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(1), matrixNodeIndex(0), -conductance);
+	}
+}
+
+void DP::Ph1::Resistor::mnaApplySystemMatrixStampHarm(SparseMatrixRow& systemMatrix, Int freqIdx) {
 	Complex conductance = Complex(1. / **mResistance, 0);
 	// Set diagonal entries
 	if (terminalNotGrounded(0))
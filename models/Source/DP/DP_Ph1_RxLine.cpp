@@ -88,11 +88,11 @@ void DP::Ph1::RxLine::mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>
 	**mRightVector = Matrix::Zero(leftVector->get().rows(), 1);
 }
 
-void DP::Ph1::RxLine::mnaApplyInitialSystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::RxLine::mnaApplyInitialSystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mInitialResistor->mnaApplySystemMatrixStamp(systemMatrix);
 }
 
-void DP::Ph1::RxLine::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::RxLine::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mSubResistor->mnaApplySystemMatrixStamp(systemMatrix);
 	mSubInductor->mnaApplySystemMatrixStamp(systemMatrix);
 	mInitialResistor->mnaApplySystemMatrixStamp(systemMatrix);
@@ -105,7 +105,7 @@ void DP::Ph1::SynchronGeneratorIdeal::mnaUpdateVoltage(const Matrix& leftVector)
 	**mIntfVoltage = mSubComponents[0]->attribute<MatrixComp>("v_intf")->get();
 }
 
-void DP::Ph1::SynchronGeneratorIdeal::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::SynchronGeneratorIdeal::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	std::dynamic_pointer_cast<MNAInterface>(mSubComponents[0])->mnaApplySystemMatrixStamp(systemMatrix);
 }
 
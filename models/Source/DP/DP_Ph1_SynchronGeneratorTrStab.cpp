@@ -275,7 +275,7 @@ void DP::Ph1::SynchronGeneratorTrStab::mnaInitialize(Real omega, Real timeStep,
 	mMnaTasks.push_back(std::make_shared<MnaPostStep>(*this, leftVector));
 }
 
-void DP::Ph1::SynchronGeneratorTrStab::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::SynchronGeneratorTrStab::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mSubVoltageSource->mnaApplySystemMatrixStamp(systemMatrix);
 	mSubInductor->mnaApplySystemMatrixStamp(systemMatrix);
 }
@@ -185,7 +185,7 @@ void DP::Ph1::Transformer::mnaInitialize(Real omega, Real timeStep, Attribute<Ma
 		mTerminals[1]->node()->name(), mTerminals[1]->node()->matrixNodeIndex());
 }
 
-void DP::Ph1::Transformer::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph1::Transformer::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	// Ideal transformer equations
 	if (terminalNotGrounded(0)) {
 		Math::setMatrixElement(systemMatrix, mVirtualNodes[0]->matrixNodeIndex(), mVirtualNodes[1]->matrixNodeIndex(), Complex(-1.0, 0));
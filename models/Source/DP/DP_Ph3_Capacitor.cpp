@@ -133,7 +133,7 @@ void DP::Ph3::Capacitor::mnaInitialize(Real omega, Real timeStep, Attribute<Matr
 	mMnaTasks.push_back(std::make_shared<MnaPostStep>(*this, leftVector));
 }
 
-void DP::Ph3::Capacitor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph3::Capacitor::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 
 	if (terminalNotGrounded(0)) {
 		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0, 0), matrixNodeIndex(0, 0), mEquivCond(0, 0));
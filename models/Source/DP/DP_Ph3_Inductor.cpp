@@ -103,7 +103,7 @@ void DP::Ph3::Inductor::mnaInitialize(Real omega, Real timeStep, Attribute<Matri
 	**mRightVector = Matrix::Zero(leftVector->get().rows(), 1);
 }
 
-void DP::Ph3::Inductor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph3::Inductor::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 
 	if (terminalNotGrounded(0)) {
 		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0, 0), matrixNodeIndex(0, 0), mEquivCond(0, 0));
@@ -68,7 +68,7 @@ void DP::Ph3::SeriesResistor::mnaInitialize(Real omega, Real timeStep, Attribute
 	mMnaTasks.push_back(std::make_shared<MnaPostStep>(*this, leftVector));
 }
 
-void DP::Ph3::SeriesResistor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph3::SeriesResistor::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	Complex conductance = { (1./ **mResistance), 0 };
 
 	//// Set diagonal entries
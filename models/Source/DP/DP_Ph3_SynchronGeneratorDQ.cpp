@@ -95,7 +95,7 @@ void DP::Ph3::SynchronGeneratorDQ::initialize(Matrix frequencies) {
 	**mIntfCurrent = mBase_I * dq0ToAbcTransform(mThetaMech, mIdq0);
 }
 
-void DP::Ph3::SynchronGeneratorDQ::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph3::SynchronGeneratorDQ::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	if (!mCompensationOn)
 		return;
 
@@ -25,7 +25,7 @@ DP::Ph3::SynchronGeneratorDQSmpl::SynchronGeneratorDQSmpl(String name,
 	mRa = Ra;
 }
 
-void DP::Ph3::SynchronGeneratorDQSmpl::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void DP::Ph3::SynchronGeneratorDQSmpl::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mRa = mRa*mBase_Z;
 
 	Real mConductance = 1 / mRa;
@@ -51,7 +51,7 @@ void EMT::Ph1::Resistor::mnaInitialize(Real omega, Real timeStep, Attribute<Matr
 	mMnaTasks.push_back(std::make_shared<MnaPostStep>(*this, leftVector));
 }
 
-void EMT::Ph1::Resistor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph1::Resistor::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	Real conductance = 1. / **mResistance;
 	// Set diagonal entries
 	if (terminalNotGrounded(0))
@@ -286,16 +286,16 @@ void EMT::Ph3::AvVoltageSourceInverterDQ::mnaInitialize(Real omega, Real timeSte
 }
 
 
-void EMT::Ph3::AvVoltageSourceInverterDQ::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::AvVoltageSourceInverterDQ::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	for (auto subcomp: mSubComponents)
 		if (auto mnasubcomp = std::dynamic_pointer_cast<MNAInterface>(subcomp))
 			mnasubcomp->mnaApplySystemMatrixStamp(systemMatrix);
 }
 
 void EMT::Ph3::AvVoltageSourceInverterDQ::mnaApplyRightSideVectorStamp(Matrix& rightVector) {
-	rightVector.setZero();
+	mnaZeroRightVectorRows(rightVector);
 	for (auto stamp : mRightVectorStamps)
-		rightVector += *stamp;
+		mnaAddRightVectorRows(rightVector, *stamp);
 }
 
 void EMT::Ph3::AvVoltageSourceInverterDQ::addControlPreStepDependencies(AttributeBase::List &prevStepDependencies, AttributeBase::List &attributeDependencies, AttributeBase::List &modifiedAttributes) {
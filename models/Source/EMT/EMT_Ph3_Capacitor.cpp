@@ -74,7 +74,7 @@ void EMT::Ph3::Capacitor::mnaInitialize(Real omega, Real timeStep, Attribute<Mat
 
 }
 
-void EMT::Ph3::Capacitor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::Capacitor::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	if (terminalNotGrounded(0)) {
 		// set upper left block, 3x3 entries
 		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0, 0), matrixNodeIndex(0, 0), mEquivCond(0, 0));
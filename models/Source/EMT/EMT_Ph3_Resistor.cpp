@@ -62,7 +62,7 @@ void EMT::Ph3::Resistor::mnaInitialize(Real omega, Real timeStep, Attribute<Matr
 	mMnaTasks.push_back(std::make_shared<MnaPostStep>(*this, leftVector));
 }
 
-void EMT::Ph3::Resistor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::Resistor::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	// Set diagonal entries
 	if (terminalNotGrounded(0)) {
 		// set upper left block, 3x3 entries
@@ -112,11 +112,11 @@ void EMT::Ph3::RxLine::mnaInitialize(Real omega, Real timeStep, Attribute<Matrix
 	**mRightVector = Matrix::Zero(leftVector->get().rows(), 1);
 }
 
-void EMT::Ph3::RxLine::mnaApplyInitialSystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::RxLine::mnaApplyInitialSystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mInitialResistor->mnaApplySystemMatrixStamp(systemMatrix);
 }
 
-void EMT::Ph3::RxLine::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::RxLine::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mSubResistor->mnaApplySystemMatrixStamp(systemMatrix);
 	mSubInductor->mnaApplySystemMatrixStamp(systemMatrix);
 	mInitialResistor->mnaApplySystemMatrixStamp(systemMatrix);
@@ -60,7 +60,7 @@ void EMT::Ph3::SeriesSwitch::mnaInitialize(Real omega, Real timeStep, Attribute<
 	mMnaTasks.push_back(std::make_shared<MnaPostStep>(*this, leftVector));
 }
 
-void EMT::Ph3::SeriesSwitch::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::SeriesSwitch::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	Real conductance = (**mIsClosed)
 		? 1. / **mClosedResistance
 		: 1. / **mOpenResistance;
@@ -86,7 +86,7 @@ void EMT::Ph3::SeriesSwitch::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
 	}
 }
 
-void EMT::Ph3::SeriesSwitch::mnaApplySwitchSystemMatrixStamp(Bool closed, Matrix& systemMatrix, Int freqIdx) {
+void EMT::Ph3::SeriesSwitch::mnaApplySwitchSystemMatrixStamp(Bool closed, SparseMatrixRow& systemMatrix, Int freqIdx) {
 	Real conductance = (closed)
 		? 1. / **mClosedResistance
 		: 1. / **mOpenResistance;
@@ -201,7 +201,7 @@ void EMT::Ph3::SynchronGeneratorDQ::initializeMatrixAndStates(){
 	**mIntfCurrent = mBase_I * dq0ToAbcTransform(mThetaMech, mIdq0);
 }
 
-void EMT::Ph3::SynchronGeneratorDQ::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::SynchronGeneratorDQ::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	if (!mCompensationOn)
 		return;
 
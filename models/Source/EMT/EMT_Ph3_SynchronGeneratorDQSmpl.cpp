@@ -28,7 +28,7 @@ EMT::Ph3::SynchronGeneratorDQSmpl::SynchronGeneratorDQSmpl(String name,
 	mRa = Ra;
 }
 
-void EMT::Ph3::SynchronGeneratorDQSmpl::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::SynchronGeneratorDQSmpl::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mRa = mRa*mBase_Z;
 
 	// Set diagonal entries
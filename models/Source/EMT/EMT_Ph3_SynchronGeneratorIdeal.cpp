@@ -123,7 +123,7 @@ void EMT::Ph3::SynchronGeneratorIdeal::mnaUpdateVoltage(const Matrix& leftVector
 	**mIntfVoltage = mSubComponents[0]->attribute<Matrix>("v_intf")->get();
 }
 
-void EMT::Ph3::SynchronGeneratorIdeal::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::SynchronGeneratorIdeal::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	std::dynamic_pointer_cast<MNAInterface>(mSubComponents[0])->mnaApplySystemMatrixStamp(systemMatrix);
 }
 
@@ -270,7 +270,7 @@ void EMT::Ph3::SynchronGeneratorTrStab::mnaInitialize(Real omega, Real timeStep,
 	mMnaTasks.push_back(std::make_shared<MnaPostStep>(*this, leftVector));
 }
 
-void EMT::Ph3::SynchronGeneratorTrStab::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::SynchronGeneratorTrStab::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mSubVoltageSource->mnaApplySystemMatrixStamp(systemMatrix);
 	mSubInductor->mnaApplySystemMatrixStamp(systemMatrix);
 }
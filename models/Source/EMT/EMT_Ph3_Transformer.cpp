@@ -189,7 +189,7 @@ void EMT::Ph3::Transformer::mnaInitialize(Real omega, Real timeStep, Attribute<M
 		mTerminals[1]->node()->name(), mTerminals[1]->node()->matrixNodeIndex());
 }
 
-void EMT::Ph3::Transformer::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void EMT::Ph3::Transformer::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	// Ideal transformer equations
 	if (terminalNotGrounded(0)) {
 		Math::setMatrixElement(systemMatrix, mVirtualNodes[0]->matrixNodeIndex(PhaseType::A), mVirtualNodes[1]->matrixNodeIndex(PhaseType::A), -1.);
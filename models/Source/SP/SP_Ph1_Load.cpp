@@ -186,7 +186,7 @@ void SP::Ph1::Load::mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::
 }
 
 
-void SP::Ph1::Load::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void SP::Ph1::Load::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	if (mSubResistor)
 		mSubResistor->mnaApplySystemMatrixStamp(systemMatrix);
 	if (mSubInductor)
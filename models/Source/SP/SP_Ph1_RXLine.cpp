@@ -225,11 +225,11 @@ void SP::Ph1::RXLine::mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>
 	**mRightVector = Matrix::Zero(leftVector->get().rows(), 1);
 }
 
-void SP::Ph1::RXLine::mnaApplyInitialSystemMatrixStamp(Matrix& systemMatrix) {
+void SP::Ph1::RXLine::mnaApplyInitialSystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mInitialResistor->mnaApplySystemMatrixStamp(systemMatrix);
 }
 
-void SP::Ph1::RXLine::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void SP::Ph1::RXLine::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mSubResistor->mnaApplySystemMatrixStamp(systemMatrix);
 	mSubInductor->mnaApplySystemMatrixStamp(systemMatrix);
 	mInitialResistor->mnaApplySystemMatrixStamp(systemMatrix);
@@ -67,7 +67,7 @@ void SP::Ph1::SynchronGenerator4OrderDCIM::calculateStateMatrix() {
 	   		(1. / Td_t) * mEf * (mLd_t / mLd);
 }
 
-void SP::Ph1::SynchronGenerator4OrderDCIM::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void SP::Ph1::SynchronGenerator4OrderDCIM::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 }
 
 void SP::Ph1::SynchronGenerator4OrderDCIM::stepInPerUnit() {
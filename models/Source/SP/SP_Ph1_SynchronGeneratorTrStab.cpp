@@ -284,7 +284,7 @@ void SP::Ph1::SynchronGeneratorTrStab::mnaInitialize(Real omega, Real timeStep,
 	mMnaTasks.push_back(std::make_shared<MnaPostStep>(*this, leftVector));
 }
 
-void SP::Ph1::SynchronGeneratorTrStab::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void SP::Ph1::SynchronGeneratorTrStab::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	mSubVoltageSource->mnaApplySystemMatrixStamp(systemMatrix);
 	mSubInductor->mnaApplySystemMatrixStamp(systemMatrix);
 }
@@ -336,7 +336,7 @@ void SP::Ph1::Transformer::mnaInitialize(Real omega, Real timeStep, Attribute<Ma
 }
 
 
-void SP::Ph1::Transformer::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void SP::Ph1::Transformer::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	// Ideal transformer equations
 	if (terminalNotGrounded(0)) {
 		Math::setMatrixElement(systemMatrix, mVirtualNodes[0]->matrixNodeIndex(), mVirtualNodes[1]->matrixNodeIndex(), Complex(-1.0, 0));
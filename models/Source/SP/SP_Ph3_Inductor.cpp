@@ -71,7 +71,7 @@ void SP::Ph3::Inductor::mnaInitialize(Real omega, Real timeStep, Attribute<Matri
 	**mRightVector = Matrix::Zero(leftVector->get().rows(), 1);
 }
 
-void SP::Ph3::Inductor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void SP::Ph3::Inductor::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	if (terminalNotGrounded(0)) {
 		// set upper left block, 3x3 entries
 		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0, 0), matrixNodeIndex(0, 0), mSusceptance(0, 0));
@@ -55,7 +55,7 @@ void SP::Ph3::Resistor::mnaInitialize(Real omega, Real timeStep, Attribute<Matri
 	mMnaTasks.push_back(std::make_shared<MnaPostStep>(*this, leftVector));
 }
 
-void SP::Ph3::Resistor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
+void SP::Ph3::Resistor::mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) {
 	if (terminalNotGrounded(0)) {
 		// set upper left block, 3x3 entries
 		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0, 0), matrixNodeIndex(0, 0), Complex( mConductance(0, 0), 0));
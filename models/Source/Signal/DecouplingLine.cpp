@@ -90,6 +90,7 @@ void DecouplingLine::initialize(Real omega, Real timeStep) {
 	if (mNode1 == nullptr || mNode2 == nullptr)
 		throw SystemError("nodes not initialized!");
 
+	mOmega = omega;
 	mBufSize = static_cast<UInt>(ceil(mDelay / timeStep));
 	mAlpha = 1 - (mBufSize - mDelay / timeStep);
 	mSLog->info("bufsize {} alpha {}", mBufSize, mAlpha);
@@ -134,8 +135,8 @@ void DecouplingLine::step(Real time, Int timeStepCount) {
 			- mResistance/4 / denom * (volt1 + (mSurgeImpedance - mResistance/4) * cur1);
 		**mSrcCur2Ref = -mSurgeImpedance / denom * (volt1 + (mSurgeImpedance - mResistance/4) * cur1)
 			- mResistance/4 / denom * (volt2 + (mSurgeImpedance - mResistance/4) * cur2);
-		**mSrcCur1Ref = **mSrcCur1Ref * Complex(cos(-2.*PI*50*mDelay),sin(-2.*PI*50*mDelay));
-		**mSrcCur2Ref = **mSrcCur2Ref * Complex(cos(-2.*PI*50*mDelay),sin(-2.*PI*50*mDelay));
+		**mSrcCur1Ref = **mSrcCur1Ref * Complex(cos(-mOmega*mDelay),sin(-mOmega*mDelay));
+		**mSrcCur2Ref = **mSrcCur2Ref * Complex(cos(-mOmega*mDelay),sin(-mOmega*mDelay));
 	}
 	mSrcCur1->set(**mSrcCur1Ref);
 	mSrcCur2->set(**mSrcCur2Ref);
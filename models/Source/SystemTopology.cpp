@@ -12,6 +12,8 @@
 #include <unordered_map>
 
 #include <cps/SystemTopology.h>
+#include <cps/DP/DP_Ph1_PiLine.h>
+#include <cps/Signal/DecouplingLine.h>
 
 using namespace CPS;
 
@@ -129,6 +131,45 @@ void SystemTopology::splitSubnets(std::vector<SystemTopology>& splitSystems) {
 	}
 }
 
+IdentifiedObject::List SystemTopology::decoupleLines(Real timeStep, Logger::Level logLevel) {
+	IdentifiedObject::List decouplingLines;
+	IdentifiedObject::List components;
+
+	for (auto comp : mComponents) {
+		auto line = std::dynamic_pointer_cast<DP::Ph1::PiLine>(comp);
+		// The decoupling line delays the waves by sqrt(L*C), which has to cover at least one step
+		if (!line || line->terminalNumberConnected() < 2
+			|| line->node(0)->isGround() || line->node(1)->isGround()
+			|| sqrt(**line->mSeriesInd * **line->mParallelCap) < timeStep) {
+			components.push_back(comp);
+			continue;
+		}
+
+		auto dline = Signal::DecouplingLine::make(line->name() + "_dec", line->node(0), line->node(1),
+			**line->mSeriesRes, **line->mSeriesInd, **line->mParallelCap, logLevel);
+		decouplingLines.push_back(dline);
+
+		auto powerComp = std::dynamic_pointer_cast<TopologicalPowerComp>(line);
+		for (auto topoNode : line->topologicalNodes()) {
+			auto& nodeComps = mComponentsAtNode[topoNode];
+			nodeComps.erase(std::remove(nodeComps.begin(), nodeComps.end(), powerComp), nodeComps.end());
+		}
+	}
+	mComponents = components;
+
+	// Each end of a decoupling line only connects its node to ground
+	for (auto dline : decouplingLines) {
+		addComponent(dline);
+		for (auto comp : std::dynamic_pointer_cast<Signal::DecouplingLine>(dline)->getLineComponents()) {
+			addComponent(comp);
+			auto powerComp = std::dynamic_pointer_cast<TopologicalPowerComp>(comp);
+			for (auto topoNode : powerComp->topologicalNodes())
+				mComponentsAtNode[topoNode].push_back(powerComp);
+		}
+	}
+	return decouplingLines;
+}
+
 template <typename VarType>
 int SystemTopology::checkTopologySubnets(std::unordered_map<typename SimNode<VarType>::Ptr, int>& subnet) {
 	std::unordered_map<typename SimNode<VarType>::Ptr, typename SimNode<VarType>::List> neighbours;
@@ -177,7 +218,9 @@ int SystemTopology::checkTopologySubnets(std::unordered_map<typename SimNode<Var
 			auto node = nextSet.front();
 			nextSet.pop_front();
 
-			subnet[node] = currentNet;
+			// Nodes can be queued by several neighbours, but are only expanded once
+			if (!subnet.emplace(node, currentNet).second)
+				continue;
 			for (auto neighbour : neighbours[node]) {
 				if (subnet.find(neighbour) == subnet.end())
 					nextSet.push_back(neighbour);